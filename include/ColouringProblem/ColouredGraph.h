@@ -21,10 +21,21 @@
 
 typedef struct ColouredGraph_s *ColouredGraph;
 
+/**
+ * @brief The neighbours of each node of a ColouredGraph in compressed (CSR) form, two nodes being neighbours if there is an edge in either direction.
+ *        Built once by cg_initialize and obtained with cg_get_adjacency, it is shared by the colouring engines and belongs to the graph.
+ */
+typedef struct
+{
+    int num_nodes;   ///< The number of nodes.
+    int *offsets;    ///< The neighbours of node are neighbours[offsets[node]] to neighbours[offsets[node + 1] - 1], in increasing order.
+    int *neighbours; ///< The neighbours of all the nodes (without the node itself).
+} cg_adjacency;
+
 /**
  * @brief Initializes a ColouredGraph from a Graph for use in the functions.
  * Does not color the graph (for use in colouring problem).
- * The graph is NOT copied (as it is not supposed to be modified).
+ * The graph is NOT copied (as it is not supposed to be modified). The neighbours of its nodes (cg_get_adjacency) are computed here, once.
  *
  * @param graph The Graph that is the input of the problem.
  * @return ColouredGraph The structure ColouredGraph described above.
@@ -45,6 +56,14 @@ void cg_print(ColouredGraph graph);
  */
 void cg_print_colors(ColouredGraph graph);
 
+/**
+ * @brief Same as cg_print_colors, in @p file.
+ *
+ * @param file A file.
+ * @param graph A ColouredGraph.
+ */
+void cg_fprint_colors(FILE *file, ColouredGraph graph);
+
 /**
  * @brief Deallocates memory used by a @p graph (what is allocated by rg_initialize). Warning: does NOT deallocate the Graph inside the @p graph. The Graph must be deallocated with adequate function from Graph.h.
  *
@@ -52,6 +71,14 @@ void cg_print_colors(ColouredGraph graph);
  */
 void cg_delete(ColouredGraph graph);
 
+/**
+ * @brief Returns the Graph of @p graph.
+ *
+ * @param graph A ColouredGraph.
+ * @return Graph The Graph it was initialised with.
+ */
+Graph cg_get_graph(ColouredGraph graph);
+
 /**
  * @brief Returns the number of nodes of @p graph.
  *
@@ -79,6 +106,14 @@ int cg_get_num_edges(ColouredGraph graph);
  */
 bool cg_is_edge(ColouredGraph graph, int source, int target);
 
+/**
+ * @brief Returns the neighbours of each node of @p graph (see cg_adjacency). The degree of node is offsets[node + 1] - offsets[node].
+ *
+ * @param graph A ColouredGraph.
+ * @return const cg_adjacency* Its adjacency, valid until @p graph is deleted.
+ */
+const cg_adjacency *cg_get_adjacency(ColouredGraph graph);
+
 /**
  * @brief Gets the name of @p node in @p graph. The name is what appears in the .dot file, while its number is local to this program.
  *
@@ -0,0 +1,38 @@
+/**
+ * @file ColouringChromatic.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Computes the chromatic number of a graph (the fewest colours of a colouring) in a single solver session. A greedy colouring gives an upper
+ *         bound K and a large clique a lower bound. The reduction is built once for K - 1 colours (colouring_reduction_up_to), and each number of colours
+ *         k tried only changes the assumptions switching off colours k to K - 2, so the solver keeps what it learnt from one k to the next. With
+ *         another encoding than the direct one, the reduction of each k (colouring_reduction_encoded) is asserted in a scope of the session instead.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_COLOURING_CHROMATIC_H
+#define COCA_COLOURING_CHROMATIC_H
+
+#include "ColouredGraph.h"
+#include "ColouringReduction.h"
+#include <z3.h>
+
+/**
+ * @brief Searches the chromatic number of @p graph. From the upper bound, k walks down (each colouring found lowering the bound to the colours it
+ *        actually uses) until k colours are refuted, or with @p binary_search, k is the middle of the interval between the bounds.
+ *        @p graph is coloured with the best colouring found, a witness of the value returned.
+ *
+ * @param ctx The solver context.
+ * @param graph A ColouredGraph.
+ * @param symmetry The symmetry breaking of the reduction.
+ * @param encoding The encoding of the colours in the reduction.
+ * @param binary_search Whether to search k by dichotomy instead of walking it down.
+ * @param num_calls If not NULL, will contain the number of solver calls made.
+ * @return int The chromatic number of @p graph, -1 if the solver could not decide for some k (@p graph then has the best colouring found).
+ * @pre @p graph must be initialized.
+ */
+int colouring_chromatic_number(Z3_context ctx, ColouredGraph graph, colouring_symmetry symmetry, colouring_encoding encoding, bool binary_search, int *num_calls);
+
+#endif
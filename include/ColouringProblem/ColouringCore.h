@@ -0,0 +1,78 @@
+/**
+ * @file ColouringCore.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Preprocessing of the colouring problem: a node with less than k neighbours can always be coloured last, with a colour none of them has.
+ *         Removing such nodes repeatedly leaves the k-core of the graph, which is the only part a solver needs to colour. The colouring of the core
+ *         is then extended greedily to the removed nodes, in reverse order of removal.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_COLOURING_CORE_H
+#define COCA_COLOURING_CORE_H
+
+#include "ColouredGraph.h"
+
+/**
+ * @brief The k-core of a ColouredGraph, and the order in which the other nodes were removed.
+ *
+ */
+typedef struct ColouringCore_s *ColouringCore;
+
+/**
+ * @brief Peels @p graph to its @p num_colours-core: repeatedly removes a node with less than @p num_colours neighbours among the nodes left.
+ *        Must be freed with colouring_core_delete.
+ *
+ * @param graph A ColouredGraph (must outlive the core).
+ * @param num_colours The number of colours available.
+ * @return ColouringCore The core.
+ */
+ColouringCore colouring_core_create(ColouredGraph graph, int num_colours);
+
+/**
+ * @brief Returns the core as a ColouredGraph of its own, to be coloured by any algorithm (its node i is the node colouring_core_get_node(@p core, i)
+ *        of the original graph). It belongs to @p core.
+ *
+ * @param core A core.
+ * @return ColouredGraph The core.
+ */
+ColouredGraph colouring_core_get_graph(ColouringCore core);
+
+/**
+ * @brief Returns the node of the original graph which is node @p node of the core.
+ *
+ * @param core A core.
+ * @param node A node of the core.
+ * @return int The node of the original graph.
+ */
+int colouring_core_get_node(ColouringCore core, int node);
+
+/**
+ * @brief Returns the number of nodes removed from the original graph.
+ *
+ * @param core A core.
+ * @return int The number of nodes removed.
+ */
+int colouring_core_num_peeled(ColouringCore core);
+
+/**
+ * @brief Copies the colours of the core to the original graph (through cg_set_node_colour), then gives each removed node, in reverse order of removal,
+ *        the smallest colour none of its neighbours has.
+ *
+ * @param core A core.
+ * @pre Every node of colouring_core_get_graph(@p core) is coloured, with colours smaller than the number of colours of the core.
+ * @post Every node of the original graph is coloured, with colours smaller than the number of colours of the core, and neighbours have different colours.
+ */
+void colouring_core_extend(ColouringCore core);
+
+/**
+ * @brief Frees @p core and its graph. Does NOT free the original graph.
+ *
+ * @param core A core.
+ */
+void colouring_core_delete(ColouringCore core);
+
+#endif
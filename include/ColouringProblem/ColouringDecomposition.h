@@ -0,0 +1,62 @@
+/**
+ * @file ColouringDecomposition.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Decomposition of the colouring problem: a graph is k-colourable if and only if each of its connected components is, so the components are
+ *         solved independently, in parallel on a ThreadPool, by any colouring engine, and their colourings are merged. The same holds for its
+ *         biconnected blocks (the pieces left connected when any single node is removed), which only share cut nodes: the colours of a block can be
+ *         exchanged so that it agrees with the blocks already coloured on its cut node.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_COLOURING_DECOMPOSITION_H
+#define COCA_COLOURING_DECOMPOSITION_H
+
+#include "ColouredGraph.h"
+
+/**
+ * @brief An engine solving the colouring problem on a piece of the graph. It must colour @p graph if it returns 1, and may be called from several
+ *        threads at once, on different pieces.
+ *
+ * @param graph The piece.
+ * @param num_colours The number of colours available.
+ * @param data The data given to the decomposition.
+ * @return int 1 if there is a colouring (@p graph is then coloured), 0 if there is none, -1 if the engine could not decide.
+ */
+typedef int (*colouring_engine)(ColouredGraph graph, int num_colours, void *data);
+
+/**
+ * @brief Solves the colouring problem on each connected component of @p graph with @p engine, on @p num_workers threads, and merges the colourings.
+ *        Components of one or two nodes are coloured without calling the engine, and a graph with a single component is given to the engine as it
+ *        is. The components not started yet are skipped as soon as one of them has no colouring.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param engine The engine.
+ * @param data Given to each call of @p engine.
+ * @param num_workers The number of threads (0 for the number of processors).
+ * @param num_components If not NULL, will contain the number of components.
+ * @return int 1 if there is a colouring (@p graph is then coloured), 0 if there is none, -1 if the engine could not decide for some component.
+ */
+int colouring_by_components(ColouredGraph graph, int num_colours, colouring_engine engine, void *data, int num_workers, int *num_components);
+
+/**
+ * @brief Solves the colouring problem on each biconnected block of @p graph (the direction of edges being ignored) with @p engine, on @p num_workers
+ *        threads, and stitches the colourings along the block-cut tree, exchanging colours inside each block to agree on its cut node. Blocks of
+ *        one or two nodes are coloured without calling the engine, and a graph made of a single block is given to the engine as it is. The blocks
+ *        not started yet are skipped as soon as one of them has no colouring.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param engine The engine.
+ * @param data Given to each call of @p engine.
+ * @param num_workers The number of threads (0 for the number of processors).
+ * @param num_blocks If not NULL, will contain the number of blocks.
+ * @return int 1 if there is a colouring (@p graph is then coloured), 0 if there is none, -1 if the engine could not decide for some block.
+ */
+int colouring_by_blocks(ColouredGraph graph, int num_colours, colouring_engine engine, void *data, int num_workers, int *num_blocks);
+
+#endif
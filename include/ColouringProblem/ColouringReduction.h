@@ -18,7 +18,80 @@
 #include <z3.h>
 
 /**
- * @brief Generates a propositional formula satisfiable if and only if there is a partition which satisfies every player and all components are connected.
+ * @brief The symmetry breaking added to the reduction. Colours are interchangeable, so without it the solver may have to refute every permutation of a
+ *        failed colouring.
+ *
+ */
+typedef enum
+{
+    colouring_symmetry_none,      ///< No symmetry breaking.
+    colouring_symmetry_clique,    ///< The nodes of a large clique (colouring_greedy_clique) get colours 0, 1, 2... (the default).
+    colouring_symmetry_precedence ///< Same as colouring_symmetry_clique, and besides colour c+1 is used only if colour c is used.
+} colouring_symmetry;
+
+/**
+ * @brief How the colour of each node is written with variables. The direct encoding has a variable per node and colour, and forbids two colours for
+ *        the same node pairwise, so each node costs O(k²) clauses; the others cost O(k) or O(log k) per node and edge, which matters for large k.
+ *
+ */
+typedef enum
+{
+    colouring_encoding_direct,   ///< One variable "node n, color c" per colour (one-hot), at least one of them true and at most one (the default).
+    colouring_encoding_order,    ///< One variable "node n, color > c" per colour but the last, each implying the previous one.
+    colouring_encoding_log,      ///< The colour written in binary with variables "node n, bit b", the codes from k on being forbidden.
+    colouring_encoding_bitvector ///< A bit-vector "node n, color" lower than k (Z3_mk_bvult), the two ends of each edge being distinct.
+} colouring_encoding;
+
+/**
+ * @brief Reads an encoding of the colours from @p name: "direct", "order", "log" or "bitvector".
+ *
+ * @param name The name.
+ * @param encoding Will contain the encoding.
+ * @return true if @p name is valid.
+ * @return false otherwise.
+ */
+bool colouring_encoding_of_string(const char *name, colouring_encoding *encoding);
+
+/**
+ * @brief Reads a symmetry breaking from @p name: "none", "clique" or "precedence".
+ *
+ * @param name The name.
+ * @param symmetry Will contain the symmetry breaking.
+ * @return true if @p name is valid.
+ * @return false otherwise.
+ */
+bool colouring_symmetry_of_string(const char *name, colouring_symmetry *symmetry);
+
+/**
+ * @brief Same as colouring_reduction, with the symmetry breaking @p symmetry instead of colouring_symmetry_clique. The formula stays satisfiable if and
+ *        only if @p graph has a colouring with @p num_colours colours.
+ *
+ * @param ctx The solver context.
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available for colouring the graph.
+ * @param symmetry The symmetry breaking.
+ * @return Z3_ast The formula.
+ * @pre @p graph must be initialized.
+ */
+Z3_ast colouring_reduction_with_symmetry(Z3_context ctx, const ColouredGraph graph, int num_colours, colouring_symmetry symmetry);
+
+/**
+ * @brief Same as colouring_reduction_with_symmetry, with the colours written in the encoding @p encoding instead of colouring_encoding_direct. A model
+ *        of the formula is decoded by colour_graph_from_model with the same encoding.
+ *
+ * @param ctx The solver context.
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available for colouring the graph.
+ * @param symmetry The symmetry breaking.
+ * @param encoding The encoding of the colours.
+ * @return Z3_ast The formula.
+ * @pre @p graph must be initialized.
+ */
+Z3_ast colouring_reduction_encoded(Z3_context ctx, const ColouredGraph graph, int num_colours, colouring_symmetry symmetry, colouring_encoding encoding);
+
+/**
+ * @brief Generates a propositional formula satisfiable if and only if there is a colouring of @p graph with @p num_colours colours such that neighbouring nodes
+ *        have different colours. The nodes of a large clique get fixed colours to break the symmetry between colours (colouring_symmetry_clique).
  *
  * @param ctx The solver context.
  * @param graph A ColouredGraph.
@@ -28,6 +101,33 @@
  */
 Z3_ast colouring_reduction(Z3_context ctx, const ColouredGraph graph, int num_colours);
 
+/**
+ * @brief Same as colouring_reduction_with_symmetry with @p max_colours colours, where besides each colour c has a variable "color c used" implied by
+ *        every node of colour c. Assuming these variables false for the colours from k on (colouring_reduction_limit) restricts the formula to the
+ *        colourings with k colours, so that a single solver session answers for every k up to @p max_colours.
+ *
+ * @param ctx The solver context.
+ * @param graph A ColouredGraph.
+ * @param max_colours The largest number of colours.
+ * @param symmetry The symmetry breaking.
+ * @return Z3_ast The formula.
+ * @pre @p graph must be initialized.
+ */
+Z3_ast colouring_reduction_up_to(Z3_context ctx, const ColouredGraph graph, int max_colours, colouring_symmetry symmetry);
+
+/**
+ * @brief Fills @p assumptions with the formulae "colour c is not used" for @p num_colours <= c < @p max_colours. Under them, the formula
+ *        colouring_reduction_up_to(@p max_colours) is satisfiable if and only if the graph has a colouring with @p num_colours colours.
+ *
+ * @param ctx The solver context.
+ * @param num_colours The number of colours allowed.
+ * @param max_colours The number of colours of the formula.
+ * @param assumptions Array to return the assumptions.
+ * @return int The number of assumptions (@p max_colours - @p num_colours).
+ * @pre @p assumptions must be an array of size at least @p max_colours - @p num_colours.
+ */
+int colouring_reduction_limit(Z3_context ctx, int num_colours, int max_colours, Z3_ast *assumptions);
+
 /**
  * @brief Colours @p graph according to @p model.
  *
@@ -35,10 +135,11 @@ Z3_ast colouring_reduction(Z3_context ctx, const ColouredGraph graph, int num_co
  * @param model A variable assignment.
  * @param graph A ColouredGraph.
  * @param num_colours The number of expected colours.
- * @pre @p model must be a valid model which has a truth value for each variable representing a pair colour, node.
+ * @param encoding The encoding of the formula @p model satisfies (colouring_encoding_direct for colouring_reduction and colouring_reduction_up_to).
+ * @pre @p model must be a valid model which has a value for each variable representing the colour of a node.
  * @pre @p graph must be the ColouredGraph used to obtain @p model.
  */
-void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours);
+void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours, colouring_encoding encoding);
 
 /**
  * @brief Prints the values of the variables in @p model. @p graph and @p num_colours are used to determine which values to print. @p model should have been obtained through the satisfaction of a formula obtained with colouring_reduction.
@@ -47,9 +148,10 @@ void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph
  * @param model A model.
  * @param graph A ColouredGraph.
  * @param num_colours The number of expected colours.
- * @pre @p model must be a valid model which has a truth value for each variable representing a pair colour, node.
+ * @param encoding The encoding of the formula @p model satisfies: the truth value of "node n has colour c" is printed for each node and colour.
+ * @pre @p model must be a valid model which has a value for each variable representing the colour of a node.
  * @pre @p graph must be the ColouredGraph used to obtain @p model
  */
-void colouring_print_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours);
+void colouring_print_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours, colouring_encoding encoding);
 
 #endif
\ No newline at end of file
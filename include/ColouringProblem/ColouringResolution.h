@@ -13,6 +13,7 @@
 #define COCA_COLOURING_RESOLUTION_H
 
 #include "ColouredGraph.h"
+#include <stdatomic.h>
 
 /**
  * @brief Brute Force Algorithm to solve the colouring problem. If it is solvable, @p graph is modified so at the return of the algorithm, the nodes are coloured. If there is no solution, @p graph has all colours set to -1.
@@ -27,4 +28,71 @@
  */
 bool colouring_brute_force(ColouredGraph graph, int num_colours);
 
+/**
+ * @brief Exact DSATUR branch and bound for the colouring problem. Colours first the node with the most distinct colours among its neighbours (its
+ *        saturation degree, ties broken by degree), tries for it only the colours left in its domain (a bitset per node) and at most one colour not used
+ *        yet, and backtracks as soon as an uncoloured node has an empty domain. With several workers, the first levels of the search tree are split into
+ *        subtrees solved by a ThreadPool, each worker taking the next subtree as soon as it is done with one, and all of them stop at the first colouring found.
+ *        If it is solvable, @p graph is modified so at the return of the algorithm, the nodes are coloured. If there is no solution, @p graph has all colours set to -1.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param num_workers The number of threads (0 for the number of processors, 1 for a sequential search).
+ * @return true if there is a solution.
+ * @return false if there is no solution.
+ *
+ * @pre @p graph must be valid.
+ * @post @p if returns true, the colours of @p graph is a solution to the Colouring problem with @p num_colours colors.
+ */
+bool colouring_dsatur(ColouredGraph graph, int num_colours, int num_workers);
+
+/**
+ * @brief Same as colouring_dsatur, but the search also stops as soon as @p stop is set by another thread (the workers set it too when one of them
+ *        finds a colouring). Used to run DSATUR alongside another engine.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param num_workers The number of threads (0 for the number of processors, 1 for a sequential search).
+ * @param stop The flag stopping the search (must be false when the search starts).
+ * @return true if there is a solution.
+ * @return false if there is no solution, or if the search was stopped by another thread.
+ */
+bool colouring_dsatur_until(ColouredGraph graph, int num_colours, int num_workers, atomic_bool *stop);
+
+/**
+ * @brief Searches a large clique of @p graph greedily: from each node, in decreasing order of degree, repeatedly adds the candidate of largest degree
+ *        adjacent to all the nodes already chosen, and keeps the largest clique found. Not necessarily a maximum clique.
+ *
+ * @param graph A ColouredGraph.
+ * @param clique Array to return the nodes of the clique, in the order they were chosen.
+ * @return int The size of the clique.
+ * @pre @p clique must be an array of size at least the number of nodes of @p graph.
+ */
+int colouring_greedy_clique(ColouredGraph graph, int *clique);
+
+/**
+ * @brief Searches a large clique of @p graph: colouring_greedy_clique first, then, within @p seconds seconds, an exact branch and bound over sets of
+ *        nodes stored as bitsets, bounded by a greedy colouring of the candidates. It stops as soon as a clique of @p target nodes is found. A clique
+ *        of more than k nodes proves that the graph has no colouring with k colours.
+ *
+ * @param graph A ColouredGraph.
+ * @param clique Array to return the nodes of the clique.
+ * @param target The size of clique which is enough.
+ * @param seconds The time budget of the branch and bound (0 for the greedy search only).
+ * @param maximum If not NULL, will tell whether the clique is proven maximum (the branch and bound ended without reaching @p target).
+ * @return int The size of the clique.
+ * @pre @p clique must be an array of size at least the number of nodes of @p graph.
+ */
+int colouring_max_clique(ColouredGraph graph, int *clique, int target, double seconds, bool *maximum);
+
+/**
+ * @brief Colours @p graph greedily, without backtracking: repeatedly gives the uncoloured node with the most distinct colours among its neighbours
+ *        (ties broken by degree) the smallest colour none of them has. Not necessarily a colouring with the fewest colours.
+ *
+ * @param graph A ColouredGraph.
+ * @return int The number of colours used.
+ * @post The colours of @p graph are a colouring with the number of colours returned.
+ */
+int colouring_greedy(ColouredGraph graph);
+
 #endif
\ No newline at end of file
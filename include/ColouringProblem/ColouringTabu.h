@@ -0,0 +1,50 @@
+/**
+ * @file ColouringTabu.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  TabuCol, a local search for the colouring problem: starting from a random colouring, it repeatedly recolours a node in conflict (with a
+ *         neighbour of the same colour) with the colour which removes the most conflicts, and forbids giving the node back its previous colour for a few
+ *         iterations (tabu list). The number of neighbours of each colour of each node is kept up to date, so that a move costs the degree of the node.
+ *         It is incomplete: it can only find colourings, never prove there is none, but on large colourable graphs it usually finds one long before the
+ *         exact algorithms. It can also race against DSATUR, the first definitive answer winning.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_COLOURING_TABU_H
+#define COCA_COLOURING_TABU_H
+
+#include "ColouredGraph.h"
+
+/**
+ * @brief Searches a colouring of @p graph with @p num_colours colours with TabuCol, for at most @p seconds seconds. If one is found, @p graph is
+ *        modified so at the return of the algorithm, the nodes are coloured. Otherwise, @p graph has all colours set to -1.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param seconds The time budget.
+ * @param seed The seed of the random choices (the same seed gives the same search).
+ * @return true if a colouring was found.
+ * @return false if none was found in time (there may be one).
+ */
+bool colouring_tabu(ColouredGraph graph, int num_colours, double seconds, unsigned long long seed);
+
+/**
+ * @brief Runs TabuCol (in its own thread, for at most @p seconds seconds) and DSATUR (on @p num_workers threads) at the same time: the first colouring
+ *        found by either one, or DSATUR proving there is none, stops both. If there is a colouring, @p graph is modified so at the return of the
+ *        algorithm, the nodes are coloured. Otherwise, @p graph has all colours set to -1.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param num_workers The number of threads of DSATUR (0 for the number of processors, 1 for a sequential search).
+ * @param seconds The time budget of TabuCol (DSATUR runs until it is done).
+ * @param seed The seed of TabuCol.
+ * @param by_tabu If not NULL, will tell whether TabuCol gave the answer.
+ * @return true if there is a solution.
+ * @return false if there is no solution.
+ */
+bool colouring_race(ColouredGraph graph, int num_colours, int num_workers, double seconds, unsigned long long seed, bool *by_tabu);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file TunnelCache.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief On-disk cache of the answers to path queries. The answers of a query are stored in their own file of the cache directory, named after a hash
+ *        of its key but the bound: the fingerprint of the network (tn_fingerprint), the source, the target and the engine. The file contains the key
+ *        (checked when it is read), the number of sizes from 1 without path, and the shortest path if one was found, which is checked again with
+ *        tn_check_path before being returned. It answers every bound: a path of size l answers all of them, and "no path up to l" answers the bounds up
+ *        to l and lets a larger one skip the sizes up to l. Files are written in a temporary file then renamed, so that a crash never leaves a partial
+ *        entry. The size of the entries is counted when the cache is opened, then updated by each store; when it exceeds the size limit, the directory
+ *        is read again and the least recently used entries are removed.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons
+ *
+ */
+
+#ifndef TUNNEL_CACHE_H
+#define TUNNEL_CACHE_H
+
+#include "TunnelNetwork.h"
+
+/**
+ * @brief Default size limit of a cache directory, in bytes.
+ *
+ */
+#define TN_CACHE_DEFAULT_SIZE (64L * 1024 * 1024)
+
+/**
+ * @brief A cache directory.
+ *
+ */
+typedef struct TunnelCache_s *TunnelCache;
+
+/**
+ * @brief What identifies an answer.
+ *
+ */
+typedef struct
+{
+    unsigned long long fingerprint; ///< tn_fingerprint of the network.
+    int source;                     ///< The first node of the path.
+    int target;                     ///< The last node of the path.
+    int bound;                      ///< The max size of the path (not part of the name of the entry).
+    const char *engine;             ///< The engine which computed the answer ("sat", "bf"...).
+} tn_cache_key;
+
+/**
+ * @brief Opens the cache in @p directory, creating the directory if needed, and counts the size of its entries (removing the least recently used ones if
+ *        it is over @p max_bytes). Must be freed with tn_cache_close.
+ *
+ * @param directory The directory.
+ * @param max_bytes The size limit of the entries of the directory.
+ * @return TunnelCache The cache, or NULL if the directory cannot be created.
+ */
+TunnelCache tn_cache_open(const char *directory, long max_bytes);
+
+/**
+ * @brief Frees @p cache (the directory is kept).
+ *
+ * @param cache
+ */
+void tn_cache_close(TunnelCache cache);
+
+/**
+ * @brief Looks for the answer of @p key, from the answers stored for any bound. An entry whose path is not a solution of @p network (or which cannot
+ *        be read) is removed. Can be called from several threads.
+ *
+ * @param cache
+ * @param network The network of the query.
+ * @param key The key of the query.
+ * @param length Will contain the size of the shortest path, or 0 if there is none of size at most the bound.
+ * @param path Will contain the path if there is one.
+ * @param num_unsat If not NULL, will contain the number of sizes from 1 (at most the bound) known to have no path, so that a search can skip them when
+ *        the answer is not known.
+ * @return true if the answer was in the cache.
+ * @return false otherwise.
+ * @pre @p path must be an array of size at least @p key->bound.
+ */
+bool tn_cache_lookup(TunnelCache cache, TunnelNetwork network, const tn_cache_key *key, int *length, tn_step *path, int *num_unsat);
+
+/**
+ * @brief Stores the answer of @p key (unless the entry already knows more: no path up to @p key->bound is not stored over a path or over no path up to
+ *        a larger bound), then removes the least recently used entries if the cache is over its size limit.
+ *        Can be called from several threads.
+ *
+ * @param cache
+ * @param network The network of the query.
+ * @param key The key of the query.
+ * @param length The size of the shortest path, or 0 if there is none of size at most the bound (answers the solver could not decide must not be stored).
+ * @param path The path if there is one.
+ */
+void tn_cache_store(TunnelCache cache, TunnelNetwork network, const tn_cache_key *key, int length, tn_step *path);
+
+#endif
@@ -44,6 +44,42 @@ typedef enum
  */
 #define NumActions 10
 
+/**
+ * @brief Masks (bit number a for action a, as in tn_get_node_actions) of the transmit, push and pop actions.
+ *
+ */
+#define TransmitActions ((1 << transmit_4) | (1 << transmit_6))
+#define PushActions ((1 << push_4_4) | (1 << push_4_6) | (1 << push_6_4) | (1 << push_6_6))
+#define PopActions ((1 << pop_4_4) | (1 << pop_4_6) | (1 << pop_6_4) | (1 << pop_6_6))
+
+/**
+ * @brief Number of actions of a node which can be performed with a given protocol on top of the stack (each action requires one top).
+ *
+ */
+#define ActionsPerTop 5
+
+/**
+ * @brief A read-only view of a network compiled into contiguous arrays, for the loops of the encoders and of the searches: the actions of each node
+ *        by category and by protocol on top of the stack, and the successors of each node in compressed (CSR) form.
+ *        Obtained with tn_compile, it belongs to the network and is valid until the network is modified or deleted.
+ *
+ */
+typedef struct
+{
+    int num_nodes;           ///< The number of nodes.
+    int num_edges;           ///< The number of edges.
+    unsigned version;        ///< The version of the network (tn_get_version) the view was compiled from.
+    const bool *edges;       ///< edges[source * num_nodes + target] is true if the edge exists.
+    int *actions;            ///< actions[node] is the mask of the actions of node.
+    int *transmit;           ///< transmit[node] is actions[node] & TransmitActions.
+    int *push;               ///< push[node] is actions[node] & PushActions.
+    int *pop;                ///< pop[node] is actions[node] & PopActions.
+    int *num_by_top[2];      ///< num_by_top[0][node] (resp. [1]) is the number of actions of node requiring 4 (resp. 6) on top.
+    stack_action *by_top[2]; ///< by_top[t][node * ActionsPerTop + k], k < num_by_top[t][node], are these actions, in increasing order.
+    int *succ_offsets;       ///< The successors of node are succ[succ_offsets[node]] to succ[succ_offsets[node + 1] - 1], in increasing order.
+    int *succ;               ///< The successors of all the nodes (num_edges entries).
+} tn_compiled;
+
 /**
  * @brief Structure to store a step of an execution path over a tunnel network.
  *
@@ -57,7 +93,8 @@ typedef struct tn_step
 
 /**
  * @brief Initializes a Tunnel Network from a Graph for use in the project. Parses node parameters to determine which are initial, final, and their actions.
- * The graph is NOT copied (it is not supposed to be modified).
+ * The graph is NOT copied (it is not supposed to be modified), except its edges: the edges and the actions of the network can be changed afterwards
+ * (tn_add_edge, tn_remove_edge, tn_set_node_actions) without changing the graph.
  * TODO: format of parsed parameters
  *
  * @param graph The Graph that is the input of the problem.
@@ -72,6 +109,26 @@ TunnelNetwork tn_initialize(Graph graph);
  */
 void tn_delete(TunnelNetwork network);
 
+/**
+ * @brief Builds the subgraph of the graph of @p network keeping only the connected components (the direction of edges being ignored) of the initial
+ *        and the final nodes: a path cannot leave them, so the other nodes need not be encoded. The initial and final nodes keep their shapes, so
+ *        tn_initialize of the subgraph gives the same problem on fewer nodes.
+ *
+ * @param network A Tunnel Network whose edges were not changed since tn_initialize.
+ * @param subgraph Will contain the subgraph (to be freed with graph_delete), if some node is dropped.
+ * @return true if some node is dropped (@p subgraph is then built).
+ * @return false if every node is in these components (nothing is built).
+ */
+bool tn_endpoints_subgraph(TunnelNetwork network, Graph *subgraph);
+
+/**
+ * @brief Gets the action whose textual representation (see tn_string_of_stack_action) is @p name.
+ *
+ * @param name
+ * @return int The action, or -1 if there is none.
+ */
+int tn_stack_action_of_string(const char *name);
+
 /**
  * @brief Gets the textual representation of @p action.
  *
@@ -124,6 +181,15 @@ bool tn_is_edge(TunnelNetwork network, int source, int target);
  */
 char *tn_get_node_name(TunnelNetwork network, int node);
 
+/**
+ * @brief Returns the node of @p network named @p name.
+ *
+ * @param network
+ * @param name
+ * @return int The node, or -1 if no node has that name.
+ */
+int tn_get_node_from_name(TunnelNetwork network, const char *name);
+
 /**
  * @brief Returns true iff the node @p node can perform action @p action.
  *
@@ -136,6 +202,76 @@ char *tn_get_node_name(TunnelNetwork network, int node);
  */
 bool tn_node_has_action(TunnelNetwork network, int node, stack_action action);
 
+/**
+ * @brief Returns the cost of the edge (@p source, @p target): its "cost" attribute in the dot file (or else its "weight" attribute), 1 if it has none.
+ *
+ * @pre @p source and @p target must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param source
+ * @param target
+ * @return int The cost (at least 0).
+ */
+int tn_get_edge_cost(TunnelNetwork network, int source, int target);
+
+/**
+ * @brief Returns the actions of @p node, as a mask: bit number a is set if the node can perform action a.
+ *
+ * @pre @p node must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param node
+ * @return int
+ */
+int tn_get_node_actions(TunnelNetwork network, int node);
+
+/**
+ * @brief Sets the actions of @p node (mask encoding, see tn_get_node_actions).
+ *
+ * @pre @p node must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param node
+ * @param actions
+ */
+void tn_set_node_actions(TunnelNetwork network, int node, int actions);
+
+/**
+ * @brief Adds the edge (@p source, @p target) to @p network (does nothing if it exists).
+ *
+ * @pre @p source and @p target must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param source
+ * @param target
+ */
+void tn_add_edge(TunnelNetwork network, int source, int target);
+
+/**
+ * @brief Removes the edge (@p source, @p target) from @p network (does nothing if it does not exist).
+ *
+ * @pre @p source and @p target must be between 0 and tn_get_num_nodes(@p network)-1.
+ * @param network
+ * @param source
+ * @param target
+ */
+void tn_remove_edge(TunnelNetwork network, int source, int target);
+
+/**
+ * @brief Returns a number which changes each time an edge or the actions of a node of @p network change, so that structures computed from
+ *        the network can tell whether they are up to date.
+ *
+ * @param network
+ * @return unsigned
+ */
+unsigned tn_get_version(TunnelNetwork network);
+
+/**
+ * @brief Returns the compiled view of @p network (see tn_compiled), compiling it again if the network was modified since the last call.
+ *        The view belongs to @p network: it must not be freed, and is only valid until the next change of an edge or of the actions of a node.
+ *        Not to be called concurrently with a change of @p network.
+ *
+ * @param network
+ * @return const tn_compiled*
+ */
+const tn_compiled *tn_compile(TunnelNetwork network);
+
 /**
  * @brief Gets the initial node of @p network.
  *
@@ -187,6 +323,16 @@ char *tn_get_name(TunnelNetwork network);
  */
 void tn_print_path(TunnelNetwork network, tn_step *path, int size_path);
 
+/**
+ * @brief Same as tn_print_path, in @p file.
+ *
+ * @param file
+ * @param network
+ * @param path
+ * @param size_path
+ */
+void tn_fprint_path(FILE *file, TunnelNetwork network, tn_step *path, int size_path);
+
 /**
  * @brief Generates a dot file representing the path described by @p path (in red) over network @p network. The file will have name <@p name>.dot
  *
@@ -197,6 +343,29 @@ void tn_print_path(TunnelNetwork network, tn_step *path, int size_path);
  */
 void tn_create_dot(TunnelNetwork network, tn_step *path, int size_path, char *name);
 
+/**
+ * @brief Checks that @p path is a well-formed simple path of @p network from @p source to @p target: consecutive steps, existing edges, actions
+ *        allowed by their nodes and possible on the stack (which starts and ends as [4]), and no (node, height) pair visited twice.
+ *
+ * @param network
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param path
+ * @param size_path
+ * @return true if @p path is a solution of size @p size_path.
+ * @return false otherwise.
+ */
+bool tn_check_path(TunnelNetwork network, int source, int target, tn_step *path, int size_path);
+
+/**
+ * @brief Computes a 64-bit FNV-1a hash of the nodes (names and actions) and edges of @p network. It does not depend on the order in which nodes
+ *        are declared, nor on the initial and final nodes.
+ *
+ * @param network
+ * @return unsigned long long The hash.
+ */
+unsigned long long tn_fingerprint(TunnelNetwork network);
+
 /**
  * @brief Creates a tn_step with values given in argument.
  *
@@ -0,0 +1,86 @@
+/**
+ * @file TunnelOptimize.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief Searches the best well-formed simple path of size at most a bound for a cost, in a single run of the Z3 optimiser (MaxSAT) over
+ *        tn_reduction_up_to, instead of trying the sizes one by one. The cost is a weighted sum of the number of steps, of push actions
+ *        (encapsulations) and of the costs of the edges used (tn_get_edge_cost): each step, push and edge used is a soft constraint violated.
+ *        The shortest path is the best one when each step costs 1.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons
+ *
+ */
+
+#ifndef TUNNEL_OPTIMIZE_H
+#define TUNNEL_OPTIMIZE_H
+
+#include "TunnelNetwork.h"
+#include <z3.h>
+
+/**
+ * @brief The weights of the terms of the cost of a path.
+ *
+ */
+typedef struct
+{
+    int hops;  ///< Weight of each step.
+    int push;  ///< Weight of each push action.
+    int edges; ///< Weight of the cost of each edge used.
+} tn_objective;
+
+/**
+ * @brief Reads an objective from @p text, a list of terms separated by commas, each term being "hops", "push" or "cost" optionally followed by "=WEIGHT"
+ *        (weight 1 by default). For instance "cost,push=10". Terms which are not listed have weight 0.
+ *
+ * @param text The text.
+ * @param objective Will contain the objective.
+ * @return true if @p text is a valid objective.
+ * @return false otherwise.
+ */
+bool tn_objective_of_string(const char *text, tn_objective *objective);
+
+/**
+ * @brief Returns the cost of @p path for @p objective.
+ *
+ * @param network A Tunnel Network.
+ * @param objective The weights.
+ * @param path A path.
+ * @param size_path Its size.
+ * @return long The cost.
+ */
+long tn_objective_value(TunnelNetwork network, tn_objective objective, tn_step *path, int size_path);
+
+/**
+ * @brief Searches the well-formed simple path of size at most @p bound from @p source to @p target of smallest cost for @p objective.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param bound The max size of the path.
+ * @param objective The weights of the cost.
+ * @param path Array to return the path if one is found.
+ * @param size_path Will contain the size of the path found.
+ * @return Z3_lbool Z3_L_TRUE if there is a path (the best one is then in @p path), Z3_L_FALSE if not, Z3_L_UNDEF if the solver could not decide.
+ * @pre @p path must be an array of size at least @p bound.
+ */
+Z3_lbool tn_optimize(Z3_context ctx, TunnelNetwork network, int source, int target, int bound, tn_objective objective, tn_step *path, int *size_path);
+
+/**
+ * @brief Searches the shortest well-formed simple path of size at most @p bound from @p source to @p target with a single formula, tn_reduction_up_to:
+ *        tn_optimize with a cost of 1 per step, the optimiser minimising the number of positions where the path has not ended yet. This is a single
+ *        optimiser run on one formula, instead of up to @p bound formulae.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param bound The max size of the path.
+ * @param path Array to return the path if one is found.
+ * @return int The size of the path found, 0 if there is none, -1 if the solver could not decide.
+ * @pre @p path must be an array of size at least @p bound.
+ */
+int tn_shortest_up_to(Z3_context ctx, TunnelNetwork network, int source, int target, int bound, tn_step *path);
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file TunnelQuery.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief Answers many path queries (source, target, bound) over the same network. For each length, the part of the reduction which does not depend
+ *        on the endpoints is built and asserted once, in a solver session kept for that length; each query only passes its endpoints as assumptions.
+ *        Sessions are created lazily, when a query first needs their length.
+ *        In mutable mode, the sessions contain tn_reduction_guarded instead, and the current edges and actions of the network are assumptions too:
+ *        the network may then be modified (tn_add_edge, tn_remove_edge, tn_set_node_actions) between two queries, which are answered by the same sessions,
+ *        keeping what the solver learnt. The sessions only encode the edges the network had at creation (its support): removing them and adding them back
+ *        only changes assumptions, while adding an edge outside of it widens the support and builds the sessions again.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons
+ *
+ */
+
+#ifndef TUNNEL_QUERY_H
+#define TUNNEL_QUERY_H
+
+#include "TunnelNetwork.h"
+#include "Z3Tools.h"
+
+/**
+ * @brief The structure answering queries over a network.
+ *
+ */
+typedef struct TunnelQuery_s *TunnelQuery;
+
+/**
+ * @brief Creates a structure to answer queries over @p network. Must be freed with tn_query_delete.
+ *
+ * @param ctx The solver context (must outlive the structure).
+ * @param network The network (must outlive the structure, and not be modified).
+ * @return TunnelQuery The structure.
+ */
+TunnelQuery tn_query_create(Z3_context ctx, TunnelNetwork network);
+
+/**
+ * @brief Creates a structure to answer queries over @p network in mutable mode: the edges and the actions of @p network may be modified between two queries
+ *        (but not during one). Its current edges are the support of the sessions. Must be freed with tn_query_delete.
+ *
+ * @param ctx The solver context (must outlive the structure).
+ * @param network The network (must outlive the structure, its nodes must not change).
+ * @return TunnelQuery The structure.
+ */
+TunnelQuery tn_query_create_mutable(Z3_context ctx, TunnelNetwork network);
+
+/**
+ * @brief Frees @p query and its solver sessions. Does NOT free the network nor the context.
+ *
+ * @param query
+ */
+void tn_query_delete(TunnelQuery query);
+
+/**
+ * @brief Decides if there is a well-formed simple path of size exactly @p length from @p source to @p target.
+ *
+ * @param query
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param length The size of the path.
+ * @param path Array to return the path if one is found.
+ * @return Z3_lbool Z3_L_TRUE if there is one (it is then in @p path), Z3_L_FALSE if not, Z3_L_UNDEF if the solver could not decide.
+ * @pre @p path must be an array of size at least @p length.
+ */
+Z3_lbool tn_query_check(TunnelQuery query, int source, int target, int length, tn_step *path);
+
+/**
+ * @brief Searches the shortest well-formed simple path of size at most @p bound from @p source to @p target, trying lengths in increasing order.
+ *
+ * @param query
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param bound The max size of the path.
+ * @param path Array to return the path if one is found.
+ * @return int The size of the path found, 0 if there is none, -1 if the solver could not decide for some length.
+ * @pre @p path must be an array of size at least @p bound.
+ */
+int tn_query_solve(TunnelQuery query, int source, int target, int bound, tn_step *path);
+
+/**
+ * @brief As tn_query_solve, but only tries the lengths from @p first, the smaller ones being known to have no path (for instance from a cache).
+ *
+ * @param query
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param first The first length tried.
+ * @param bound The max size of the path.
+ * @param path Array to return the path if one is found.
+ * @return int The size of the path found, 0 if there is none, -1 if the solver could not decide for some length.
+ * @pre @p path must be an array of size at least @p bound.
+ */
+int tn_query_solve_from(TunnelQuery query, int source, int target, int first, int bound, tn_step *path);
+
+/**
+ * @brief Returns the number of lengths for which a session has been built so far.
+ *
+ * @param query
+ * @return int
+ */
+int tn_query_num_sessions(TunnelQuery query);
+
+#endif
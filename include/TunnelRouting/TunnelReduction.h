@@ -27,6 +27,178 @@
  */
 Z3_ast tn_reduction(Z3_context ctx, const TunnelNetwork network, int length);
 
+/**
+ * @brief Number of constraint families (φ₁, φ₂, φ₃, φ₄, φ₆ and φ₈) whose conjunction is the formula produced by tn_reduction.
+ *
+ */
+#define TN_NUM_FAMILIES 6
+
+/**
+ * @brief Returns the name of the constraint family number @p family ("phi_1", ..., "phi_8").
+ *
+ * @param family A family, between 0 and TN_NUM_FAMILIES-1.
+ * @return char* Its name.
+ */
+char *tn_family_name(int family);
+
+/**
+ * @brief Generates the constraint family number @p family of the formula of tn_reduction. The conjunction of every family is equivalent to tn_reduction(@p ctx, @p network, @p length).
+ *        Allows to build (and measure) the families separately.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param length The size of the target path.
+ * @param family A family, between 0 and TN_NUM_FAMILIES-1.
+ * @return Z3_ast The constraints of the family.
+ * @pre @p network must be initialized.
+ */
+Z3_ast tn_reduction_family(Z3_context ctx, const TunnelNetwork network, int length, int family);
+
+/**
+ * @brief Generates a formula equivalent to the part of tn_reduction which does not depend on the initial and final nodes of @p network: every family
+ *        but φ₂, and the bottom of the stack being 4 at both ends of the path. Together with the literals of tn_reduction_endpoints, it is equivalent to
+ *        tn_reduction. Allows to answer queries for several (source, target) pairs with the same formula, passing the endpoints as assumptions.
+ *        It is encoded as tn_reduction_up_to, with only the edges of @p network and the heights the stack can reach at each position, but without early
+ *        ends: the families of tn_reduction are not simplified by the endpoints once these are assumptions, and are then much slower to solve.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param length The size of the target path.
+ * @return Z3_ast The formula.
+ * @pre @p network must be initialized.
+ */
+Z3_ast tn_reduction_without_endpoints(Z3_context ctx, const TunnelNetwork network, int length);
+
+/**
+ * @brief Fills @p literals with the two literals selecting the endpoints of the path: "@p source at position 0 with height 0" and "@p target at position @p length with height 0".
+ *
+ * @param ctx The solver context.
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param length The size of the target path.
+ * @param literals An array of size 2.
+ */
+void tn_reduction_endpoints(Z3_context ctx, int source, int target, int length, Z3_ast *literals);
+
+/**
+ * @brief Generates a formula equivalent to tn_reduction_without_endpoints for every network with the same nodes as @p network whose edges are among
+ *        the ones of the support: the edges of the support and the actions are not read from the network but are variables, selected by the literals of
+ *        tn_reduction_network_literals. The formula only depends on the number of nodes and on the support, so that a solver keeping it (and what it
+ *        learnt from it) can answer queries on a network whose actions change, and whose edges are removed or added back within the support.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network (only its number of nodes is used).
+ * @param length The size of the target path.
+ * @param support_offsets The edges of the support from node are (node, @p support[k]) for k from support_offsets[node] to support_offsets[node + 1] - 1.
+ * @param support The targets of the edges of the support.
+ * @return Z3_ast The formula.
+ * @pre @p network must be initialized.
+ */
+Z3_ast tn_reduction_guarded(Z3_context ctx, const TunnelNetwork network, int length, const int *support_offsets, const int *support);
+
+/**
+ * @brief Fills @p literals with the literals selecting the current edges and actions of @p network in the formula of tn_reduction_guarded: one per edge
+ *        of the support (the edge exists in @p network or not), then one per node and action (the node can perform the action or not).
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network, whose edges must all be in the support.
+ * @param support_offsets The support, as for tn_reduction_guarded.
+ * @param support The targets of the edges of the support.
+ * @param literals An array of size at least support_offsets[tn_get_num_nodes(@p network)] + tn_get_num_nodes(@p network) * NumActions.
+ * @return int The number of literals.
+ */
+int tn_reduction_network_literals(Z3_context ctx, const TunnelNetwork network, const int *support_offsets, const int *support, Z3_ast *literals);
+
+/**
+ * @brief Creates the variable "x_{node,pos,stack_height}" of the reduction: the path is on @p node at position @p pos, the stack having height @p stack_height.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param pos The path position.
+ * @param stack_height The highest cell occupied of the stack at that position.
+ * @return Z3_ast
+ */
+Z3_ast tn_path_variable(Z3_context ctx, int node, int pos, int stack_height);
+
+/**
+ * @brief Creates the variable "the path has ended at position @p pos or before" of tn_reduction_up_to.
+ *
+ * @param ctx The solver context.
+ * @param pos The path position.
+ * @return Z3_ast
+ */
+Z3_ast tn_done_variable(Z3_context ctx, int pos);
+
+/**
+ * @brief Returns the number of cells of the stack in the formula for paths of size @p length (heights are between 0 and get_stack_size(@p length)-1).
+ *
+ * @param length The length of the sought path.
+ * @return int
+ */
+int get_stack_size(int length);
+
+/**
+ * @brief Generates a formula satisfiable if and only if there is a well-formed simple path of size at most @p length, once the endpoints are selected with
+ *        tn_reduction_endpoints(ctx, source, target, @p length, ...). A path of size l < @p length is padded with @p length - l steps which stay on its last
+ *        state; the variable "done at pos i" tells whether the path has ended at position i (see tn_get_length_from_model).
+ *        Allows to search, in a single solver call, among all the sizes up to @p length, for instance for the best path for some objective.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param length The max size of the target path.
+ * @return Z3_ast The formula.
+ * @pre @p network must be initialized.
+ */
+Z3_ast tn_reduction_up_to(Z3_context ctx, const TunnelNetwork network, int length);
+
+/**
+ * @brief Gets the size of the path represented by @p model, a model of tn_reduction_up_to(@p ctx, network, @p length) (the first position where the path has ended).
+ *
+ * @param ctx The solver context.
+ * @param model A variable assignment.
+ * @param length The max size of the path.
+ * @return int The size of the path (the path itself is then obtained with tn_get_path_from_model for that size).
+ */
+int tn_get_length_from_model(Z3_context ctx, Z3_model model, int length);
+
+/**
+ * @brief Generates the constraints of position 0 for the frame-by-frame construction of the reduction (bounded model checking): one state at position 0,
+ *        a well-defined stack with 4 at the bottom. The stack has at most @p stack_size cells, so that frames do not depend on the size of the path:
+ *        take get_stack_size of the largest size which will be asked. As the height changes by at most one per step, position pos only uses
+ *        min(pos + 1, @p stack_size) cells.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param stack_size The max number of cells of the stack.
+ * @return Z3_ast The formula.
+ */
+Z3_ast tn_reduction_first_frame(Z3_context ctx, const TunnelNetwork network, int stack_size);
+
+/**
+ * @brief Generates the constraints added by frame @p pos (at least 1): φ₃ and φ₆ for the step from position @p pos-1 to @p pos, φ₁ and φ₄ at position @p pos,
+ *        and φ₈ between position @p pos and the previous ones. Only the edges of @p network are encoded, and the heights the stack can reach at each position.
+ *        The conjunction of tn_reduction_first_frame and of the frames 1 to l, with the endpoints selected by tn_reduction_endpoints(..., l, ...)[0] and
+ *        tn_reduction_final_frame(..., l, ...), is equivalent to tn_reduction for size l.
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param pos The position added.
+ * @param stack_size The max number of cells of the stack (the same for every frame).
+ * @return Z3_ast The formula.
+ */
+Z3_ast tn_reduction_frame(Z3_context ctx, const TunnelNetwork network, int pos, int stack_size);
+
+/**
+ * @brief Fills @p literals with the two literals stating that the path ends at position @p pos: "@p target at position @p pos with height 0" and
+ *        "4 at the bottom of the stack at position @p pos". Meant to be passed as assumptions, so that later frames can still be added.
+ *
+ * @param ctx The solver context.
+ * @param target The last node of the path.
+ * @param pos The size of the path.
+ * @param literals An array of size 2.
+ */
+void tn_reduction_final_frame(Z3_context ctx, int target, int pos, Z3_ast *literals);
+
 /**
  * @brief Gets the well-formed path from the model @p model.
  *
@@ -0,0 +1,87 @@
+/**
+ * @file TunnelUnrolling.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief Answers path queries with a single solver session in which the reduction is unrolled frame by frame, as in bounded model checking: going from
+ *        size l to size l+1 only adds frame l+1 (tn_reduction_frame), and the endpoints are assumptions. Every frame is built once, whatever the number of
+ *        sizes and queries, and the solver keeps what it learnt from one size to the next. Each frame is guarded by an activation literal, assumed for
+ *        the sizes it belongs to, so that frames built for a larger bound do not constrain a smaller one. The stack has at most the number of cells of
+ *        the largest size allowed, and frame pos at most pos + 1 of them; each frame only encodes the edges of the network.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons
+ *
+ */
+
+#ifndef TUNNEL_UNROLLING_H
+#define TUNNEL_UNROLLING_H
+
+#include "TunnelNetwork.h"
+#include "Z3Tools.h"
+
+/**
+ * @brief The structure answering queries over a network by unrolling.
+ *
+ */
+typedef struct TunnelUnrolling_s *TunnelUnrolling;
+
+/**
+ * @brief Creates a structure to answer queries of bound at most @p max_length over @p network. Must be freed with tn_unrolling_delete.
+ *
+ * @param ctx The solver context (must outlive the structure).
+ * @param network The network (must outlive the structure, and not be modified).
+ * @param max_length The largest bound of the queries.
+ * @return TunnelUnrolling The structure.
+ */
+TunnelUnrolling tn_unrolling_create(Z3_context ctx, TunnelNetwork network, int max_length);
+
+/**
+ * @brief Frees @p unrolling and its solver session. Does NOT free the network nor the context.
+ *
+ * @param unrolling
+ */
+void tn_unrolling_delete(TunnelUnrolling unrolling);
+
+/**
+ * @brief Decides if there is a well-formed simple path of size exactly @p length from @p source to @p target, adding the frames which are not built yet.
+ *
+ * @param unrolling
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param length The size of the path (at most the max length given at creation).
+ * @param path Array to return the path if one is found.
+ * @return Z3_lbool Z3_L_TRUE if there is one (it is then in @p path), Z3_L_FALSE if not, Z3_L_UNDEF if the solver could not decide.
+ * @pre @p path must be an array of size at least @p length.
+ */
+Z3_lbool tn_unrolling_check(TunnelUnrolling unrolling, int source, int target, int length, tn_step *path);
+
+/**
+ * @brief Searches the shortest well-formed simple path of size at most @p bound from @p source to @p target, adding the frames which are not built yet.
+ *
+ * @param unrolling
+ * @param source The first node of the path.
+ * @param target The last node of the path.
+ * @param bound The max size of the path (at most the max length given at creation).
+ * @param path Array to return the path if one is found.
+ * @return int The size of the path found, 0 if there is none, -1 if the solver could not decide for some size.
+ * @pre @p path must be an array of size at least @p bound.
+ */
+int tn_unrolling_solve(TunnelUnrolling unrolling, int source, int target, int bound, tn_step *path);
+
+/**
+ * @brief Returns the number of frames built so far (the largest size the session can answer for).
+ *
+ * @param unrolling
+ * @return int
+ */
+int tn_unrolling_num_frames(TunnelUnrolling unrolling);
+
+/**
+ * @brief Returns the solver session of @p unrolling (to read its statistics).
+ *
+ * @param unrolling
+ * @return Z3Session
+ */
+Z3Session tn_unrolling_get_session(TunnelUnrolling unrolling);
+
+#endif
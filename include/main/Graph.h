@@ -86,6 +86,30 @@ typedef struct
  */
 Graph graph_copy(Graph graph);
 
+/**
+ * @brief Creates the subgraph of @p graph induced by @p nodes: node i of the result is node @p nodes[i] of @p graph, with its name and parameters,
+ *        and the edges (and their parameters) are the ones of @p graph between these nodes. Must be freed with graph_delete.
+ *
+ * @param graph A graph.
+ * @param nodes The nodes kept, without repetition.
+ * @param num_nodes Their number.
+ * @return Graph The subgraph.
+ * @pre @p graph must be a valid graph.
+ */
+Graph graph_induced_subgraph(Graph graph, const int *nodes, int num_nodes);
+
+/**
+ * @brief Computes the connected components of @p graph, the direction of the edges being ignored (weakly connected components of a digraph).
+ *        Components are numbered from 0 in the order of their smallest node.
+ *
+ * @param graph A graph.
+ * @param component Array to return the component of each node.
+ * @return int The number of components.
+ * @pre @p graph must be a valid graph.
+ * @pre @p component must be an array of size at least the number of nodes of @p graph.
+ */
+int graph_components(Graph graph, int *component);
+
 /**
  * @brief Displays a graph with a list of nodes and a matrix of edges.
  *
@@ -0,0 +1,180 @@
+/**
+ * @file Memory.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Memory accounting. Our own structures are allocated through memory_malloc and friends, which count the bytes in use and their peak
+ *         per category when the program is compiled with -D MEMORY_ACCOUNTING (and are plain malloc and friends otherwise).
+ *         The resident memory of the process (current and high-water mark, from /proc/self/status) is always available.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_MEMORY_H_
+#define COCA_MEMORY_H_
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @brief What an allocation is used for.
+ *
+ */
+typedef enum
+{
+    MemoryGraph,        ///< Graph and parameter lists.
+    MemoryParser,       ///< Temporary lists of the parser.
+    MemoryReduction,    ///< Scratch arrays used while building formulae.
+    MemoryNumCategories ///< Number of categories.
+} memory_category;
+
+/**
+ * @brief Memory used during a phase: high-water mark of the resident memory of the process and peak of the counted allocations of each category.
+ *
+ */
+typedef struct
+{
+    long rss_peak;                         ///< High-water mark of the resident memory, in KiB (-1 if unknown).
+    size_t heap_peak[MemoryNumCategories]; ///< Peak of the counted allocations of each category, in bytes (0 without MEMORY_ACCOUNTING).
+    bool shared;                           ///< Set if several threads were running: the peaks were not reset and cover the whole run so far.
+} memory_usage;
+
+#ifdef MEMORY_ACCOUNTING
+
+/**
+ * @brief Same as malloc, the bytes are counted in @p category.
+ *
+ * @param size The size to allocate.
+ * @param category What it is used for.
+ * @return void* The allocated memory, to be freed with memory_free.
+ */
+void *memory_malloc(size_t size, memory_category category);
+
+/**
+ * @brief Same as calloc, the bytes are counted in @p category.
+ *
+ * @param num Number of elements.
+ * @param size Size of an element.
+ * @param category What it is used for.
+ * @return void* The allocated memory (zeroed), to be freed with memory_free.
+ */
+void *memory_calloc(size_t num, size_t size, memory_category category);
+
+/**
+ * @brief Same as realloc. @p pointer must come from memory_malloc, memory_calloc or memory_realloc (or be NULL).
+ *
+ * @param pointer The memory to resize.
+ * @param size The new size.
+ * @param category What it is used for.
+ * @return void* The resized memory.
+ */
+void *memory_realloc(void *pointer, size_t size, memory_category category);
+
+/**
+ * @brief Same as free, for memory obtained from memory_malloc, memory_calloc or memory_realloc.
+ *
+ * @param pointer The memory to free (can be NULL).
+ */
+void memory_free(void *pointer);
+
+#else
+
+#define memory_malloc(size, category) malloc(size)
+#define memory_calloc(num, size, category) calloc(num, size)
+#define memory_realloc(pointer, size, category) realloc(pointer, size)
+#define memory_free(pointer) free(pointer)
+
+#endif
+
+/**
+ * @brief Tells if allocations are counted (compiled with -D MEMORY_ACCOUNTING).
+ *
+ * @return true if memory_current and memory_peak are meaningful.
+ * @return false otherwise (they always return 0).
+ */
+bool memory_accounting_enabled(void);
+
+/**
+ * @brief Returns the name of @p category ("graph", "parser", "reduction").
+ *
+ * @param category A category.
+ * @return char* Its name.
+ */
+char *memory_category_name(memory_category category);
+
+/**
+ * @brief Returns the number of bytes currently allocated in @p category.
+ *
+ * @param category A category.
+ * @return size_t The number of bytes.
+ */
+size_t memory_current(memory_category category);
+
+/**
+ * @brief Returns the largest number of bytes allocated at once in @p category since the start or the last memory_reset_peaks.
+ *
+ * @param category A category.
+ * @return size_t The number of bytes.
+ */
+size_t memory_peak(memory_category category);
+
+/**
+ * @brief Returns the largest number of bytes allocated at once, all categories together, since the start or the last memory_reset_peaks.
+ *
+ * @return size_t The number of bytes.
+ */
+size_t memory_total_peak(void);
+
+/**
+ * @brief Sets the peaks of all categories to the memory currently allocated, so that the next peaks measure what happens from now on.
+ *
+ */
+void memory_reset_peaks(void);
+
+/**
+ * @brief Returns the resident memory of the process (VmRSS), in KiB.
+ *
+ * @return long The resident memory, or -1 if it cannot be read.
+ */
+long memory_rss(void);
+
+/**
+ * @brief Returns the high-water mark of the resident memory of the process (VmHWM), in KiB, since the start or the last memory_reset_rss_peak.
+ *
+ * @return long The high-water mark, or -1 if it cannot be read.
+ */
+long memory_rss_peak(void);
+
+/**
+ * @brief Resets the high-water mark of the resident memory to the current resident memory (Linux only). This is done for the whole process, by
+ *        writing to /proc/self/clear_refs, which also clears the soft-dirty and referenced bits of all its pages.
+ *
+ * @return true if it has been reset.
+ * @return false otherwise (the high-water mark then covers the whole run).
+ */
+bool memory_reset_rss_peak(void);
+
+/**
+ * @brief Ends a phase: returns the memory used since the end of the previous phase (or the start) and resets the peaks for the next phase.
+ *        The peaks are those of the whole process, so they can only be attributed to a phase when a single thread is working. Between
+ *        memory_concurrency_begin and memory_concurrency_end, the peaks are not reset (they cover the whole run so far) and the result is marked shared.
+ *
+ * @return memory_usage The peaks of the phase.
+ */
+memory_usage memory_phase_end(void);
+
+/**
+ * @brief Declares that several threads may work at the same time (a thread pool, a daemon), until the matching memory_concurrency_end.
+ *        memory_phase_end does not reset the peaks meanwhile. Calls can be nested and made from any thread.
+ *
+ */
+void memory_concurrency_begin(void);
+
+/**
+ * @brief Ends what the matching memory_concurrency_begin started.
+ *
+ */
+void memory_concurrency_end(void);
+
+#endif
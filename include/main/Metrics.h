@@ -0,0 +1,153 @@
+/**
+ * @file Metrics.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Measures of a run of the solver: wall-clock and CPU time and memory of each phase, named counters (sizes of formulae, ...) and statistics of the SAT solver.
+ *         Everything recorded can be written as a single JSON object, so runs can be compared automatically.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_METRICS_H_
+#define COCA_METRICS_H_
+
+#include "Z3Tools.h"
+#include "Memory.h"
+#include <stdio.h>
+
+/**
+ * @brief A point in time, both in wall-clock time (monotonic) and in CPU time of the process, in seconds.
+ *
+ */
+typedef struct
+{
+    double wall; ///< Monotonic wall-clock time.
+    double cpu;  ///< CPU time consumed by the whole process (all threads).
+} time_point;
+
+/**
+ * @brief Returns the current time_point.
+ *
+ * @return time_point The current time.
+ */
+time_point time_now(void);
+
+/**
+ * @brief Returns the wall-clock time elapsed since @p start, in seconds.
+ *
+ * @param start A time_point.
+ * @return double The elapsed time.
+ */
+double time_elapsed(time_point start);
+
+/**
+ * @brief The structure storing the measures of a run.
+ *
+ */
+typedef struct Metrics_s *Metrics;
+
+/**
+ * @brief Creates an empty set of measures. Must be freed with metrics_delete.
+ *
+ * @return Metrics The measures.
+ */
+Metrics metrics_create(void);
+
+/**
+ * @brief Frees @p metrics.
+ *
+ * @param metrics Measures.
+ */
+void metrics_delete(Metrics metrics);
+
+/**
+ * @brief Forgets everything recorded in @p metrics.
+ *
+ * @param metrics Measures.
+ */
+void metrics_reset(Metrics metrics);
+
+/**
+ * @brief Records a textual information (problem, file, result...). Replaces the previous value of @p name if any.
+ *
+ * @param metrics Measures.
+ * @param name The name of the information.
+ * @param value Its value.
+ */
+void metrics_set_label(Metrics metrics, const char *name, const char *value);
+
+/**
+ * @brief Records a numerical information (sizes, lengths...). Replaces the previous value of @p name if any.
+ *
+ * @param metrics Measures.
+ * @param name The name of the counter.
+ * @param value Its value.
+ */
+void metrics_set_counter(Metrics metrics, const char *name, double value);
+
+/**
+ * @brief Records a phase named @p name which started at @p start and ends now, with the memory used since the previous phase ended (see memory_phase_end).
+ *
+ * @param metrics Measures.
+ * @param name The name of the phase.
+ * @param start The time the phase started.
+ */
+void metrics_add_phase(Metrics metrics, const char *name, time_point start);
+
+/**
+ * @brief Records the same phase as metrics_add_phase, with durations (and memory used) already known.
+ *
+ * @param metrics Measures.
+ * @param name The name of the phase.
+ * @param wall Its wall-clock duration.
+ * @param cpu Its CPU duration.
+ * @param memory The memory it used (from memory_phase_end), or NULL if unknown.
+ */
+void metrics_add_phase_duration(Metrics metrics, const char *name, double wall, double cpu, const memory_usage *memory);
+
+/**
+ * @brief Records the number of variables and clauses of @p formula as counters "<@p family>.variables" and "<@p family>.clauses".
+ *
+ * @param metrics Measures.
+ * @param ctx The solver context.
+ * @param family The name of the formula.
+ * @param formula A formula.
+ */
+void metrics_add_formula_size(Metrics metrics, Z3_context ctx, const char *family, Z3_ast formula);
+
+/**
+ * @brief Records the statistics of the last check of @p session (conflicts, decisions, propagations and memory used).
+ *
+ * @param metrics Measures.
+ * @param session A solver session.
+ */
+void metrics_add_session_statistics(Metrics metrics, Z3Session session);
+
+/**
+ * @brief Writes @p text as a JSON string (quoted and escaped) in @p file.
+ *
+ * @param file A file.
+ * @param text A string.
+ */
+void print_json_string(FILE *file, const char *text);
+
+/**
+ * @brief Writes @p value in @p file with @p format as a JSON number, or null if it is not finite (JSON has no NaN nor infinity).
+ *
+ * @param file A file.
+ * @param format A printf format for one double.
+ * @param value A number.
+ */
+void print_json_number(FILE *file, const char *format, double value);
+
+/**
+ * @brief Writes @p metrics in @p file as one JSON object on a single line. The memory currently used (resident and counted allocations) is added to it.
+ *
+ * @param metrics Measures.
+ * @param file A file.
+ */
+void metrics_print_json(Metrics metrics, FILE *file);
+
+#endif
@@ -16,7 +16,8 @@
 #include "Graph.h"
 
 /**
- * @brief Parses a file and return the Graph described by it. If the file with the name given in argument does not exists, it displays an error message and exits the program.
+ * @brief Parses a file and return the Graph described by it. If the file with the name given in argument does not exists or is not a valid graphviz file, it displays an error message and exits the program.
+ *        Can be called from several threads at the same time: each parsing has its own scanner.
  * 
  * @param toRead the name of a file in graphviz format.
  * @return GraphList The parsed GraphList.
@@ -24,4 +25,15 @@
  */
 Graph get_graph_from_file(char *toRead);
 
+/**
+ * @brief Parses a file into @p graph. Nothing is built if the file cannot be opened or is not a valid graphviz file (the syntax errors are written on stderr).
+ *        Can be called from several threads at the same time.
+ *
+ * @param toRead the name of a file in graphviz format.
+ * @param graph Where to store the parsed Graph.
+ * @return true if @p graph has been filled.
+ * @return false otherwise.
+ */
+bool try_get_graph_from_file(char *toRead, Graph *graph);
+
 #endif
\ No newline at end of file
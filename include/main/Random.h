@@ -0,0 +1,59 @@
+/**
+ * @file Random.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Small seeded pseudo-random generator (xorshift64*). Unlike rand(), it gives the same sequence on every platform for a given seed, and its state is
+ *         explicit, so several threads can each use their own generator.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_RANDOM_H_
+#define COCA_RANDOM_H_
+
+/**
+ * @brief The state of a generator.
+ *
+ */
+typedef struct
+{
+    unsigned long long state; ///< Current state (never 0).
+} random_generator;
+
+/**
+ * @brief Initializes @p generator from @p seed. Two generators with the same seed produce the same sequence.
+ *
+ * @param generator A generator.
+ * @param seed Any value.
+ */
+void random_seed(random_generator *generator, unsigned long long seed);
+
+/**
+ * @brief Returns the next 64 random bits of @p generator.
+ *
+ * @param generator An initialized generator.
+ * @return unsigned long long The random bits.
+ */
+unsigned long long random_next(random_generator *generator);
+
+/**
+ * @brief Returns a random integer uniformly chosen between 0 and @p bound - 1.
+ *
+ * @param generator An initialized generator.
+ * @param bound The (excluded) upper bound.
+ * @return int The integer.
+ * @pre @p bound > 0.
+ */
+int random_int(random_generator *generator, int bound);
+
+/**
+ * @brief Returns a random real uniformly chosen in [0,1).
+ *
+ * @param generator An initialized generator.
+ * @return double The real.
+ */
+double random_double(random_generator *generator);
+
+#endif
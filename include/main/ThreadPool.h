@@ -0,0 +1,74 @@
+/**
+ * @file ThreadPool.h
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Fixed-size pool of worker threads executing tasks in the order they are submitted. Each task is told the index of the worker running it,
+ *         so that it can use resources owned by that worker (a solver context for instance) without any locking.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#ifndef COCA_THREAD_POOL_H_
+#define COCA_THREAD_POOL_H_
+
+/**
+ * @brief A pool of worker threads.
+ *
+ */
+typedef struct ThreadPool_s *ThreadPool;
+
+/**
+ * @brief A task: a function called with the argument given at submission and the index of the worker running it (between 0 and the number of workers - 1).
+ *
+ */
+typedef void (*thread_pool_task)(void *argument, int worker);
+
+/**
+ * @brief Starts a pool of @p num_workers threads. Must be freed with thread_pool_delete.
+ *
+ * @param num_workers The number of threads (at least 1).
+ * @return ThreadPool The pool.
+ */
+ThreadPool thread_pool_create(int num_workers);
+
+/**
+ * @brief Waits for all submitted tasks to be done, stops the threads and frees @p pool.
+ *
+ * @param pool A pool.
+ */
+void thread_pool_delete(ThreadPool pool);
+
+/**
+ * @brief Adds a task to the queue of @p pool. It will be run by the first idle worker, after all the tasks submitted before it have started.
+ *
+ * @param pool A pool.
+ * @param task The function to run.
+ * @param argument Its argument (must stay valid until the task is done).
+ */
+void thread_pool_submit(ThreadPool pool, thread_pool_task task, void *argument);
+
+/**
+ * @brief Waits until all the tasks submitted to @p pool so far are done.
+ *
+ * @param pool A pool.
+ */
+void thread_pool_wait(ThreadPool pool);
+
+/**
+ * @brief Returns the number of worker threads of @p pool.
+ *
+ * @param pool A pool.
+ * @return int The number of workers.
+ */
+int thread_pool_num_workers(ThreadPool pool);
+
+/**
+ * @brief Returns the number of processors online, to size a pool.
+ *
+ * @return int The number of processors (at least 1).
+ */
+int thread_pool_num_processors(void);
+
+#endif
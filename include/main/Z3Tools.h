@@ -16,6 +16,7 @@
 
 #include <z3.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 /**
  * @brief Creates a basic Z3 context with basic config (sufficient for this project). Must be freed at end of program with Z3_del_context.
@@ -95,4 +96,131 @@ Z3_lbool solve_formula(Z3_context ctx, Z3_ast formula, Z3_model *model);
  */
 bool value_of_var_in_model(Z3_context ctx, Z3_model model, Z3_ast variable);
 
+/**
+ * @brief Computes the size of @p formula: its number of distinct variables, and its number of clauses, i.e. of conjuncts once nested conjunctions are
+ *        flattened. Shared subformulae are only visited once.
+ *
+ * @param ctx The context of the solver.
+ * @param formula A formula.
+ * @param num_variables Will contain the number of distinct variables of @p formula.
+ * @param num_clauses Will contain the number of clauses of @p formula.
+ */
+void formula_size(Z3_context ctx, Z3_ast formula, int *num_variables, int *num_clauses);
+
+/**
+ * @brief A solver session. Wraps a reference-counted Z3 solver which can receive formulae incrementally and be checked several times (with or without
+ *        assumptions), so that what the solver learns during a check is kept for the following ones. The model of the last satisfiable check is kept by
+ *        the session and stays valid until the next check or the deletion of the session.
+ *
+ */
+typedef struct Z3Session_s *Z3Session;
+
+/**
+ * @brief Creates a solver session over @p ctx. Must be freed with session_delete before @p ctx is deleted.
+ *
+ * @param ctx The context of the solver.
+ * @return Z3Session The created session.
+ */
+Z3Session session_create(Z3_context ctx);
+
+/**
+ * @brief Frees @p session, its solver and the last model it holds. Does NOT delete the context.
+ *
+ * @param session A session.
+ */
+void session_delete(Z3Session session);
+
+/**
+ * @brief Returns the context @p session works in.
+ *
+ * @param session A session.
+ * @return Z3_context Its context.
+ */
+Z3_context session_get_context(Z3Session session);
+
+/**
+ * @brief Adds @p formula to the formulae asserted in @p session (in the current scope).
+ *
+ * @param session A session.
+ * @param formula A formula.
+ */
+void session_assert(Z3Session session, Z3_ast formula);
+
+/**
+ * @brief Opens a new scope in @p session. Formulae asserted after this call are removed by the matching session_pop.
+ *
+ * @param session A session.
+ */
+void session_push(Z3Session session);
+
+/**
+ * @brief Closes the @p num_scopes last scopes opened in @p session, removing the formulae asserted in them.
+ *
+ * @param session A session.
+ * @param num_scopes The number of scopes to close.
+ * @pre @p num_scopes must be at most the number of scopes currently open.
+ */
+void session_pop(Z3Session session, unsigned num_scopes);
+
+/**
+ * @brief Tells if the conjunction of the formulae asserted in @p session is satisfiable. If it is, its model can be obtained with session_get_model.
+ *
+ * @param session A session.
+ * @return Z3_lbool Z3_L_FALSE if unsatisfiable, Z3_L_TRUE if satisfiable and Z3_L_UNDEF if the solver could not decide (or was interrupted).
+ */
+Z3_lbool session_check(Z3Session session);
+
+/**
+ * @brief Same as session_check, but the formulae of @p assumptions are assumed true for this check only. Typically used with literals activating parts of the
+ *        asserted formulae.
+ *
+ * @param session A session.
+ * @param num_assumptions The number of assumptions.
+ * @param assumptions The assumptions (each must be a propositional variable or its negation).
+ * @return Z3_lbool Z3_L_FALSE if unsatisfiable under @p assumptions, Z3_L_TRUE if satisfiable and Z3_L_UNDEF if the solver could not decide.
+ */
+Z3_lbool session_check_assumptions(Z3Session session, int num_assumptions, Z3_ast *assumptions);
+
+/**
+ * @brief Returns the model found by the last check of @p session. The model is owned by the session: it stays valid until the next check or the deletion of
+ *        @p session, and must not be freed by the caller.
+ *
+ * @param session A session.
+ * @return Z3_model The model, or NULL if the last check was not satisfiable.
+ */
+Z3_model session_get_model(Z3Session session);
+
+/**
+ * @brief Returns the value of the statistic @p key (e.g. "conflicts", "decisions", "propagations", "memory") of the last check of @p session.
+ *
+ * @param session A session.
+ * @param key The name of a statistic.
+ * @return double Its value, or 0 if the solver does not report this statistic.
+ */
+double session_get_statistic(Z3Session session, const char *key);
+
+/**
+ * @brief Writes every statistic of the last check of @p session in @p file, one "key: value" per line.
+ *
+ * @param session A session.
+ * @param file A file.
+ */
+void session_print_statistics(Z3Session session, FILE *file);
+
+/**
+ * @brief Bounds the duration of the next checks of @p session. A check reaching the bound returns Z3_L_UNDEF.
+ *
+ * @param session A session.
+ * @param milliseconds The bound (0 means no bound).
+ */
+void session_set_timeout(Z3Session session, unsigned milliseconds);
+
+/**
+ * @brief Interrupts the check currently running in @p session, which then returns Z3_L_UNDEF. Can be called from another thread (or a signal handler).
+ *        Note that Z3 interrupts every check running in the context of @p session.
+ *
+ * @param session A session.
+ */
+void session_interrupt(Z3Session session);
+
 #endif
\ No newline at end of file
@@ -8,10 +8,40 @@
 
 struct ColouredGraph_s
 {
-    Graph graph;  ///< The graph.
-    int *colours; ///< The colours associated to each node.
+    Graph graph;            ///< The graph.
+    int *colours;           ///< The colours associated to each node.
+    cg_adjacency adjacency; ///< The neighbours of each node.
 };
 
+/**
+ * @brief Fills the adjacency of @p graph from its Graph, with one scan of its edges.
+ *
+ * @param graph A ColouredGraph whose adjacency is not built yet.
+ */
+static void cg_build_adjacency(ColouredGraph graph)
+{
+    int num_nodes = graph_num_nodes(graph->graph);
+    cg_adjacency *adjacency = &graph->adjacency;
+    adjacency->num_nodes = num_nodes;
+    adjacency->offsets = (int *)malloc((num_nodes + 1) * sizeof(int));
+    adjacency->offsets[0] = 0;
+    for (int node = 0; node < num_nodes; node++)
+    {
+        adjacency->offsets[node + 1] = adjacency->offsets[node];
+        for (int other = 0; other < num_nodes; other++)
+            if (other != node && (graph_is_edge(graph->graph, node, other) || graph_is_edge(graph->graph, other, node)))
+                adjacency->offsets[node + 1]++;
+    }
+    adjacency->neighbours = (int *)malloc((adjacency->offsets[num_nodes] + 1) * sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+    {
+        int position = adjacency->offsets[node];
+        for (int other = 0; other < num_nodes; other++)
+            if (other != node && (graph_is_edge(graph->graph, node, other) || graph_is_edge(graph->graph, other, node)))
+                adjacency->neighbours[position++] = other;
+    }
+}
+
 ColouredGraph cg_initialize(Graph graph)
 {
     ColouredGraph result = (ColouredGraph)malloc(sizeof(*result));
@@ -20,6 +50,7 @@ ColouredGraph cg_initialize(Graph graph)
     result->colours = (int *)malloc(num_nodes * sizeof(int));
     for (int node = 0; node < num_nodes; node++)
         result->colours[node] = -1;
+    cg_build_adjacency(result);
     return result;
 }
 
@@ -30,20 +61,32 @@ void cg_print(ColouredGraph graph)
 
 void cg_print_colors(ColouredGraph graph)
 {
-    printf("Colours of each node:\n");
+    cg_fprint_colors(stdout, graph);
+}
+
+void cg_fprint_colors(FILE *file, ColouredGraph graph)
+{
+    fprintf(file, "Colours of each node:\n");
     int num_nodes = graph_num_nodes(graph->graph);
     for (int node = 0; node < num_nodes; node++)
     {
-        printf("%s(%d) : %d\n", graph_get_node_name(graph->graph, node), node, graph->colours[node]);
+        fprintf(file, "%s(%d) : %d\n", graph_get_node_name(graph->graph, node), node, graph->colours[node]);
     }
 }
 
 void cg_delete(ColouredGraph graph)
 {
+    free(graph->adjacency.offsets);
+    free(graph->adjacency.neighbours);
     free(graph->colours);
     free(graph);
 }
 
+Graph cg_get_graph(ColouredGraph graph)
+{
+    return graph->graph;
+}
+
 int cg_get_num_nodes(ColouredGraph graph)
 {
     return graph_num_nodes(graph->graph);
@@ -59,6 +102,11 @@ bool cg_is_edge(ColouredGraph graph, int source, int target)
     return (graph_is_edge(graph->graph, source, target));
 }
 
+const cg_adjacency *cg_get_adjacency(ColouredGraph graph)
+{
+    return &graph->adjacency;
+}
+
 char *cg_get_node_name(ColouredGraph graph, int node)
 {
     return graph_get_node_name(graph->graph, node);
@@ -0,0 +1,74 @@
+#include "ColouringChromatic.h"
+#include "ColouringResolution.h"
+#include "Z3Tools.h"
+
+/**
+ * @brief Returns the number of colours used by the colouring of @p graph (its largest colour plus one).
+ *
+ * @param graph A coloured ColouredGraph.
+ * @return int The number of colours.
+ */
+static int colouring_num_colours_used(ColouredGraph graph)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    int num_used = 0;
+    for (int node = 0; node < num_nodes; node++)
+        if (cg_get_node_colour(graph, node) >= num_used)
+            num_used = cg_get_node_colour(graph, node) + 1;
+    return num_used;
+}
+
+int colouring_chromatic_number(Z3_context ctx, ColouredGraph graph, colouring_symmetry symmetry, colouring_encoding encoding, bool binary_search, int *num_calls)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    int clique[num_nodes + 1];
+    int low = colouring_greedy_clique(graph, clique);
+    int high = colouring_greedy(graph);
+    int calls = 0;
+    // The chromatic number is in [low, high], and graph has a colouring with high colours (only a satisfiable call changes it).
+    if (low < high)
+    {
+        int max_colours = high - 1;
+        Z3Session session = session_create(ctx);
+        // Only the direct encoding has the variables "colour c used": the other ones assert the reduction of each k in its own scope.
+        bool limited = encoding == colouring_encoding_direct;
+        if (limited)
+            session_assert(session, colouring_reduction_up_to(ctx, graph, max_colours, symmetry));
+        Z3_ast assumptions[max_colours + 1];
+        while (low < high)
+        {
+            int num_colours = binary_search ? (low + high - 1) / 2 : high - 1;
+            calls++;
+            Z3_lbool result;
+            if (limited)
+            {
+                int num_assumptions = colouring_reduction_limit(ctx, num_colours, max_colours, assumptions);
+                result = session_check_assumptions(session, num_assumptions, assumptions);
+            }
+            else
+            {
+                session_push(session);
+                session_assert(session, colouring_reduction_encoded(ctx, graph, num_colours, symmetry, encoding));
+                result = session_check(session);
+            }
+            if (result == Z3_L_TRUE)
+            {
+                colour_graph_from_model(ctx, session_get_model(session), graph, limited ? max_colours : num_colours, encoding);
+                high = colouring_num_colours_used(graph);
+            }
+            if (!limited)
+                session_pop(session, 1);
+            if (result == Z3_L_UNDEF)
+            {
+                high = -1;
+                break;
+            }
+            if (result == Z3_L_FALSE)
+                low = num_colours + 1;
+        }
+        session_delete(session);
+    }
+    if (num_calls != NULL)
+        *num_calls = calls;
+    return high;
+}
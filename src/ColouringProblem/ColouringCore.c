@@ -0,0 +1,122 @@
+#include "ColouringCore.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+struct ColouringCore_s
+{
+    ColouredGraph original; ///< The graph peeled.
+    Graph core_graph;       ///< The subgraph induced by the nodes kept.
+    ColouredGraph core;     ///< The coloured version of core_graph.
+    int num_colours;        ///< The number of colours the core was computed for.
+    int *kept;              ///< kept[i] is the node of the original graph which is node i of the core.
+    int num_kept;           ///< The number of nodes of the core.
+    int *peeled;            ///< The nodes removed, in order of removal.
+    int num_peeled;         ///< The number of nodes removed.
+    const int *offsets;     ///< The neighbours of node n in the original graph are neighbours[offsets[n]] to neighbours[offsets[n + 1] - 1] (cg_get_adjacency).
+    const int *neighbours;  ///< The neighbours of all nodes (without the node itself).
+};
+
+ColouringCore colouring_core_create(ColouredGraph graph, int num_colours)
+{
+    ColouringCore core = (ColouringCore)malloc(sizeof(*core));
+    int num_nodes = cg_get_num_nodes(graph);
+    core->original = graph;
+    core->num_colours = num_colours;
+    core->offsets = cg_get_adjacency(graph)->offsets;
+    core->neighbours = cg_get_adjacency(graph)->neighbours;
+
+    // Each node whose degree among the nodes left drops below num_colours is removed, which may lower the degree of its neighbours in turn.
+    int *degree = (int *)malloc((num_nodes + 1) * sizeof(int));
+    bool *removed = (bool *)malloc((num_nodes + 1) * sizeof(bool));
+    core->peeled = (int *)malloc((num_nodes + 1) * sizeof(int));
+    core->num_peeled = 0;
+    for (int node = 0; node < num_nodes; node++)
+    {
+        degree[node] = core->offsets[node + 1] - core->offsets[node];
+        removed[node] = degree[node] < num_colours;
+        if (removed[node])
+            core->peeled[core->num_peeled++] = node;
+    }
+    // peeled is also the queue of nodes whose neighbours have not been updated yet.
+    for (int next = 0; next < core->num_peeled; next++)
+    {
+        int node = core->peeled[next];
+        for (int k = core->offsets[node]; k < core->offsets[node + 1]; k++)
+        {
+            int neighbour = core->neighbours[k];
+            if (!removed[neighbour] && --degree[neighbour] < num_colours)
+            {
+                removed[neighbour] = true;
+                core->peeled[core->num_peeled++] = neighbour;
+            }
+        }
+    }
+
+    core->kept = (int *)malloc((num_nodes + 1) * sizeof(int));
+    core->num_kept = 0;
+    for (int node = 0; node < num_nodes; node++)
+        if (!removed[node])
+            core->kept[core->num_kept++] = node;
+    core->core_graph = graph_induced_subgraph(cg_get_graph(graph), core->kept, core->num_kept);
+    core->core = cg_initialize(core->core_graph);
+    free(degree);
+    free(removed);
+    return core;
+}
+
+ColouredGraph colouring_core_get_graph(ColouringCore core)
+{
+    return core->core;
+}
+
+int colouring_core_get_node(ColouringCore core, int node)
+{
+    return core->kept[node];
+}
+
+int colouring_core_num_peeled(ColouringCore core)
+{
+    return core->num_peeled;
+}
+
+void colouring_core_extend(ColouringCore core)
+{
+    int num_nodes = cg_get_num_nodes(core->original);
+    for (int node = 0; node < num_nodes; node++)
+        cg_set_node_colour(core->original, node, -1);
+    for (int i = 0; i < core->num_kept; i++)
+        cg_set_node_colour(core->original, core->kept[i], cg_get_node_colour(core->core, i));
+
+    // When a node was removed, it had less than num_colours neighbours left, which are the only ones coloured before it here.
+    bool used[core->num_colours + 1];
+    for (int next = core->num_peeled - 1; next >= 0; next--)
+    {
+        int node = core->peeled[next];
+        for (int col = 0; col <= core->num_colours; col++)
+            used[col] = false;
+        for (int k = core->offsets[node]; k < core->offsets[node + 1]; k++)
+        {
+            int colour = cg_get_node_colour(core->original, core->neighbours[k]);
+            if (colour >= 0 && colour < core->num_colours)
+                used[colour] = true;
+        }
+        int colour = 0;
+        while (used[colour])
+            colour++;
+        if (colour == core->num_colours)
+        {
+            fprintf(stderr, "Error: node %s has all %d colours among its neighbours, the core was not coloured.\n", cg_get_node_name(core->original, node), core->num_colours);
+            exit(EXIT_FAILURE);
+        }
+        cg_set_node_colour(core->original, node, colour);
+    }
+}
+
+void colouring_core_delete(ColouringCore core)
+{
+    cg_delete(core->core);
+    graph_delete(core->core_graph);
+    free(core->kept);
+    free(core->peeled);
+    free(core);
+}
@@ -0,0 +1,342 @@
+#include "ColouringDecomposition.h"
+#include "ThreadPool.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+/**
+ * @brief What the pieces of a decomposition share.
+ *
+ */
+typedef struct
+{
+    Graph graph;              ///< The graph decomposed.
+    int num_colours;          ///< The number of colours available.
+    colouring_engine engine;  ///< The engine.
+    void *data;               ///< The data of the engine.
+    atomic_bool failed;       ///< Set when a piece has no colouring.
+} decomposition_shared;
+
+/**
+ * @brief A piece of the graph solved on its own: the subgraph induced by some nodes, and its colouring.
+ *
+ */
+typedef struct
+{
+    decomposition_shared *shared; ///< What the pieces share.
+    int *nodes;                   ///< The nodes of the piece (node i of the piece is nodes[i] in the graph).
+    int num_nodes;                ///< Their number.
+    int *colours;                 ///< The colour of each node of the piece, if result is 1.
+    int result;                   ///< What the engine returned (-1 if the piece was skipped).
+} decomposition_piece;
+
+/**
+ * @brief Task of the thread pool: solves the piece @p argument, a decomposition_piece, on its own subgraph.
+ *
+ * @param argument The piece.
+ * @param worker The index of the worker (unused).
+ */
+static void decomposition_task(void *argument, int worker)
+{
+    decomposition_piece *piece = (decomposition_piece *)argument;
+    decomposition_shared *shared = piece->shared;
+    piece->result = -1;
+    if (atomic_load(&shared->failed))
+        return;
+    Graph subgraph = graph_induced_subgraph(shared->graph, piece->nodes, piece->num_nodes);
+    ColouredGraph coloured = cg_initialize(subgraph);
+    piece->result = shared->engine(coloured, shared->num_colours, shared->data);
+    if (piece->result == 1)
+        for (int node = 0; node < piece->num_nodes; node++)
+            piece->colours[node] = cg_get_node_colour(coloured, node);
+    else if (piece->result == 0)
+        atomic_store(&shared->failed, true);
+    cg_delete(coloured);
+    graph_delete(subgraph);
+}
+
+/**
+ * @brief Compares two pieces by decreasing number of nodes, so that the largest ones start first.
+ *
+ * @param first A pointer to a decomposition_piece.
+ * @param second A pointer to a decomposition_piece.
+ * @return int The order.
+ */
+static int decomposition_compare_pieces(const void *first, const void *second)
+{
+    return (*(decomposition_piece *const *)second)->num_nodes - (*(decomposition_piece *const *)first)->num_nodes;
+}
+
+/**
+ * @brief Solves every piece of @p pieces on @p num_workers threads, the largest first. A piece of a single node gets colour 0 and a piece of two
+ *        nodes (an edge) colours 0 and 1, without calling the engine.
+ *
+ * @param shared What the pieces share.
+ * @param pieces The pieces.
+ * @param num_pieces Their number.
+ * @param num_workers The number of threads (0 for the number of processors).
+ * @return int 1 if every piece has a colouring, 0 if some piece has none, -1 if the engine could not decide for some piece.
+ */
+static int decomposition_solve(decomposition_shared *shared, decomposition_piece *pieces, int num_pieces, int num_workers)
+{
+    decomposition_piece **order = (decomposition_piece **)malloc((num_pieces + 1) * sizeof(decomposition_piece *));
+    int num_ordered = 0;
+    for (int i = 0; i < num_pieces; i++)
+    {
+        decomposition_piece *piece = &pieces[i];
+        piece->shared = shared;
+        if (piece->num_nodes > 2)
+        {
+            order[num_ordered++] = piece;
+            continue;
+        }
+        piece->result = piece->num_nodes <= shared->num_colours ? 1 : 0;
+        for (int node = 0; node < piece->num_nodes; node++)
+            piece->colours[node] = node;
+        if (piece->result == 0)
+            atomic_store(&shared->failed, true);
+    }
+    qsort(order, num_ordered, sizeof(decomposition_piece *), decomposition_compare_pieces);
+
+    if (num_workers <= 0)
+        num_workers = thread_pool_num_processors();
+    ThreadPool pool = thread_pool_create(num_workers < num_ordered ? num_workers : (num_ordered > 0 ? num_ordered : 1));
+    for (int i = 0; i < num_ordered; i++)
+        thread_pool_submit(pool, decomposition_task, order[i]);
+    thread_pool_delete(pool);
+    free(order);
+
+    if (atomic_load(&shared->failed))
+        return 0;
+    for (int i = 0; i < num_pieces; i++)
+        if (pieces[i].result != 1)
+            return -1;
+    return 1;
+}
+
+/**
+ * @brief Initialises @p shared for a decomposition of @p graph.
+ *
+ * @param shared What the pieces will share.
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @param engine The engine.
+ * @param data The data of the engine.
+ */
+static void decomposition_shared_init(decomposition_shared *shared, ColouredGraph graph, int num_colours, colouring_engine engine, void *data)
+{
+    shared->graph = cg_get_graph(graph);
+    shared->num_colours = num_colours;
+    shared->engine = engine;
+    shared->data = data;
+    atomic_init(&shared->failed, false);
+}
+
+int colouring_by_components(ColouredGraph graph, int num_colours, colouring_engine engine, void *data, int num_workers, int *num_components)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    int *component = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int count = graph_components(cg_get_graph(graph), component);
+    if (num_components != NULL)
+        *num_components = count;
+    if (count <= 1)
+    {
+        free(component);
+        return engine(graph, num_colours, data);
+    }
+
+    // The nodes of component c are nodes[start[c]] to nodes[start[c + 1] - 1].
+    int *start = (int *)calloc(count + 1, sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+        start[component[node] + 1]++;
+    for (int c = 0; c < count; c++)
+        start[c + 1] += start[c];
+    int *nodes = (int *)malloc(num_nodes * sizeof(int));
+    int *filled = (int *)calloc(count, sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+        nodes[start[component[node]] + filled[component[node]]++] = node;
+    int *colours = (int *)malloc(num_nodes * sizeof(int));
+
+    decomposition_shared shared;
+    decomposition_shared_init(&shared, graph, num_colours, engine, data);
+    decomposition_piece *pieces = (decomposition_piece *)malloc(count * sizeof(decomposition_piece));
+    for (int c = 0; c < count; c++)
+    {
+        pieces[c].nodes = nodes + start[c];
+        pieces[c].num_nodes = start[c + 1] - start[c];
+        pieces[c].colours = colours + start[c];
+        pieces[c].result = -1;
+    }
+    int result = decomposition_solve(&shared, pieces, count, num_workers);
+
+    for (int node = 0; node < num_nodes; node++)
+        cg_set_node_colour(graph, node, -1);
+    if (result == 1)
+        for (int i = 0; i < num_nodes; i++)
+            cg_set_node_colour(graph, nodes[i], colours[i]);
+
+    free(pieces);
+    free(colours);
+    free(filled);
+    free(nodes);
+    free(start);
+    free(component);
+    return result;
+}
+
+/**
+ * @brief The blocks of a graph, in the order Hopcroft and Tarjan's algorithm finds them: a block is found before the block of its first node.
+ *
+ */
+typedef struct
+{
+    int *nodes;      ///< The nodes of block b are nodes[start[b]] to nodes[start[b + 1] - 1], the first one being the node the search came from.
+    int *start;      ///< Where each block starts in nodes, start[num_blocks] being the total size.
+    int num_blocks;  ///< The number of blocks.
+} decomposition_blocks;
+
+/**
+ * @brief Computes the biconnected blocks of @p graph (the direction of edges being ignored) with an iterative version of Hopcroft and Tarjan's
+ *        depth-first search on adjacency lists. A node without neighbours is a block by itself.
+ *
+ * @param graph A ColouredGraph.
+ * @return decomposition_blocks The blocks, whose arrays are to be freed.
+ */
+static decomposition_blocks decomposition_find_blocks(ColouredGraph graph)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    const int *offsets = cg_get_adjacency(graph)->offsets;
+    const int *neighbours = cg_get_adjacency(graph)->neighbours;
+
+    int *discovery = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *low = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *parent = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *next = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *path = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *visited = (int *)malloc((num_nodes + 1) * sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+        discovery[node] = -1;
+
+    // There are at most as many blocks as nodes (each one ends with an edge of the search tree, or is a node alone), and each node is the first node
+    // of a block besides the block it was visited in: the blocks have at most twice as many nodes as the graph.
+    decomposition_blocks blocks;
+    blocks.nodes = (int *)malloc((2 * num_nodes + 1) * sizeof(int));
+    blocks.start = (int *)malloc((num_nodes + 1) * sizeof(int));
+    blocks.num_blocks = 0;
+    blocks.start[0] = 0;
+    int size = 0;
+    int time = 0;
+    for (int root = 0; root < num_nodes; root++)
+    {
+        if (discovery[root] >= 0)
+            continue;
+        discovery[root] = low[root] = time++;
+        parent[root] = -1;
+        next[root] = offsets[root];
+        if (offsets[root] == offsets[root + 1])
+        {
+            blocks.nodes[size++] = root;
+            blocks.start[++blocks.num_blocks] = size;
+            continue;
+        }
+        // path is the branch of the search being explored, visited the nodes discovered whose block is not complete yet.
+        int depth = 0, num_visited = 0;
+        path[depth++] = root;
+        visited[num_visited++] = root;
+        while (depth > 0)
+        {
+            int node = path[depth - 1];
+            if (next[node] < offsets[node + 1])
+            {
+                int neighbour = neighbours[next[node]++];
+                if (discovery[neighbour] < 0)
+                {
+                    discovery[neighbour] = low[neighbour] = time++;
+                    parent[neighbour] = node;
+                    next[neighbour] = offsets[neighbour];
+                    path[depth++] = neighbour;
+                    visited[num_visited++] = neighbour;
+                }
+                else if (neighbour != parent[node] && discovery[neighbour] < low[node])
+                    low[node] = discovery[neighbour];
+                continue;
+            }
+            depth--;
+            int up = parent[node];
+            if (up < 0)
+                continue;
+            if (low[node] < low[up])
+                low[up] = low[node];
+            if (low[node] >= discovery[up])
+            {
+                // up separates the subtree of node from the rest: they form a block with the nodes visited since node.
+                blocks.nodes[size++] = up;
+                int member;
+                do
+                {
+                    member = visited[--num_visited];
+                    blocks.nodes[size++] = member;
+                } while (member != node);
+                blocks.start[++blocks.num_blocks] = size;
+            }
+        }
+    }
+
+    free(discovery);
+    free(low);
+    free(parent);
+    free(next);
+    free(path);
+    free(visited);
+    return blocks;
+}
+
+int colouring_by_blocks(ColouredGraph graph, int num_colours, colouring_engine engine, void *data, int num_workers, int *num_blocks)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    decomposition_blocks blocks = decomposition_find_blocks(graph);
+    if (num_blocks != NULL)
+        *num_blocks = blocks.num_blocks;
+    if (blocks.num_blocks <= 1)
+    {
+        free(blocks.nodes);
+        free(blocks.start);
+        return engine(graph, num_colours, data);
+    }
+
+    int *colours = (int *)malloc((blocks.start[blocks.num_blocks] + 1) * sizeof(int));
+    decomposition_shared shared;
+    decomposition_shared_init(&shared, graph, num_colours, engine, data);
+    decomposition_piece *pieces = (decomposition_piece *)malloc(blocks.num_blocks * sizeof(decomposition_piece));
+    for (int b = 0; b < blocks.num_blocks; b++)
+    {
+        pieces[b].nodes = blocks.nodes + blocks.start[b];
+        pieces[b].num_nodes = blocks.start[b + 1] - blocks.start[b];
+        pieces[b].colours = colours + blocks.start[b];
+        pieces[b].result = -1;
+    }
+    int result = decomposition_solve(&shared, pieces, blocks.num_blocks, num_workers);
+
+    for (int node = 0; node < num_nodes; node++)
+        cg_set_node_colour(graph, node, -1);
+    // Blocks are stitched from the last one found: the first node of a block is then either coloured already (a cut node) or a root, and the
+    // others are not. Exchanging two colours in a block keeps it coloured, so its colours are swapped to agree with its first node.
+    for (int b = blocks.num_blocks - 1; b >= 0 && result == 1; b--)
+    {
+        decomposition_piece *piece = &pieces[b];
+        int from = piece->colours[0];
+        int to = cg_get_node_colour(graph, piece->nodes[0]);
+        if (to < 0)
+            to = from;
+        for (int i = 0; i < piece->num_nodes; i++)
+        {
+            int colour = piece->colours[i];
+            cg_set_node_colour(graph, piece->nodes[i], colour == from ? to : (colour == to ? from : colour));
+        }
+    }
+
+    free(pieces);
+    free(colours);
+    free(blocks.nodes);
+    free(blocks.start);
+    return result;
+}
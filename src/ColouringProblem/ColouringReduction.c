@@ -1,4 +1,5 @@
 #include "ColouringReduction.h"
+#include "ColouringResolution.h"
 #include "Z3Tools.h"
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -22,6 +23,118 @@ Z3_ast variable_node_color(Z3_context ctx, int node, int color)
     return mk_bool_var(ctx, name);
 }
 
+/**
+ * @brief Creates the variable of the order encoding stating that node @p node has a colour greater than @p colour.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param colour A colour.
+ * @return Z3_ast
+ */
+Z3_ast variable_node_above(Z3_context ctx, int node, int colour)
+{
+    char name[40];
+    snprintf(name, 40, "node %d, color > %d", node, colour);
+    return mk_bool_var(ctx, name);
+}
+
+/**
+ * @brief Creates the variable of the log encoding holding bit @p bit of the colour of node @p node.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param bit A bit index.
+ * @return Z3_ast
+ */
+Z3_ast variable_node_bit(Z3_context ctx, int node, int bit)
+{
+    char name[40];
+    snprintf(name, 40, "node %d, bit %d", node, bit);
+    return mk_bool_var(ctx, name);
+}
+
+/**
+ * @brief Returns the number of bits needed to write the colours 0 to @p num_colours - 1 (0 for a single colour).
+ *
+ * @param num_colours The number of colours.
+ * @return int
+ */
+static int colour_bits(int num_colours)
+{
+    int bits = 0;
+    while (bits < 30 && (1 << bits) < num_colours)
+        bits++;
+    return bits;
+}
+
+/**
+ * @brief Returns the width of the bit-vectors of the bit-vector encoding, large enough to write @p num_colours itself (the bound of Z3_mk_bvult),
+ *        and at least 1 (Z3 has no empty bit-vector).
+ *
+ * @param num_colours The number of colours.
+ * @return int
+ */
+static int colour_width(int num_colours)
+{
+    int bits = colour_bits(num_colours + 1);
+    return bits > 0 ? bits : 1;
+}
+
+/**
+ * @brief Creates the bit-vector constant of the bit-vector encoding holding the colour of node @p node.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param num_colours The number of colours.
+ * @return Z3_ast
+ */
+Z3_ast variable_node_colour_vector(Z3_context ctx, int node, int num_colours)
+{
+    char name[40];
+    snprintf(name, 40, "node %d, color", node);
+    return Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, name), Z3_mk_bv_sort(ctx, colour_width(num_colours)));
+}
+
+/**
+ * @brief Creates the formula stating that node @p node has colour @p colour in the encoding @p encoding.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param colour A colour, lower than @p num_colours.
+ * @param num_colours The expected number of colours.
+ * @param encoding The encoding of the colours.
+ * @return Z3_ast The formula.
+ */
+Z3_ast node_colour_formula(Z3_context ctx, int node, int colour, int num_colours, colouring_encoding encoding)
+{
+    switch (encoding)
+    {
+    case colouring_encoding_order:
+    {
+        // The colour is c when it is greater than c - 1 and not greater than c.
+        Z3_ast bounds[2];
+        int num_bounds = 0;
+        if (colour > 0)
+            bounds[num_bounds++] = variable_node_above(ctx, node, colour - 1);
+        if (colour < num_colours - 1)
+            bounds[num_bounds++] = Z3_mk_not(ctx, variable_node_above(ctx, node, colour));
+        return num_bounds > 0 ? Z3_mk_and(ctx, num_bounds, bounds) : Z3_mk_true(ctx);
+    }
+    case colouring_encoding_log:
+    {
+        int num_bits = colour_bits(num_colours);
+        Z3_ast bits[num_bits + 1];
+        for (int bit = 0; bit < num_bits; bit++)
+            bits[bit] = (colour >> bit) & 1 ? variable_node_bit(ctx, node, bit) : Z3_mk_not(ctx, variable_node_bit(ctx, node, bit));
+        return num_bits > 0 ? Z3_mk_and(ctx, num_bits, bits) : Z3_mk_true(ctx);
+    }
+    case colouring_encoding_bitvector:
+        return Z3_mk_eq(ctx, variable_node_colour_vector(ctx, node, num_colours), Z3_mk_unsigned_int(ctx, colour, Z3_mk_bv_sort(ctx, colour_width(num_colours))));
+    default:
+        return variable_node_color(ctx, node, colour);
+    }
+}
+
 /**
  * @brief Creates the formula stating that the edge (@p node1,@p node2) has its ends of different colours.
  * 
@@ -44,15 +157,70 @@ Z3_ast edge_formula(Z3_context ctx, int node1, int node2, int num_colours)
     return Z3_mk_and(ctx, num_colours, edge_diff);
 }
 
+/**
+ * @brief Same as edge_formula in the encoding @p encoding: with the order encoding, one clause of four literals per colour; with the log encoding,
+ *        some bit differs; with the bit-vector encoding, the two colours are distinct.
+ *
+ * @param ctx The solver context.
+ * @param node1 A node.
+ * @param node2 A node.
+ * @param num_colours The expected number of colours.
+ * @param encoding The encoding of the colours.
+ * @return Z3_ast The formula.
+ */
+Z3_ast encoded_edge_formula(Z3_context ctx, int node1, int node2, int num_colours, colouring_encoding encoding)
+{
+    switch (encoding)
+    {
+    case colouring_encoding_order:
+    {
+        Z3_ast edge_diff[num_colours + 1];
+        for (int colour = 0; colour < num_colours; colour++)
+        {
+            Z3_ast clause[4];
+            int size = 0;
+            if (colour > 0)
+            {
+                clause[size++] = Z3_mk_not(ctx, variable_node_above(ctx, node1, colour - 1));
+                clause[size++] = Z3_mk_not(ctx, variable_node_above(ctx, node2, colour - 1));
+            }
+            if (colour < num_colours - 1)
+            {
+                clause[size++] = variable_node_above(ctx, node1, colour);
+                clause[size++] = variable_node_above(ctx, node2, colour);
+            }
+            edge_diff[colour] = size > 0 ? Z3_mk_or(ctx, size, clause) : Z3_mk_false(ctx);
+        }
+        return num_colours > 0 ? Z3_mk_and(ctx, num_colours, edge_diff) : Z3_mk_true(ctx);
+    }
+    case colouring_encoding_log:
+    {
+        int num_bits = colour_bits(num_colours);
+        Z3_ast differences[num_bits + 1];
+        for (int bit = 0; bit < num_bits; bit++)
+            differences[bit] = Z3_mk_xor(ctx, variable_node_bit(ctx, node1, bit), variable_node_bit(ctx, node2, bit));
+        return num_bits > 0 ? Z3_mk_or(ctx, num_bits, differences) : Z3_mk_false(ctx);
+    }
+    case colouring_encoding_bitvector:
+    {
+        Z3_ast ends[2] = {variable_node_colour_vector(ctx, node1, num_colours), variable_node_colour_vector(ctx, node2, num_colours)};
+        return Z3_mk_distinct(ctx, 2, ends);
+    }
+    default:
+        return edge_formula(ctx, node1, node2, num_colours);
+    }
+}
+
 /**
  * @brief Creates the formula stating that all edges have their ends of different colours.
  * 
  * @param ctx The solver context.
  * @param graph A ColouredGraph.
  * @param num_colours The expected number of colours.
+ * @param encoding The encoding of the colours.
  * @return Z3_ast The formula.
  */
-Z3_ast edges_have_different_colours_formula(Z3_context ctx, const ColouredGraph graph, int num_colours)
+Z3_ast edges_have_different_colours_formula(Z3_context ctx, const ColouredGraph graph, int num_colours, colouring_encoding encoding)
 {
     int num_nodes = cg_get_num_nodes(graph);
     int current = 0;
@@ -63,23 +231,76 @@ Z3_ast edges_have_different_colours_formula(Z3_context ctx, const ColouredGraph
         {
             if (!cg_is_edge(graph, node1, node2))
                 continue;
-            edges_formula[current] = edge_formula(ctx, node1, node2, num_colours);
+            edges_formula[current] = encoded_edge_formula(ctx, node1, node2, num_colours, encoding);
             current++;
         }
     }
     return Z3_mk_and(ctx, current, edges_formula);
 }
 
+/**
+ * @brief Creates a formula stating that node @p node has exactly one colour in the encoding @p encoding (other than the direct one): with the order
+ *        encoding, "greater than c + 1" implies "greater than c"; with the log and bit-vector encodings, the codes from @p num_colours on are forbidden.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param num_colours The expected number of colours.
+ * @param encoding The encoding of the colours.
+ * @return Z3_ast The formula.
+ */
+Z3_ast encoded_node_formula(Z3_context ctx, int node, int num_colours, colouring_encoding encoding)
+{
+    if (num_colours <= 0)
+        return Z3_mk_false(ctx);
+    switch (encoding)
+    {
+    case colouring_encoding_order:
+    {
+        Z3_ast chain[num_colours + 1];
+        int size = 0;
+        for (int colour = 0; colour + 2 < num_colours; colour++)
+            chain[size++] = Z3_mk_implies(ctx, variable_node_above(ctx, node, colour + 1), variable_node_above(ctx, node, colour));
+        return size > 0 ? Z3_mk_and(ctx, size, chain) : Z3_mk_true(ctx);
+    }
+    case colouring_encoding_log:
+    {
+        // The code is lower than num_colours: below[b] states it on bits 0 to b, scanning from the lowest bit.
+        int num_bits = colour_bits(num_colours);
+        if ((1 << num_bits) == num_colours)
+            return Z3_mk_true(ctx);
+        Z3_ast below = Z3_mk_false(ctx);
+        for (int bit = 0; bit < num_bits; bit++)
+        {
+            Z3_ast cases[2] = {Z3_mk_not(ctx, variable_node_bit(ctx, node, bit)), below};
+            below = (num_colours >> bit) & 1 ? Z3_mk_or(ctx, 2, cases) : Z3_mk_and(ctx, 2, cases);
+        }
+        return below;
+    }
+    case colouring_encoding_bitvector:
+        return Z3_mk_bvult(ctx, variable_node_colour_vector(ctx, node, num_colours), Z3_mk_unsigned_int(ctx, num_colours, Z3_mk_bv_sort(ctx, colour_width(num_colours))));
+    default:
+        return Z3_mk_true(ctx);
+    }
+}
+
 /**
  * @brief Creates a formula stating that every node has exactly one colour.
  * 
  * @param ctx The solver context.
  * @param num_nodes The number of nodes.
  * @param num_colours The expected number of colours.
+ * @param encoding The encoding of the colours.
  * @return Z3_ast The formula.
  */
-Z3_ast each_node_has_one_colour_formula(Z3_context ctx, int num_nodes, int num_colours)
+Z3_ast each_node_has_one_colour_formula(Z3_context ctx, int num_nodes, int num_colours, colouring_encoding encoding)
 {
+    if (encoding != colouring_encoding_direct)
+    {
+        Z3_ast nodes_coloured[num_nodes + 1];
+        for (int node = 0; node < num_nodes; node++)
+            nodes_coloured[node] = encoded_node_formula(ctx, node, num_colours, encoding);
+        return num_nodes > 0 ? Z3_mk_and(ctx, num_nodes, nodes_coloured) : Z3_mk_true(ctx);
+    }
 
     Z3_ast nodes_coloured[num_nodes];
     for (int node = 0; node < num_nodes; node++)
@@ -94,23 +315,147 @@ Z3_ast each_node_has_one_colour_formula(Z3_context ctx, int num_nodes, int num_c
     return Z3_mk_and(ctx, num_nodes, nodes_coloured);
 }
 
+bool colouring_encoding_of_string(const char *name, colouring_encoding *encoding)
+{
+    if (strcmp(name, "direct") == 0)
+        *encoding = colouring_encoding_direct;
+    else if (strcmp(name, "order") == 0)
+        *encoding = colouring_encoding_order;
+    else if (strcmp(name, "log") == 0)
+        *encoding = colouring_encoding_log;
+    else if (strcmp(name, "bitvector") == 0)
+        *encoding = colouring_encoding_bitvector;
+    else
+        return false;
+    return true;
+}
+
+bool colouring_symmetry_of_string(const char *name, colouring_symmetry *symmetry)
+{
+    if (strcmp(name, "none") == 0)
+        *symmetry = colouring_symmetry_none;
+    else if (strcmp(name, "clique") == 0)
+        *symmetry = colouring_symmetry_clique;
+    else if (strcmp(name, "precedence") == 0)
+        *symmetry = colouring_symmetry_precedence;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief Creates the variable stating that some node has colour @p colour.
+ *
+ * @param ctx The solver context.
+ * @param colour A colour.
+ * @return Z3_ast
+ */
+Z3_ast variable_colour_used(Z3_context ctx, int colour)
+{
+    char name[40];
+    snprintf(name, 40, "color %d used", colour);
+    return mk_bool_var(ctx, name);
+}
+
+/**
+ * @brief Creates the symmetry breaking formula: the nodes of a clique found by colouring_greedy_clique get colours 0, 1, 2... (if the clique has more
+ *        nodes than colours, the first ones only, the edges of the clique making the formula unsatisfiable), and with colouring_symmetry_precedence,
+ *        a colour not used by the clique is used only if the previous one is.
+ *
+ * @param ctx The solver context.
+ * @param graph A ColouredGraph.
+ * @param num_colours The expected number of colours.
+ * @param symmetry The symmetry breaking.
+ * @param encoding The encoding of the colours.
+ * @return Z3_ast The formula.
+ */
+Z3_ast symmetry_breaking_formula(Z3_context ctx, const ColouredGraph graph, int num_colours, colouring_symmetry symmetry, colouring_encoding encoding)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    int clique[num_nodes + 1];
+    int size_clique = colouring_greedy_clique(graph, clique);
+    if (size_clique > num_colours)
+        size_clique = num_colours;
+    Z3_ast constraints[size_clique + 2 * num_colours + 1];
+    int num_constraints = 0;
+    for (int i = 0; i < size_clique; i++)
+        constraints[num_constraints++] = node_colour_formula(ctx, clique[i], i, num_colours, encoding);
+    if (symmetry == colouring_symmetry_precedence)
+    {
+        for (int colour = size_clique; colour < num_colours; colour++)
+        {
+            Z3_ast users[num_nodes + 1];
+            for (int node = 0; node < num_nodes; node++)
+                users[node] = node_colour_formula(ctx, node, colour, num_colours, encoding);
+            constraints[num_constraints++] = Z3_mk_eq(ctx, variable_colour_used(ctx, colour), num_nodes > 0 ? Z3_mk_or(ctx, num_nodes, users) : Z3_mk_false(ctx));
+            if (colour > size_clique)
+                constraints[num_constraints++] = Z3_mk_implies(ctx, variable_colour_used(ctx, colour), variable_colour_used(ctx, colour - 1));
+        }
+    }
+    return num_constraints > 0 ? Z3_mk_and(ctx, num_constraints, constraints) : Z3_mk_true(ctx);
+}
+
+Z3_ast colouring_reduction_encoded(Z3_context ctx, const ColouredGraph graph, int num_colours, colouring_symmetry symmetry, colouring_encoding encoding)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    Z3_ast result[3];
+    result[0] = edges_have_different_colours_formula(ctx, graph, num_colours, encoding);
+    result[1] = each_node_has_one_colour_formula(ctx, num_nodes, num_colours, encoding);
+    if (symmetry == colouring_symmetry_none)
+        return Z3_mk_and(ctx, 2, result);
+    result[2] = symmetry_breaking_formula(ctx, graph, num_colours, symmetry, encoding);
+    return Z3_mk_and(ctx, 3, result);
+}
+
+Z3_ast colouring_reduction_with_symmetry(Z3_context ctx, const ColouredGraph graph, int num_colours, colouring_symmetry symmetry)
+{
+    return colouring_reduction_encoded(ctx, graph, num_colours, symmetry, colouring_encoding_direct);
+}
+
 Z3_ast colouring_reduction(Z3_context ctx, const ColouredGraph graph, int num_colours)
+{
+    return colouring_reduction_with_symmetry(ctx, graph, num_colours, colouring_symmetry_clique);
+}
+
+Z3_ast colouring_reduction_up_to(Z3_context ctx, const ColouredGraph graph, int max_colours, colouring_symmetry symmetry)
 {
     int num_nodes = cg_get_num_nodes(graph);
-    Z3_ast result[2];
-    result[0] = edges_have_different_colours_formula(ctx, graph, num_colours);
-    result[1] = each_node_has_one_colour_formula(ctx, num_nodes, num_colours);
-    return Z3_mk_and(ctx, 2, result);
+    Z3_ast usages[max_colours + 1];
+    for (int colour = 0; colour < max_colours; colour++)
+    {
+        Z3_ast users[num_nodes + 1];
+        for (int node = 0; node < num_nodes; node++)
+            users[node] = Z3_mk_implies(ctx, variable_node_color(ctx, node, colour), variable_colour_used(ctx, colour));
+        usages[colour] = num_nodes > 0 ? Z3_mk_and(ctx, num_nodes, users) : Z3_mk_true(ctx);
+    }
+    usages[max_colours] = colouring_reduction_with_symmetry(ctx, graph, max_colours, symmetry);
+    return Z3_mk_and(ctx, max_colours + 1, usages);
+}
+
+int colouring_reduction_limit(Z3_context ctx, int num_colours, int max_colours, Z3_ast *assumptions)
+{
+    int num_assumptions = 0;
+    for (int colour = num_colours; colour < max_colours; colour++)
+        assumptions[num_assumptions++] = Z3_mk_not(ctx, variable_colour_used(ctx, colour));
+    return num_assumptions;
 }
 
-void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours)
+void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours, colouring_encoding encoding)
 {
     int num_nodes = cg_get_num_nodes(graph);
     for (int node = 0; node < num_nodes; node++)
     {
+        if (encoding == colouring_encoding_bitvector)
+        {
+            Z3_ast value;
+            unsigned colour;
+            if (Z3_model_eval(ctx, model, variable_node_colour_vector(ctx, node, num_colours), Z3_L_TRUE, &value) && Z3_get_numeral_uint(ctx, value, &colour))
+                cg_set_node_colour(graph, node, (int)colour);
+            continue;
+        }
         for (int colour = 0; colour < num_colours; colour++)
         {
-            if (value_of_var_in_model(ctx, model, variable_node_color(ctx, node, colour)))
+            if (value_of_var_in_model(ctx, model, node_colour_formula(ctx, node, colour, num_colours, encoding)))
             {
                 cg_set_node_colour(graph, node, colour);
                 break;
@@ -119,10 +464,10 @@ void colour_graph_from_model(Z3_context ctx, Z3_model model, ColouredGraph graph
     }
 }
 
-void colouring_print_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours)
+void colouring_print_model(Z3_context ctx, Z3_model model, ColouredGraph graph, int num_colours, colouring_encoding encoding)
 {
     int num_nodes = cg_get_num_nodes(graph);
     for (int node = 0; node < num_nodes; node++)
         for (int colour = 0; colour < num_colours; colour++)
-            printf("[%d:%d] = %d\n", node, colour, value_of_var_in_model(ctx, model, variable_node_color(ctx, node, colour)));
+            printf("[%d:%d] = %d\n", node, colour, value_of_var_in_model(ctx, model, node_colour_formula(ctx, node, colour, num_colours, encoding)));
 }
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "ColouringResolution.h"
+#include "ThreadPool.h"
+#include "Metrics.h"
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 /**
  * @brief Recursive implementation of a brute force. Performs a depth-first search of a colouring, and prunes branches as soon as an inconsistency is detected. As such, if a full colouring is reached, it is a correct one.
@@ -48,4 +53,666 @@ bool recursive_bf(ColouredGraph graph, int num_colours, int node)
 bool colouring_brute_force(ColouredGraph graph, int num_colours)
 {
     return recursive_bf(graph, num_colours, 0);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief The graph as read by DSATUR: the neighbours of each node in compressed form (an edge in either direction makes two nodes neighbours).
+ *
+ */
+typedef struct
+{
+    int num_nodes;         ///< The number of nodes.
+    int num_colours;       ///< The number of colours available.
+    int num_words;         ///< The number of 64-bit words of a domain.
+    const int *offsets;    ///< The neighbours of node are neighbours[offsets[node]] to neighbours[offsets[node + 1] - 1].
+    const int *neighbours; ///< The neighbours of all the nodes.
+} dsatur_graph;
+
+/**
+ * @brief A partial colouring explored by DSATUR, with what is needed to choose the next node and to detect failures.
+ *
+ */
+typedef struct
+{
+    const dsatur_graph *graph;    ///< The graph.
+    int *colours;                 ///< colours[node] is the colour of node, -1 if it is not coloured.
+    int *counts;                  ///< counts[node * num_colours + colour] is the number of neighbours of node coloured with colour.
+    unsigned long long *excluded; ///< Bit colour of excluded[node * num_words..] is set if a neighbour of node has colour (the complement of its domain).
+    int *saturation;              ///< saturation[node] is the number of bits set in the excluded colours of node.
+    int num_coloured;             ///< The number of coloured nodes.
+    int num_used;                 ///< The colours used are 0 to num_used - 1.
+    atomic_bool *stop;            ///< Set when the search must stop (a colouring was found by another worker).
+} dsatur_state;
+
+/**
+ * @brief Builds the DSATUR view of @p graph, on its adjacency (cg_get_adjacency).
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @return dsatur_graph The view, valid while @p graph is.
+ */
+static dsatur_graph dsatur_graph_create(ColouredGraph graph, int num_colours)
+{
+    const cg_adjacency *adjacency = cg_get_adjacency(graph);
+    dsatur_graph result;
+    result.num_nodes = adjacency->num_nodes;
+    result.num_colours = num_colours;
+    result.num_words = (num_colours + 63) / 64;
+    result.offsets = adjacency->offsets;
+    result.neighbours = adjacency->neighbours;
+    return result;
+}
+
+/**
+ * @brief Initialises @p state to the empty colouring of @p graph.
+ *
+ * @param state The state.
+ * @param graph The graph.
+ * @param stop The flag stopping the search.
+ */
+static void dsatur_state_init(dsatur_state *state, const dsatur_graph *graph, atomic_bool *stop)
+{
+    int num_nodes = graph->num_nodes;
+    state->graph = graph;
+    state->colours = (int *)malloc(num_nodes * sizeof(int));
+    state->counts = (int *)calloc((size_t)num_nodes * graph->num_colours + 1, sizeof(int));
+    state->excluded = (unsigned long long *)calloc((size_t)num_nodes * graph->num_words + 1, sizeof(unsigned long long));
+    state->saturation = (int *)calloc(num_nodes + 1, sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+        state->colours[node] = -1;
+    state->num_coloured = 0;
+    state->num_used = 0;
+    state->stop = stop;
+}
+
+/**
+ * @brief Frees the arrays of @p state.
+ *
+ * @param state
+ */
+static void dsatur_state_delete(dsatur_state *state)
+{
+    free(state->colours);
+    free(state->counts);
+    free(state->excluded);
+    free(state->saturation);
+}
+
+/**
+ * @brief Colours @p node with @p colour and removes @p colour from the domains of its neighbours.
+ *
+ * @param state The state.
+ * @param node An uncoloured node.
+ * @param colour A colour of its domain.
+ * @return true if every uncoloured neighbour still has a colour in its domain.
+ * @return false otherwise (the node is coloured anyway, dsatur_uncolour undoes it).
+ */
+static bool dsatur_colour(dsatur_state *state, int node, int colour)
+{
+    const dsatur_graph *graph = state->graph;
+    bool consistent = true;
+    state->colours[node] = colour;
+    state->num_coloured++;
+    for (int k = graph->offsets[node]; k < graph->offsets[node + 1]; k++)
+    {
+        int neighbour = graph->neighbours[k];
+        if (state->counts[neighbour * graph->num_colours + colour]++ == 0)
+        {
+            state->excluded[neighbour * graph->num_words + colour / 64] |= 1ULL << (colour % 64);
+            state->saturation[neighbour]++;
+            if (state->saturation[neighbour] == graph->num_colours && state->colours[neighbour] < 0)
+                consistent = false;
+        }
+    }
+    return consistent;
+}
+
+/**
+ * @brief Undoes dsatur_colour(@p state, @p node, @p colour).
+ *
+ * @param state The state.
+ * @param node The node.
+ * @param colour Its colour.
+ */
+static void dsatur_uncolour(dsatur_state *state, int node, int colour)
+{
+    const dsatur_graph *graph = state->graph;
+    state->colours[node] = -1;
+    state->num_coloured--;
+    for (int k = graph->offsets[node]; k < graph->offsets[node + 1]; k++)
+    {
+        int neighbour = graph->neighbours[k];
+        if (--state->counts[neighbour * graph->num_colours + colour] == 0)
+        {
+            state->excluded[neighbour * graph->num_words + colour / 64] &= ~(1ULL << (colour % 64));
+            state->saturation[neighbour]--;
+        }
+    }
+}
+
+/**
+ * @brief Returns the uncoloured node of largest saturation degree, ties broken by largest degree, then by smallest index.
+ *
+ * @param state The state.
+ * @return int The node.
+ * @pre Some node is not coloured.
+ */
+static int dsatur_select(const dsatur_state *state)
+{
+    const dsatur_graph *graph = state->graph;
+    int best = -1;
+    for (int node = 0; node < graph->num_nodes; node++)
+    {
+        if (state->colours[node] >= 0)
+            continue;
+        if (best < 0 || state->saturation[node] > state->saturation[best] ||
+            (state->saturation[node] == state->saturation[best] && graph->offsets[node + 1] - graph->offsets[node] > graph->offsets[best + 1] - graph->offsets[best]))
+            best = node;
+    }
+    return best;
+}
+
+/**
+ * @brief Tells if @p colour is in the domain of @p node.
+ *
+ * @param state The state.
+ * @param node A node.
+ * @param colour A colour.
+ * @return true if no neighbour of @p node has colour @p colour.
+ * @return false otherwise.
+ */
+static bool dsatur_allowed(const dsatur_state *state, int node, int colour)
+{
+    return !(state->excluded[node * state->graph->num_words + colour / 64] & (1ULL << (colour % 64)));
+}
+
+/**
+ * @brief Returns the number of colours worth trying for the next node: the colours used so far and a single new one, as all the unused colours are
+ *        interchangeable.
+ *
+ * @param state The state.
+ * @return int The colours to try are 0 to this number - 1.
+ */
+static int dsatur_num_candidates(const dsatur_state *state)
+{
+    return state->num_used < state->graph->num_colours ? state->num_used + 1 : state->graph->num_colours;
+}
+
+/**
+ * @brief Depth-first DSATUR search completing the colouring of @p state.
+ *
+ * @param state The state, whose colouring is consistent.
+ * @return true if the colouring could be completed (it is then in @p state).
+ * @return false otherwise, or if the search was stopped (@p state is then as it was).
+ */
+static bool dsatur_search(dsatur_state *state)
+{
+    if (state->num_coloured == state->graph->num_nodes)
+        return true;
+    if (atomic_load(state->stop))
+        return false;
+    int node = dsatur_select(state);
+    int num_used = state->num_used;
+    int num_candidates = dsatur_num_candidates(state);
+    for (int colour = 0; colour < num_candidates; colour++)
+    {
+        if (!dsatur_allowed(state, node, colour))
+            continue;
+        if (colour == num_used)
+            state->num_used = num_used + 1;
+        if (dsatur_colour(state, node, colour) && dsatur_search(state))
+            return true;
+        dsatur_uncolour(state, node, colour);
+        state->num_used = num_used;
+    }
+    return false;
+}
+
+/**
+ * @brief Number of subtrees per worker the first levels of the search are split into, so that workers finishing early find more work.
+ *
+ */
+#define DsaturSubtreesPerWorker 8
+
+/**
+ * @brief Enumerates the consistent partial colourings made by the first @p depth choices of dsatur_search, each stored as @p depth pairs (node, colour)
+ *        at the end of @p subtrees.
+ *
+ * @param state The state (as it was at the return, unless a full colouring is found).
+ * @param depth The number of choices of each subtree.
+ * @param prefix The choices made so far (2 * @p depth ints).
+ * @param length The number of choices made so far.
+ * @param subtrees The array of subtrees, reallocated as needed.
+ * @param num_subtrees The number of subtrees in @p subtrees.
+ * @param capacity The number of subtrees @p subtrees can contain.
+ * @return true if a full colouring was reached before @p depth choices (it is then in @p state).
+ * @return false otherwise.
+ */
+static bool dsatur_split(dsatur_state *state, int depth, int *prefix, int length, int **subtrees, int *num_subtrees, int *capacity)
+{
+    if (state->num_coloured == state->graph->num_nodes)
+        return true;
+    if (length == depth)
+    {
+        if (*num_subtrees == *capacity)
+        {
+            *capacity = 2 * *capacity + 16;
+            *subtrees = (int *)realloc(*subtrees, (size_t)*capacity * 2 * depth * sizeof(int));
+        }
+        memcpy(*subtrees + (size_t)*num_subtrees * 2 * depth, prefix, 2 * depth * sizeof(int));
+        (*num_subtrees)++;
+        return false;
+    }
+    int node = dsatur_select(state);
+    int num_used = state->num_used;
+    int num_candidates = dsatur_num_candidates(state);
+    for (int colour = 0; colour < num_candidates; colour++)
+    {
+        if (!dsatur_allowed(state, node, colour))
+            continue;
+        if (colour == num_used)
+            state->num_used = num_used + 1;
+        prefix[2 * length] = node;
+        prefix[2 * length + 1] = colour;
+        if (dsatur_colour(state, node, colour) && dsatur_split(state, depth, prefix, length + 1, subtrees, num_subtrees, capacity))
+            return true;
+        dsatur_uncolour(state, node, colour);
+        state->num_used = num_used;
+    }
+    return false;
+}
+
+/**
+ * @brief What the workers of a parallel DSATUR search share.
+ *
+ */
+typedef struct
+{
+    const dsatur_graph *graph; ///< The graph.
+    int depth;                 ///< The number of choices of each subtree.
+    atomic_bool *stop;         ///< Set when a colouring is found (or when the caller stops the search).
+    pthread_mutex_t lock;      ///< Protects colours and found.
+    int *colours;              ///< The colouring found.
+    bool found;                ///< Set when colours contains a colouring.
+} dsatur_shared;
+
+/**
+ * @brief A subtree of a parallel DSATUR search, the argument of dsatur_task.
+ *
+ */
+typedef struct
+{
+    dsatur_shared *shared; ///< What the workers share.
+    const int *prefix;     ///< The choices leading to the subtree (depth pairs (node, colour)).
+} dsatur_job;
+
+/**
+ * @brief Task of the thread pool: searches a colouring in the subtree of @p argument, a dsatur_job.
+ *
+ * @param argument The job.
+ * @param worker The index of the worker (unused).
+ */
+static void dsatur_task(void *argument, int worker)
+{
+    dsatur_job *job = (dsatur_job *)argument;
+    dsatur_shared *shared = job->shared;
+    if (atomic_load(shared->stop))
+        return;
+    dsatur_state state;
+    dsatur_state_init(&state, shared->graph, shared->stop);
+    for (int i = 0; i < shared->depth; i++)
+    {
+        int colour = job->prefix[2 * i + 1];
+        if (colour >= state.num_used)
+            state.num_used = colour + 1;
+        dsatur_colour(&state, job->prefix[2 * i], colour);
+    }
+    if (dsatur_search(&state))
+    {
+        pthread_mutex_lock(&shared->lock);
+        if (!shared->found)
+        {
+            memcpy(shared->colours, state.colours, shared->graph->num_nodes * sizeof(int));
+            shared->found = true;
+        }
+        atomic_store(shared->stop, true);
+        pthread_mutex_unlock(&shared->lock);
+    }
+    dsatur_state_delete(&state);
+}
+
+bool colouring_dsatur_until(ColouredGraph graph, int num_colours, int num_workers, atomic_bool *stop)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    for (int node = 0; node < num_nodes; node++)
+        cg_set_node_colour(graph, node, -1);
+    if (num_nodes == 0)
+        return true;
+    if (num_colours <= 0)
+        return false;
+    if (num_workers == 0)
+        num_workers = thread_pool_num_processors();
+
+    dsatur_graph view = dsatur_graph_create(graph, num_colours);
+    dsatur_shared shared;
+    shared.graph = &view;
+    shared.stop = stop;
+    pthread_mutex_init(&shared.lock, NULL);
+    shared.colours = (int *)malloc(num_nodes * sizeof(int));
+    shared.found = false;
+    dsatur_state state;
+    dsatur_state_init(&state, &view, stop);
+
+    if (num_workers <= 1)
+    {
+        shared.found = dsatur_search(&state);
+        if (shared.found)
+            memcpy(shared.colours, state.colours, num_nodes * sizeof(int));
+    }
+    else
+    {
+        // Splits deeper and deeper until there are enough subtrees for the workers (or the search is over).
+        int *subtrees = NULL;
+        int num_subtrees = 0, capacity = 0, depth = 0;
+        int prefix[2 * num_nodes];
+        do
+        {
+            depth++;
+            // The subtrees of the previous depth are narrower: the array is rebuilt.
+            free(subtrees);
+            subtrees = NULL;
+            num_subtrees = 0;
+            capacity = 0;
+            shared.found = dsatur_split(&state, depth, prefix, 0, &subtrees, &num_subtrees, &capacity);
+        } while (!shared.found && num_subtrees > 0 && num_subtrees < DsaturSubtreesPerWorker * num_workers && depth < num_nodes);
+
+        if (!shared.found && num_subtrees > 0)
+        {
+            shared.depth = depth;
+            dsatur_job *jobs = (dsatur_job *)malloc(num_subtrees * sizeof(dsatur_job));
+            ThreadPool pool = thread_pool_create(num_workers);
+            for (int i = 0; i < num_subtrees; i++)
+            {
+                jobs[i].shared = &shared;
+                jobs[i].prefix = subtrees + (size_t)i * 2 * depth;
+                thread_pool_submit(pool, dsatur_task, &jobs[i]);
+            }
+            thread_pool_delete(pool);
+            free(jobs);
+        }
+        else if (shared.found)
+            memcpy(shared.colours, state.colours, num_nodes * sizeof(int));
+        free(subtrees);
+    }
+
+    if (shared.found)
+        for (int node = 0; node < num_nodes; node++)
+            cg_set_node_colour(graph, node, shared.colours[node]);
+    bool found = shared.found;
+    dsatur_state_delete(&state);
+    free(shared.colours);
+    pthread_mutex_destroy(&shared.lock);
+    return found;
+}
+
+bool colouring_dsatur(ColouredGraph graph, int num_colours, int num_workers)
+{
+    atomic_bool stop;
+    atomic_init(&stop, false);
+    return colouring_dsatur_until(graph, num_colours, num_workers, &stop);
+}
+
+int colouring_greedy_clique(ColouredGraph graph, int *clique)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    if (num_nodes == 0)
+        return 0;
+    const cg_adjacency *adjacency = cg_get_adjacency(graph);
+    bool *adjacent = (bool *)calloc((size_t)num_nodes * num_nodes, sizeof(bool));
+    int *degree = (int *)malloc(num_nodes * sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+    {
+        degree[node] = adjacency->offsets[node + 1] - adjacency->offsets[node];
+        for (int k = adjacency->offsets[node]; k < adjacency->offsets[node + 1]; k++)
+            adjacent[node * num_nodes + adjacency->neighbours[k]] = true;
+    }
+    int *order = (int *)malloc(num_nodes * sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+        order[node] = node;
+    // Insertion sort by decreasing degree (stable, so ties keep the order of the nodes).
+    for (int i = 1; i < num_nodes; i++)
+        for (int j = i; j > 0 && degree[order[j]] > degree[order[j - 1]]; j--)
+        {
+            int swap = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = swap;
+        }
+
+    int best = 0;
+    int *current = (int *)malloc(num_nodes * sizeof(int));
+    int *candidates = (int *)malloc(num_nodes * sizeof(int));
+    for (int i = 0; i < num_nodes && degree[order[i]] + 1 > best; i++)
+    {
+        int start = order[i];
+        int size = 0, num_candidates = 0;
+        current[size++] = start;
+        for (int k = adjacency->offsets[start]; k < adjacency->offsets[start + 1]; k++)
+            candidates[num_candidates++] = adjacency->neighbours[k];
+        while (num_candidates > 0 && size + num_candidates > best)
+        {
+            int chosen = 0;
+            for (int k = 1; k < num_candidates; k++)
+                if (degree[candidates[k]] > degree[candidates[chosen]])
+                    chosen = k;
+            int node = candidates[chosen];
+            current[size++] = node;
+            int kept = 0;
+            for (int k = 0; k < num_candidates; k++)
+                if (adjacent[node * num_nodes + candidates[k]])
+                    candidates[kept++] = candidates[k];
+            num_candidates = kept;
+        }
+        if (size > best)
+        {
+            best = size;
+            memcpy(clique, current, size * sizeof(int));
+        }
+    }
+    free(adjacent);
+    free(degree);
+    free(order);
+    free(current);
+    free(candidates);
+    return best;
+}
+
+int colouring_greedy(ColouredGraph graph)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    if (num_nodes == 0)
+        return 0;
+    const int *offsets = cg_get_adjacency(graph)->offsets;
+    const int *neighbours = cg_get_adjacency(graph)->neighbours;
+    // seen[node * num_nodes + colour] tells if a neighbour of node has colour (a node never needs more colours than the number of nodes).
+    bool *seen = (bool *)calloc((size_t)num_nodes * num_nodes, sizeof(bool));
+    int *saturation = (int *)calloc(num_nodes, sizeof(int));
+    for (int node = 0; node < num_nodes; node++)
+        cg_set_node_colour(graph, node, -1);
+
+    int num_used = 0;
+    for (int step = 0; step < num_nodes; step++)
+    {
+        int node = -1;
+        for (int other = 0; other < num_nodes; other++)
+            if (cg_get_node_colour(graph, other) < 0 &&
+                (node < 0 || saturation[other] > saturation[node] ||
+                 (saturation[other] == saturation[node] && offsets[other + 1] - offsets[other] > offsets[node + 1] - offsets[node])))
+                node = other;
+        int colour = 0;
+        while (seen[node * num_nodes + colour])
+            colour++;
+        cg_set_node_colour(graph, node, colour);
+        if (colour >= num_used)
+            num_used = colour + 1;
+        for (int k = offsets[node]; k < offsets[node + 1]; k++)
+        {
+            int other = neighbours[k];
+            if (!seen[other * num_nodes + colour])
+            {
+                seen[other * num_nodes + colour] = true;
+                saturation[other]++;
+            }
+        }
+    }
+    free(seen);
+    free(saturation);
+    return num_used;
+}
+
+/**
+ * @brief Number of nodes of the search tree between two checks of the time budget of colouring_max_clique.
+ *
+ */
+#define CliqueCheckPeriod 1024
+
+/**
+ * @brief The branch and bound of colouring_max_clique. Sets of nodes are bitsets of num_words 64-bit words.
+ *
+ */
+typedef struct
+{
+    int num_nodes;                ///< The number of nodes.
+    int num_words;                ///< The number of words of a set of nodes.
+    unsigned long long *adjacent; ///< The neighbours of node are the set adjacent[node * num_words..].
+    int *current;                 ///< The clique being built.
+    int size;                     ///< Its size.
+    int *best;                    ///< The largest clique found.
+    int best_size;                ///< Its size.
+    int target;                   ///< The search stops when best_size reaches it.
+    double seconds;               ///< The time budget.
+    time_point start;             ///< When the search started.
+    long num_calls;               ///< The number of nodes of the search tree explored.
+    bool timeout;                 ///< Set when the budget is exhausted.
+} clique_search;
+
+/**
+ * @brief Extends the clique of @p search with the nodes of @p candidates, all adjacent to its nodes. The candidates are first coloured greedily,
+ *        colour classes being independent sets: a clique takes at most one node per class, so the number of classes bounds what can be added,
+ *        and the candidates are tried from the last class on, pruning as soon as the bound cannot beat the best clique.
+ *
+ * @param search The search.
+ * @param candidates The candidates (modified).
+ */
+static void clique_expand(clique_search *search, unsigned long long *candidates)
+{
+    if (search->best_size >= search->target || search->timeout)
+        return;
+    if (++search->num_calls % CliqueCheckPeriod == 0 && time_elapsed(search->start) >= search->seconds)
+    {
+        search->timeout = true;
+        return;
+    }
+    int num_words = search->num_words;
+    int *order = (int *)malloc(search->num_nodes * sizeof(int));
+    int *bound = (int *)malloc(search->num_nodes * sizeof(int));
+    unsigned long long *uncoloured = (unsigned long long *)malloc(3 * num_words * sizeof(unsigned long long));
+    unsigned long long *colour_class = uncoloured + num_words;
+    unsigned long long *next = uncoloured + 2 * num_words;
+    memcpy(uncoloured, candidates, num_words * sizeof(unsigned long long));
+    int num_ordered = 0, colour = 0;
+    for (int word = 0; word < num_words; word++)
+        while (uncoloured[word] != 0)
+        {
+            colour++;
+            memcpy(colour_class, uncoloured, num_words * sizeof(unsigned long long));
+            for (int w = word; w < num_words; w++)
+                while (colour_class[w] != 0)
+                {
+                    int node = w * 64 + __builtin_ctzll(colour_class[w]);
+                    uncoloured[w] &= ~(1ULL << (node % 64));
+                    for (int other = w; other < num_words; other++)
+                        colour_class[other] &= ~search->adjacent[node * num_words + other];
+                    colour_class[w] &= ~(1ULL << (node % 64));
+                    order[num_ordered] = node;
+                    bound[num_ordered++] = colour;
+                }
+        }
+
+    for (int i = num_ordered - 1; i >= 0 && search->size + bound[i] > search->best_size; i--)
+    {
+        int node = order[i];
+        search->current[search->size++] = node;
+        bool empty = true;
+        for (int w = 0; w < num_words; w++)
+        {
+            next[w] = candidates[w] & search->adjacent[node * num_words + w];
+            empty = empty && next[w] == 0;
+        }
+        if (empty)
+        {
+            if (search->size > search->best_size)
+            {
+                search->best_size = search->size;
+                memcpy(search->best, search->current, search->size * sizeof(int));
+            }
+        }
+        else
+        {
+            // next is reused by the recursive call: it gets its own copy.
+            unsigned long long *subset = (unsigned long long *)malloc(num_words * sizeof(unsigned long long));
+            memcpy(subset, next, num_words * sizeof(unsigned long long));
+            clique_expand(search, subset);
+            free(subset);
+        }
+        search->size--;
+        candidates[node / 64] &= ~(1ULL << (node % 64));
+        if (search->best_size >= search->target || search->timeout)
+            break;
+    }
+    free(order);
+    free(bound);
+    free(uncoloured);
+}
+
+int colouring_max_clique(ColouredGraph graph, int *clique, int target, double seconds, bool *maximum)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    int size = colouring_greedy_clique(graph, clique);
+    if (maximum != NULL)
+        *maximum = num_nodes == 0;
+    if (size >= target || seconds <= 0 || num_nodes == 0)
+        return size;
+
+    clique_search search;
+    search.num_nodes = num_nodes;
+    search.num_words = (num_nodes + 63) / 64;
+    search.adjacent = (unsigned long long *)calloc((size_t)num_nodes * search.num_words, sizeof(unsigned long long));
+    const cg_adjacency *adjacency = cg_get_adjacency(graph);
+    for (int node = 0; node < num_nodes; node++)
+        for (int k = adjacency->offsets[node]; k < adjacency->offsets[node + 1]; k++)
+        {
+            int other = adjacency->neighbours[k];
+            search.adjacent[node * search.num_words + other / 64] |= 1ULL << (other % 64);
+        }
+    search.current = (int *)malloc(num_nodes * sizeof(int));
+    search.size = 0;
+    search.best = clique;
+    search.best_size = size;
+    search.target = target;
+    search.seconds = seconds;
+    search.start = time_now();
+    search.num_calls = 0;
+    search.timeout = false;
+    unsigned long long *candidates = (unsigned long long *)malloc(search.num_words * sizeof(unsigned long long));
+    for (int word = 0; word < search.num_words; word++)
+        candidates[word] = 0;
+    for (int node = 0; node < num_nodes; node++)
+        candidates[node / 64] |= 1ULL << (node % 64);
+    clique_expand(&search, candidates);
+    if (maximum != NULL)
+        *maximum = !search.timeout && search.best_size < target;
+    free(candidates);
+    free(search.current);
+    free(search.adjacent);
+    return search.best_size;
+}
@@ -0,0 +1,282 @@
+#include "ColouringTabu.h"
+#include "ColouringResolution.h"
+#include "Metrics.h"
+#include "Random.h"
+#include "Memory.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/**
+ * @brief Number of iterations between two checks of the time budget and of the stop flag.
+ *
+ */
+#define TabuCheckPeriod 1024
+
+/**
+ * @brief The graph as TabuCol sees it: the neighbours of each node in a flat array.
+ *
+ */
+typedef struct
+{
+    int num_nodes;         ///< The number of nodes.
+    int num_colours;       ///< The number of colours available.
+    const int *offsets;    ///< The neighbours of node are neighbours[offsets[node]] to neighbours[offsets[node + 1] - 1].
+    const int *neighbours; ///< The neighbours of all the nodes (without the node itself).
+} tabu_graph;
+
+/**
+ * @brief Builds the TabuCol view of @p graph, on its adjacency (cg_get_adjacency). Two nodes are neighbours if there is an edge in either direction.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours available.
+ * @return tabu_graph The view, valid while @p graph is.
+ */
+static tabu_graph tabu_graph_create(ColouredGraph graph, int num_colours)
+{
+    const cg_adjacency *adjacency = cg_get_adjacency(graph);
+    tabu_graph result;
+    result.num_nodes = adjacency->num_nodes;
+    result.num_colours = num_colours;
+    result.offsets = adjacency->offsets;
+    result.neighbours = adjacency->neighbours;
+    return result;
+}
+
+/**
+ * @brief The colouring explored by TabuCol.
+ *
+ */
+typedef struct
+{
+    const tabu_graph *graph; ///< The graph.
+    int *colours;            ///< colours[node] is the colour of node.
+    int *conflicts;          ///< conflicts[node * num_colours + colour] is the number of neighbours of node coloured with colour.
+    long *tabu;              ///< Giving colour to node is tabu until iteration tabu[node * num_colours + colour].
+    int *conflicting;        ///< The nodes having a neighbour of their colour.
+    int *position;           ///< position[node] is the index of node in conflicting, -1 if it is not in conflict.
+    int num_conflicting;     ///< The number of nodes in conflict.
+    int num_conflicts;       ///< The number of edges whose ends have the same colour.
+} tabu_state;
+
+/**
+ * @brief Adds @p node to the nodes in conflict, or removes it, so that it is there if and only if it has a neighbour of its colour.
+ *
+ * @param state The state.
+ * @param node A node.
+ */
+static void tabu_update_conflicting(tabu_state *state, int node)
+{
+    bool in_conflict = state->conflicts[node * state->graph->num_colours + state->colours[node]] > 0;
+    if (in_conflict && state->position[node] < 0)
+    {
+        state->position[node] = state->num_conflicting;
+        state->conflicting[state->num_conflicting++] = node;
+    }
+    else if (!in_conflict && state->position[node] >= 0)
+    {
+        int last = state->conflicting[--state->num_conflicting];
+        state->conflicting[state->position[node]] = last;
+        state->position[last] = state->position[node];
+        state->position[node] = -1;
+    }
+}
+
+/**
+ * @brief Gives colour @p colour to @p node, updating the conflicts of its neighbours.
+ *
+ * @param state The state.
+ * @param node A node.
+ * @param colour Its new colour.
+ */
+static void tabu_move(tabu_state *state, int node, int colour)
+{
+    const tabu_graph *graph = state->graph;
+    int num_colours = graph->num_colours;
+    int previous = state->colours[node];
+    state->num_conflicts += state->conflicts[node * num_colours + colour] - state->conflicts[node * num_colours + previous];
+    state->colours[node] = colour;
+    for (int k = graph->offsets[node]; k < graph->offsets[node + 1]; k++)
+    {
+        int neighbour = graph->neighbours[k];
+        state->conflicts[neighbour * num_colours + previous]--;
+        state->conflicts[neighbour * num_colours + colour]++;
+        if (state->colours[neighbour] == previous || state->colours[neighbour] == colour)
+            tabu_update_conflicting(state, neighbour);
+    }
+    tabu_update_conflicting(state, node);
+}
+
+/**
+ * @brief TabuCol search. Each iteration makes the non-tabu move (a node in conflict and another colour) removing the most conflicts, ties broken at
+ *        random; a tabu move is allowed if it leads to fewer conflicts than ever seen. The previous colour of the node moved becomes tabu for
+ *        0.6 times the number of nodes in conflict plus a random number of iterations between 1 and 10.
+ *
+ * @param graph The graph.
+ * @param seconds The time budget.
+ * @param seed The seed of the random choices.
+ * @param stop The search also stops when it is set.
+ * @param colours Array to return the colouring found.
+ * @return true if a colouring was found.
+ * @return false if the search stopped before.
+ * @pre @p colours must be an array of size at least the number of nodes.
+ */
+static bool tabu_search(const tabu_graph *graph, double seconds, unsigned long long seed, atomic_bool *stop, int *colours)
+{
+    int num_nodes = graph->num_nodes;
+    int num_colours = graph->num_colours;
+    if (num_nodes == 0)
+        return true;
+    if (num_colours <= 0)
+        return false;
+    random_generator generator;
+    random_seed(&generator, seed);
+    tabu_state state;
+    state.graph = graph;
+    state.colours = colours;
+    state.conflicts = (int *)calloc((size_t)num_nodes * num_colours, sizeof(int));
+    state.tabu = (long *)calloc((size_t)num_nodes * num_colours, sizeof(long));
+    state.conflicting = (int *)malloc(num_nodes * sizeof(int));
+    state.position = (int *)malloc(num_nodes * sizeof(int));
+    state.num_conflicting = 0;
+    state.num_conflicts = 0;
+    for (int node = 0; node < num_nodes; node++)
+        colours[node] = random_int(&generator, num_colours);
+    for (int node = 0; node < num_nodes; node++)
+    {
+        state.position[node] = -1;
+        for (int k = graph->offsets[node]; k < graph->offsets[node + 1]; k++)
+            state.conflicts[node * num_colours + colours[graph->neighbours[k]]]++;
+        state.num_conflicts += state.conflicts[node * num_colours + colours[node]];
+    }
+    state.num_conflicts /= 2;
+    for (int node = 0; node < num_nodes; node++)
+        tabu_update_conflicting(&state, node);
+
+    int best = state.num_conflicts;
+    time_point start = time_now();
+    for (long iteration = 0; state.num_conflicts > 0; iteration++)
+    {
+        if (iteration % TabuCheckPeriod == 0 && (atomic_load(stop) || time_elapsed(start) >= seconds))
+            break;
+        int best_delta = INT_MAX, moved = -1, new_colour = -1, num_ties = 0;
+        for (int i = 0; i < state.num_conflicting; i++)
+        {
+            int node = state.conflicting[i];
+            const int *conflicts = state.conflicts + node * num_colours;
+            for (int colour = 0; colour < num_colours; colour++)
+            {
+                if (colour == colours[node])
+                    continue;
+                int delta = conflicts[colour] - conflicts[colours[node]];
+                if (state.tabu[node * num_colours + colour] > iteration && state.num_conflicts + delta >= best)
+                    continue;
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    num_ties = 1;
+                    moved = node;
+                    new_colour = colour;
+                }
+                else if (delta == best_delta && random_int(&generator, ++num_ties) == 0)
+                {
+                    moved = node;
+                    new_colour = colour;
+                }
+            }
+        }
+        if (moved < 0)
+        {
+            // Every move is tabu: a random one is made.
+            if (num_colours == 1)
+                break;
+            moved = state.conflicting[random_int(&generator, state.num_conflicting)];
+            new_colour = (colours[moved] + 1 + random_int(&generator, num_colours - 1)) % num_colours;
+        }
+        int previous = colours[moved];
+        tabu_move(&state, moved, new_colour);
+        state.tabu[moved * num_colours + previous] = iteration + (long)(0.6 * state.num_conflicting) + 1 + random_int(&generator, 10);
+        if (state.num_conflicts < best)
+            best = state.num_conflicts;
+    }
+
+    bool found = state.num_conflicts == 0;
+    free(state.conflicts);
+    free(state.tabu);
+    free(state.conflicting);
+    free(state.position);
+    return found;
+}
+
+bool colouring_tabu(ColouredGraph graph, int num_colours, double seconds, unsigned long long seed)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    tabu_graph view = tabu_graph_create(graph, num_colours);
+    atomic_bool stop;
+    atomic_init(&stop, false);
+    int *colours = (int *)malloc((num_nodes + 1) * sizeof(int));
+    bool found = tabu_search(&view, seconds, seed, &stop, colours);
+    for (int node = 0; node < num_nodes; node++)
+        cg_set_node_colour(graph, node, found ? colours[node] : -1);
+    free(colours);
+    return found;
+}
+
+/**
+ * @brief The TabuCol side of colouring_race.
+ *
+ */
+typedef struct
+{
+    const tabu_graph *graph; ///< The graph.
+    double seconds;          ///< The time budget.
+    unsigned long long seed; ///< The seed.
+    atomic_bool *stop;       ///< Shared with DSATUR.
+    int *colours;            ///< The colouring found.
+    bool found;              ///< Whether colours is a colouring.
+} tabu_racer;
+
+/**
+ * @brief Thread running TabuCol for colouring_race, stopping DSATUR if it finds a colouring.
+ *
+ * @param argument A tabu_racer.
+ * @return void* NULL.
+ */
+static void *tabu_race_thread(void *argument)
+{
+    tabu_racer *racer = (tabu_racer *)argument;
+    racer->found = tabu_search(racer->graph, racer->seconds, racer->seed, racer->stop, racer->colours);
+    if (racer->found)
+        atomic_store(racer->stop, true);
+    return NULL;
+}
+
+bool colouring_race(ColouredGraph graph, int num_colours, int num_workers, double seconds, unsigned long long seed, bool *by_tabu)
+{
+    int num_nodes = cg_get_num_nodes(graph);
+    tabu_graph view = tabu_graph_create(graph, num_colours);
+    atomic_bool stop;
+    atomic_init(&stop, false);
+    tabu_racer racer = {&view, seconds, seed, &stop, (int *)malloc((num_nodes + 1) * sizeof(int)), false};
+    pthread_t thread;
+    memory_concurrency_begin();
+    pthread_create(&thread, NULL, tabu_race_thread, &racer);
+    // DSATUR returns false either because there is no colouring, or because TabuCol found one and stopped it.
+    bool found = colouring_dsatur_until(graph, num_colours, num_workers, &stop);
+    atomic_store(&stop, true);
+    pthread_join(thread, NULL);
+    memory_concurrency_end();
+    bool from_tabu = !found && racer.found;
+    if (from_tabu)
+    {
+        found = true;
+        for (int node = 0; node < num_nodes; node++)
+            cg_set_node_colour(graph, node, racer.colours[node]);
+    }
+    if (by_tabu != NULL)
+        *by_tabu = from_tabu;
+    free(racer.colours);
+    return found;
+}
@@ -2,9 +2,119 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+/**
+ * @brief The state of the depth-first search: the current stack, the (node, height) pairs already visited and the path built so far.
+ *
+ */
+typedef struct
+{
+    TunnelNetwork network;   ///< The network.
+    const tn_compiled *view; ///< The compiled view of the network.
+    int length;              ///< The exact length of the path sought.
+    int stack_size;          ///< Number of cells of the stack (same bound as the reduction).
+    int *stack;              ///< The stack: stack[0..height] contains 4 or 6.
+    bool *visited;           ///< visited[node * stack_size + height] is true if (node, height) is on the current path.
+    tn_step *path;           ///< The path built so far.
+} bf_search;
+
+/**
+ * @brief Tells if @p action can be performed on a stack of height @p height whose top is @p top, and computes the resulting height and top.
+ *
+ * @param search The search.
+ * @param action An action.
+ * @param height The current height.
+ * @param new_height Will contain the height after the action.
+ * @param pushed Will contain the symbol pushed (for push actions).
+ * @return true if @p action is possible.
+ * @return false otherwise.
+ */
+bool bf_apply_action(bf_search *search, stack_action action, int height, int *new_height, int *pushed)
+{
+    int top = search->stack[height];
+    switch (action)
+    {
+    case transmit_4:
+    case transmit_6:
+        *new_height = height;
+        return top == (action == transmit_4 ? 4 : 6);
+    case push_4_4:
+    case push_4_6:
+    case push_6_4:
+    case push_6_6:
+        *new_height = height + 1;
+        *pushed = (action == push_4_6 || action == push_6_6) ? 6 : 4;
+        return height + 1 < search->stack_size && top == ((action == push_4_4 || action == push_4_6) ? 4 : 6);
+    default:
+        // pop_B_T removes the top T and reveals B.
+        *new_height = height - 1;
+        return height > 0 && top == ((action == pop_4_6 || action == pop_6_6) ? 6 : 4) && search->stack[height - 1] == ((action == pop_4_4 || action == pop_4_6) ? 4 : 6);
+    }
+}
+
+/**
+ * @brief Recursive depth-first search of a simple path of exactly @p search->length steps ending at the final node with stack [4].
+ *
+ * @param search The search.
+ * @param node The current node.
+ * @param height The current height of the stack.
+ * @param pos The number of steps already done.
+ * @return true if the current path can be completed (it is then in @p search->path).
+ * @return false otherwise.
+ */
+bool bf_recursive(bf_search *search, int node, int height, int pos)
+{
+    if (pos == search->length)
+        return node == tn_get_final(search->network) && height == 0 && search->stack[0] == 4;
+    const tn_compiled *view = search->view;
+    // Only the actions of the node requiring the current top are tried.
+    int top = search->stack[height] == 4 ? 0 : 1;
+    for (int a = 0; a < view->num_by_top[top][node]; a++)
+    {
+        stack_action action = view->by_top[top][node * ActionsPerTop + a];
+        int new_height, pushed = 0;
+        if (!bf_apply_action(search, action, height, &new_height, &pushed))
+            continue;
+        int saved = search->stack[new_height];
+        if (new_height > height)
+            search->stack[new_height] = pushed;
+        for (int k = view->succ_offsets[node]; k < view->succ_offsets[node + 1]; k++)
+        {
+            int succ = view->succ[k];
+            if (search->visited[succ * search->stack_size + new_height])
+                continue;
+            search->visited[succ * search->stack_size + new_height] = true;
+            search->path[pos] = tn_step_create(action, node, succ);
+            bool found = bf_recursive(search, succ, new_height, pos + 1);
+            search->visited[succ * search->stack_size + new_height] = false;
+            if (found)
+                return true;
+        }
+        search->stack[new_height] = saved;
+    }
+    return false;
+}
+
 int tn_brute_force(TunnelNetwork network, int length, tn_step *path)
 {
-    /* Nous n’attendons pas que cette fonction soit implémentée pour la partie principale du projet.
-    Néanmoins, si vous voulez tester vos idée pour un brute-force, vous pouvez le faire ici, ou même simplement tester diverses choses sur une instance : cette fonction sera appelée si vous lancez le programme avec l’option -B, et le contenu de path sera affiché (de la taille de l’entier renvoyé). */
+    int num_nodes = tn_get_num_nodes(network);
+    for (int l = 1; l <= length; l++)
+    {
+        bf_search search;
+        search.network = network;
+        search.view = tn_compile(network);
+        search.length = l;
+        search.stack_size = l / 2 + 1;
+        search.stack = (int *)calloc(search.stack_size, sizeof(int));
+        search.visited = (bool *)calloc(num_nodes * search.stack_size, sizeof(bool));
+        search.path = path;
+        search.stack[0] = 4;
+        int initial = tn_get_initial(network);
+        search.visited[initial * search.stack_size] = true;
+        bool found = bf_recursive(&search, initial, 0, 0);
+        free(search.stack);
+        free(search.visited);
+        if (found)
+            return l;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,317 @@
+#include "TunnelCache.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Version of the format of the entries. Entries of another version are ignored.
+ *
+ */
+#define TN_CACHE_VERSION 2
+
+/**
+ * @brief Temporary files older than this (in seconds) are left over by a crash and removed.
+ *
+ */
+#define TN_CACHE_STALE_TEMPORARY 3600
+
+struct TunnelCache_s
+{
+    char *directory;  ///< The directory of the entries.
+    long max_bytes;   ///< The size limit of the entries.
+    long total_bytes; ///< The size of the entries, counted at opening and at each eviction, then updated by each store.
+};
+
+/**
+ * @brief An entry of the directory, for the eviction.
+ *
+ */
+typedef struct
+{
+    char *path;  ///< The path of the entry.
+    off_t size;  ///< Its size.
+    time_t used; ///< Its modification time (last store or hit).
+} tn_cache_file;
+
+/**
+ * @brief Compares two entries by last use, for qsort.
+ *
+ * @param first A tn_cache_file.
+ * @param second A tn_cache_file.
+ * @return int Negative if @p first was used before @p second.
+ */
+static int tn_cache_compare_use(const void *first, const void *second)
+{
+    time_t a = ((const tn_cache_file *)first)->used;
+    time_t b = ((const tn_cache_file *)second)->used;
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Removes the temporary files left over by crashes, then the least recently used entries until the cache is under its size limit, and
+ *        counts the size of the remaining entries. Reads the whole directory: only called at opening and when a store makes the count exceed the limit.
+ *
+ * @param cache
+ */
+static void tn_cache_evict(TunnelCache cache)
+{
+    DIR *directory = opendir(cache->directory);
+    if (directory == NULL)
+        return;
+    tn_cache_file *files = NULL;
+    int num_files = 0, capacity = 0;
+    long total = 0;
+    time_t now = time(NULL);
+    struct dirent *item;
+    while ((item = readdir(directory)) != NULL)
+    {
+        size_t name_length = strlen(item->d_name);
+        bool temporary = strncmp(item->d_name, ".tmp.", 5) == 0;
+        if (!temporary && (name_length < 4 || strcmp(item->d_name + name_length - 4, ".tnc") != 0))
+            continue;
+        size_t length = strlen(cache->directory) + name_length + 2;
+        char *path = (char *)malloc(length);
+        snprintf(path, length, "%s/%s", cache->directory, item->d_name);
+        struct stat st;
+        bool exists = stat(path, &st) == 0;
+        if (!exists || temporary)
+        {
+            if (exists && now - st.st_mtime > TN_CACHE_STALE_TEMPORARY)
+                unlink(path);
+            free(path);
+            continue;
+        }
+        if (num_files == capacity)
+        {
+            capacity = capacity == 0 ? 64 : 2 * capacity;
+            files = (tn_cache_file *)realloc(files, capacity * sizeof(tn_cache_file));
+        }
+        files[num_files].path = path;
+        files[num_files].size = st.st_size;
+        files[num_files].used = st.st_mtime;
+        num_files++;
+        total += st.st_size;
+    }
+    closedir(directory);
+
+    qsort(files, num_files, sizeof(tn_cache_file), tn_cache_compare_use);
+    for (int i = 0; i < num_files; i++)
+    {
+        if (total > cache->max_bytes && unlink(files[i].path) == 0)
+            total -= files[i].size;
+        free(files[i].path);
+    }
+    free(files);
+    __atomic_store_n(&cache->total_bytes, total, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Counter making the names of the temporary files of a process unique.
+ *
+ */
+static unsigned long temporary_counter = 0;
+
+TunnelCache tn_cache_open(const char *directory, long max_bytes)
+{
+    struct stat st = {0};
+    if (stat(directory, &st) == -1 && mkdir(directory, 0777) != 0)
+        return NULL;
+    if (stat(directory, &st) == -1 || !S_ISDIR(st.st_mode))
+        return NULL;
+    TunnelCache cache = (TunnelCache)malloc(sizeof(*cache));
+    cache->directory = strdup(directory);
+    cache->max_bytes = max_bytes;
+    cache->total_bytes = 0;
+    tn_cache_evict(cache);
+    return cache;
+}
+
+void tn_cache_close(TunnelCache cache)
+{
+    free(cache->directory);
+    free(cache);
+}
+
+/**
+ * @brief Writes the header of an entry, which contains its key but the bound, in @p file. The header is also what is hashed to name the entry:
+ *        the answers of all the bounds of a query share one entry.
+ *
+ * @param file A file.
+ * @param network The network.
+ * @param key A key.
+ */
+static void tn_cache_write_header(FILE *file, TunnelNetwork network, const tn_cache_key *key)
+{
+    fprintf(file, "TNCACHE\t%d\nfingerprint\t%016llx\nsource\t%s\ntarget\t%s\nengine\t%s\n", TN_CACHE_VERSION, key->fingerprint,
+            tn_get_node_name(network, key->source), tn_get_node_name(network, key->target), key->engine);
+}
+
+/**
+ * @brief Computes the path of the entry of @p key: the directory followed by the FNV-1a hash of the header of the entry.
+ *
+ * @param cache
+ * @param network The network.
+ * @param key A key.
+ * @param header Will contain the header (to be freed).
+ * @return char* The path of the entry (to be freed).
+ */
+static char *tn_cache_entry_path(TunnelCache cache, TunnelNetwork network, const tn_cache_key *key, char **header)
+{
+    size_t header_size;
+    FILE *buffer = open_memstream(header, &header_size);
+    tn_cache_write_header(buffer, network, key);
+    fclose(buffer);
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < header_size; i++)
+    {
+        hash ^= (unsigned char)(*header)[i];
+        hash *= 1099511628211ULL;
+    }
+    size_t length = strlen(cache->directory) + 22;
+    char *path = (char *)malloc(length);
+    snprintf(path, length, "%s/%016llx.tnc", cache->directory, hash);
+    return path;
+}
+
+/**
+ * @brief Reads the part of the entry @p file after its header.
+ *
+ * @param file The entry, after its header.
+ * @param network The network.
+ * @param key Its key (its bound is not used).
+ * @param length Will contain the size of the shortest path, or 0 if none was found.
+ * @param num_unsat Will contain the number of sizes, from 1, for which there is no path.
+ * @return tn_step* The path (to be freed), or NULL if the entry is not well-formed or its path is not a solution.
+ */
+static tn_step *tn_cache_read_answer(FILE *file, TunnelNetwork network, const tn_cache_key *key, int *length, int *num_unsat)
+{
+    char *line = NULL;
+    size_t capacity = 0;
+    bool valid = getline(&line, &capacity, file) != -1 && sscanf(line, "length\t%d", length) == 1 && *length >= 0;
+    valid = valid && getline(&line, &capacity, file) != -1 && sscanf(line, "unsat\t%d", num_unsat) == 1;
+    // The path found is the shortest one: every smaller size has no path.
+    valid = valid && (*length > 0 ? *num_unsat == *length - 1 : *num_unsat > 0);
+    tn_step *path = (tn_step *)malloc((valid ? *length + 1 : 1) * sizeof(tn_step));
+    for (int i = 0; valid && i < *length; i++)
+    {
+        valid = getline(&line, &capacity, file) != -1 && strncmp(line, "step\t", 5) == 0;
+        char *save;
+        char *source = valid ? strtok_r(line + 5, "\t\n", &save) : NULL;
+        char *action = source != NULL ? strtok_r(NULL, "\t\n", &save) : NULL;
+        char *target = action != NULL ? strtok_r(NULL, "\t\n", &save) : NULL;
+        valid = target != NULL;
+        if (valid)
+            path[i] = tn_step_create((stack_action)atoi(action), tn_get_node_from_name(network, source), tn_get_node_from_name(network, target));
+    }
+    free(line);
+    if (valid && (*length == 0 || tn_check_path(network, key->source, key->target, path, *length)))
+        return path;
+    free(path);
+    return NULL;
+}
+
+/**
+ * @brief Reads the entry of @p key, removing it if it is not valid.
+ *
+ * @param cache
+ * @param network The network.
+ * @param key The key of the entry.
+ * @param length Will contain the size of the shortest path, or 0 if none was found.
+ * @param num_unsat Will contain the number of sizes, from 1, for which there is no path.
+ * @return tn_step* The path (to be freed), or NULL if there is no valid entry.
+ */
+static tn_step *tn_cache_read_entry(TunnelCache cache, TunnelNetwork network, const tn_cache_key *key, int *length, int *num_unsat)
+{
+    char *header;
+    char *entry = tn_cache_entry_path(cache, network, key, &header);
+    FILE *file = fopen(entry, "r");
+    tn_step *path = NULL;
+    if (file != NULL)
+    {
+        size_t header_size = strlen(header);
+        char *read = (char *)malloc(header_size + 1);
+        if (fread(read, 1, header_size, file) == header_size && memcmp(read, header, header_size) == 0)
+            path = tn_cache_read_answer(file, network, key, length, num_unsat);
+        fclose(file);
+        if (path != NULL)
+            utime(entry, NULL); // Marks it as recently used.
+        else
+            unlink(entry);
+        free(read);
+    }
+    free(entry);
+    free(header);
+    return path;
+}
+
+bool tn_cache_lookup(TunnelCache cache, TunnelNetwork network, const tn_cache_key *key, int *length, tn_step *path, int *num_unsat)
+{
+    int stored_length = 0, stored_unsat = 0;
+    tn_step *stored_path = tn_cache_read_entry(cache, network, key, &stored_length, &stored_unsat);
+    if (stored_path == NULL)
+        stored_unsat = 0;
+    // The answer is known if the shortest path has been found (within the bound or not), or if there is none up to the bound.
+    bool known = stored_path != NULL && (stored_length > 0 || stored_unsat >= key->bound);
+    if (known)
+    {
+        *length = stored_length <= key->bound ? stored_length : 0;
+        memcpy(path, stored_path, *length * sizeof(tn_step));
+    }
+    if (num_unsat != NULL)
+        *num_unsat = stored_unsat < key->bound ? stored_unsat : key->bound;
+    free(stored_path);
+    return known;
+}
+
+void tn_cache_store(TunnelCache cache, TunnelNetwork network, const tn_cache_key *key, int length, tn_step *path)
+{
+    // An answer without path only tells that the sizes up to the bound have none: it must not replace an entry which knows more.
+    int stored_length, stored_unsat;
+    tn_step *stored_path = length == 0 ? tn_cache_read_entry(cache, network, key, &stored_length, &stored_unsat) : NULL;
+    bool known = stored_path != NULL && (stored_length > 0 || stored_unsat >= key->bound);
+    free(stored_path);
+    if (known)
+        return;
+
+    char *header;
+    char *entry = tn_cache_entry_path(cache, network, key, &header);
+    size_t temporary_length = strlen(cache->directory) + 64;
+    char temporary[temporary_length];
+    snprintf(temporary, temporary_length, "%s/.tmp.%ld.%lu", cache->directory, (long)getpid(), __atomic_add_fetch(&temporary_counter, 1, __ATOMIC_RELAXED));
+
+    FILE *file = fopen(temporary, "w");
+    if (file != NULL)
+    {
+        fputs(header, file);
+        fprintf(file, "length\t%d\nunsat\t%d\n", length, length > 0 ? length - 1 : key->bound);
+        for (int i = 0; i < length; i++)
+            fprintf(file, "step\t%s\t%d\t%s\n", tn_get_node_name(network, path[i].source), path[i].action, tn_get_node_name(network, path[i].target));
+        long size = ftell(file);
+        // The entry must be on disk before it gets its name, so that a crash leaves either the old entry or the new one, never a partial one.
+        bool written = fflush(file) == 0 && fsync(fileno(file)) == 0;
+        written = fclose(file) == 0 && written;
+        struct stat st;
+        long replaced = stat(entry, &st) == 0 ? st.st_size : 0;
+        if (written && rename(temporary, entry) == 0)
+        {
+            int directory = open(cache->directory, O_RDONLY);
+            if (directory >= 0)
+            {
+                fsync(directory);
+                close(directory);
+            }
+            if (__atomic_add_fetch(&cache->total_bytes, size - replaced, __ATOMIC_RELAXED) > cache->max_bytes)
+                tn_cache_evict(cache);
+        }
+        else
+            unlink(temporary);
+    }
+    free(entry);
+    free(header);
+}
@@ -1,4 +1,5 @@
 #include "TunnelNetwork.h"
+#include "Memory.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -12,6 +13,10 @@ struct TunnelNetwork_s
     int initial;       ///< The starting node of the network.
     int final;         ///< The target node of the network.
     int *node_actions; ///< The actions associated with nodes (uses a mask encoding).
+    bool *edges;       ///< edges[source * num_nodes + target] is true if the edge exists (a copy of the graph's, which can be changed).
+    int num_edges;     ///< The number of edges.
+    unsigned version;  ///< Incremented by each change of an edge or of the actions of a node.
+    tn_compiled *view; ///< The compiled view, NULL if it was never compiled (compiled again by tn_compile when its version is not the network's).
 };
 
 TunnelNetwork tn_initialize(Graph graph)
@@ -22,8 +27,18 @@ TunnelNetwork tn_initialize(Graph graph)
     result->node_actions = (int *)malloc(num_nodes * sizeof(int));
     result->initial = 0; // dummy value
     result->final = 0;   // dummy value
+    result->edges = (bool *)memory_malloc((size_t)num_nodes * num_nodes * sizeof(bool), MemoryGraph);
+    result->num_edges = 0;
+    result->version = 0;
+    for (int source = 0; source < num_nodes; source++)
+        for (int target = 0; target < num_nodes; target++)
+        {
+            result->edges[source * num_nodes + target] = graph_is_edge(graph, source, target);
+            result->num_edges += result->edges[source * num_nodes + target];
+        }
     for (int node = 0; node < num_nodes; node++)
     {
+        result->node_actions[node] = 0;
         char *param = parameter_list_get_value(graph_get_node_parameter(graph, node), "shape");
         if (param != NULL)
         {
@@ -40,7 +55,6 @@ TunnelNetwork tn_initialize(Graph graph)
         const char delim[] = "\\n\"";
         char *lex = NULL;
         char *token = strtok_r(work, delim, &lex);
-        result->node_actions[node] = 0;
         while (token != NULL)
         {
             if (strcmp(token, "4→4") == 0)
@@ -67,18 +81,70 @@ TunnelNetwork tn_initialize(Graph graph)
             token = strtok_r(NULL, delim, &lex);
         }
     }
-    // todo: fill node_actions.
-
+    // Compiled now so that concurrent readers of an unmodified network never compile it.
+    result->view = NULL;
+    tn_compile(result);
     return result;
 }
 
+/**
+ * @brief Frees @p view and its arrays (does nothing if it is NULL).
+ *
+ * @param view
+ */
+static void tn_free_view(tn_compiled *view)
+{
+    if (view == NULL)
+        return;
+    free(view->actions);
+    free(view->transmit);
+    free(view->push);
+    free(view->pop);
+    for (int top = 0; top < 2; top++)
+    {
+        free(view->num_by_top[top]);
+        free(view->by_top[top]);
+    }
+    free(view->succ_offsets);
+    free(view->succ);
+    free(view);
+}
+
 void tn_delete(TunnelNetwork network)
 {
+    tn_free_view(network->view);
+    memory_free(network->edges);
     free(network->node_actions);
     free(network);
     return;
 }
 
+bool tn_endpoints_subgraph(TunnelNetwork network, Graph *subgraph)
+{
+    int num_nodes = graph_num_nodes(network->graph);
+    if (num_nodes == 0)
+        return false;
+    int component[num_nodes];
+    graph_components(network->graph, component);
+    int kept[num_nodes];
+    int num_kept = 0;
+    for (int node = 0; node < num_nodes; node++)
+        if (component[node] == component[network->initial] || component[node] == component[network->final])
+            kept[num_kept++] = node;
+    if (num_kept == num_nodes)
+        return false;
+    *subgraph = graph_induced_subgraph(network->graph, kept, num_kept);
+    return true;
+}
+
+int tn_stack_action_of_string(const char *name)
+{
+    for (stack_action action = 0; action < NumActions; action++)
+        if (strcmp(tn_string_of_stack_action(action), name) == 0)
+            return action;
+    return -1;
+}
+
 char *tn_string_of_stack_action(stack_action action)
 {
     if (action == transmit_4)
@@ -131,12 +197,124 @@ int tn_get_num_nodes(TunnelNetwork network)
 
 int tn_get_num_edges(TunnelNetwork network)
 {
-    return graph_num_edges(network->graph);
+    return network->num_edges;
 }
 
 bool tn_is_edge(TunnelNetwork network, int source, int target)
 {
-    return graph_is_edge(network->graph, source, target);
+    return network->edges[source * tn_get_num_nodes(network) + target];
+}
+
+/**
+ * @brief Sets the existence of the edge (@p source, @p target) of @p network to @p exists.
+ *
+ * @param network
+ * @param source
+ * @param target
+ * @param exists
+ */
+static void tn_set_edge(TunnelNetwork network, int source, int target, bool exists)
+{
+    bool *edge = &network->edges[source * tn_get_num_nodes(network) + target];
+    if (*edge == exists)
+        return;
+    *edge = exists;
+    network->num_edges += exists ? 1 : -1;
+    network->version++;
+}
+
+void tn_add_edge(TunnelNetwork network, int source, int target)
+{
+    tn_set_edge(network, source, target, true);
+}
+
+void tn_remove_edge(TunnelNetwork network, int source, int target)
+{
+    tn_set_edge(network, source, target, false);
+}
+
+int tn_get_edge_cost(TunnelNetwork network, int source, int target)
+{
+    parameterList *parameters = graph_get_edge_parameter(network->graph, source, target);
+    char *value = parameter_list_get_value(parameters, "cost");
+    if (value == NULL)
+        value = parameter_list_get_value(parameters, "weight");
+    if (value == NULL)
+        return 1;
+    if (*value == '"')
+        value++;
+    int cost = atoi(value);
+    return cost < 0 ? 0 : cost;
+}
+
+int tn_get_node_actions(TunnelNetwork network, int node)
+{
+    return network->node_actions[node];
+}
+
+void tn_set_node_actions(TunnelNetwork network, int node, int actions)
+{
+    if (network->node_actions[node] == actions)
+        return;
+    network->node_actions[node] = actions;
+    network->version++;
+}
+
+unsigned tn_get_version(TunnelNetwork network)
+{
+    return network->version;
+}
+
+const tn_compiled *tn_compile(TunnelNetwork network)
+{
+    if (network->view != NULL && network->view->version == network->version)
+        return network->view;
+    tn_free_view(network->view);
+    int num_nodes = tn_get_num_nodes(network);
+    tn_compiled *view = (tn_compiled *)malloc(sizeof(*view));
+    view->num_nodes = num_nodes;
+    view->num_edges = network->num_edges;
+    view->version = network->version;
+    view->edges = network->edges;
+    view->actions = (int *)malloc(num_nodes * sizeof(int));
+    view->transmit = (int *)malloc(num_nodes * sizeof(int));
+    view->push = (int *)malloc(num_nodes * sizeof(int));
+    view->pop = (int *)malloc(num_nodes * sizeof(int));
+    // The protocol each action requires on top of the stack (pop_B_T requires T).
+    const int top_of_action[NumActions] = {4, 6, 4, 4, 6, 6, 4, 6, 4, 6};
+    for (int top = 0; top < 2; top++)
+    {
+        view->num_by_top[top] = (int *)calloc(num_nodes, sizeof(int));
+        view->by_top[top] = (stack_action *)malloc((size_t)num_nodes * ActionsPerTop * sizeof(stack_action));
+    }
+    for (int node = 0; node < num_nodes; node++)
+    {
+        int actions = network->node_actions[node];
+        view->actions[node] = actions;
+        view->transmit[node] = actions & TransmitActions;
+        view->push[node] = actions & PushActions;
+        view->pop[node] = actions & PopActions;
+        for (stack_action action = 0; action < NumActions; action++)
+            if (actions & (1 << action))
+            {
+                int top = top_of_action[action] == 4 ? 0 : 1;
+                view->by_top[top][node * ActionsPerTop + view->num_by_top[top][node]++] = action;
+            }
+    }
+
+    view->succ_offsets = (int *)calloc(num_nodes + 1, sizeof(int));
+    view->succ = (int *)malloc((network->num_edges + 1) * sizeof(int));
+    // Filled in increasing order of source then target, so that each list is sorted.
+    int num_succ = 0;
+    for (int source = 0; source < num_nodes; source++)
+    {
+        for (int target = 0; target < num_nodes; target++)
+            if (network->edges[source * num_nodes + target])
+                view->succ[num_succ++] = target;
+        view->succ_offsets[source + 1] = num_succ;
+    }
+    network->view = view;
+    return view;
 }
 
 char *tn_get_node_name(TunnelNetwork network, int node)
@@ -144,6 +322,15 @@ char *tn_get_node_name(TunnelNetwork network, int node)
     return graph_get_node_name(network->graph, node);
 }
 
+int tn_get_node_from_name(TunnelNetwork network, const char *name)
+{
+    int num_nodes = tn_get_num_nodes(network);
+    for (int node = 0; node < num_nodes; node++)
+        if (strcmp(tn_get_node_name(network, node), name) == 0)
+            return node;
+    return -1;
+}
+
 bool tn_node_has_action(TunnelNetwork network, int node, stack_action action)
 {
     return (((1 << action) & network->node_actions[node]) != 0);
@@ -175,16 +362,52 @@ char *tn_get_name(TunnelNetwork network)
 }
 
 void tn_print_path(TunnelNetwork network, tn_step *path, int size_path)
+{
+    tn_fprint_path(stdout, network, path, size_path);
+}
+
+void tn_fprint_path(FILE *file, TunnelNetwork network, tn_step *path, int size_path)
 {
     for (int i = 0; i < size_path; i++)
     {
-        printf("%s -(%s)-> ", tn_get_node_name(network, path[i].source), tn_string_of_stack_action(path[i].action));
+        fprintf(file, "%s -(%s)-> ", tn_get_node_name(network, path[i].source), tn_string_of_stack_action(path[i].action));
     }
-    printf("%s", tn_get_node_name(network, path[size_path - 1].target));
-    printf("\n");
+    fprintf(file, "%s", tn_get_node_name(network, path[size_path - 1].target));
+    fprintf(file, "\n");
     return;
 }
 
+/**
+ * @brief Writes the nodes (with their current actions as label) and the current edges of @p network in dot format in @p file.
+ *
+ * @param network
+ * @param file
+ */
+static void tn_fill_dot_content(TunnelNetwork network, FILE *file)
+{
+    int num_nodes = tn_get_num_nodes(network);
+    for (int node = 0; node < num_nodes; node++)
+    {
+        fprintf(file, "%s[", tn_get_node_name(network, node));
+        for (parameterList *param = graph_get_node_parameter(network->graph, node); param != NULL; param = param->next)
+            if (strcmp(param->name, "label") != 0)
+                fprintf(file, "%s=%s,", param->name, param->value);
+        fprintf(file, "label=\"");
+        bool first = true;
+        for (stack_action action = 0; action < NumActions; action++)
+            if (tn_node_has_action(network, node, action))
+            {
+                fprintf(file, "%s%s", first ? "" : "\\n", tn_string_of_stack_action(action));
+                first = false;
+            }
+        fprintf(file, "\"];\n");
+    }
+    for (int node = 0; node < num_nodes; node++)
+        for (int node2 = 0; node2 < num_nodes; node2++)
+            if (tn_is_edge(network, node, node2))
+                fprintf(file, "%s -> %s;\n", tn_get_node_name(network, node), tn_get_node_name(network, node2));
+}
+
 void tn_create_dot(TunnelNetwork network, tn_step *path, int size_path, char *name)
 {
 
@@ -210,7 +433,7 @@ void tn_create_dot(TunnelNetwork network, tn_step *path, int size_path, char *na
         fprintf(file, "digraph %s{\n", name);
     }
 
-    digraph_fill_dot_content(network->graph, file);
+    tn_fill_dot_content(network, file);
 
     for (int i = 0; i < size_path; i++)
     {
@@ -233,4 +456,117 @@ tn_step tn_step_create(stack_action action, int source, int target)
 tn_step tn_step_empty()
 {
     return tn_step_create(transmit_4, 0, 0);
-}
\ No newline at end of file
+}
+
+bool tn_check_path(TunnelNetwork network, int source, int target, tn_step *path, int size_path)
+{
+    if (size_path < 1 || path[0].source != source || path[size_path - 1].target != target)
+        return false;
+    int num_nodes = tn_get_num_nodes(network);
+    int stack_size = size_path / 2 + 1;
+    int stack[stack_size];
+    bool *visited = (bool *)calloc(num_nodes * stack_size, sizeof(bool));
+    int height = 0;
+    stack[0] = 4;
+    visited[source * stack_size] = true;
+    bool valid = true;
+    for (int i = 0; i < size_path && valid; i++)
+    {
+        int node = path[i].source;
+        int succ = path[i].target;
+        stack_action action = path[i].action;
+        if (node < 0 || node >= num_nodes || succ < 0 || succ >= num_nodes || action < 0 || action >= NumActions || (i > 0 && node != path[i - 1].target) ||
+            !tn_node_has_action(network, node, action) || !tn_is_edge(network, node, succ))
+        {
+            valid = false;
+            break;
+        }
+        int top = stack[height];
+        switch (action)
+        {
+        case transmit_4:
+        case transmit_6:
+            valid = top == (action == transmit_4 ? 4 : 6);
+            break;
+        case push_4_4:
+        case push_4_6:
+        case push_6_4:
+        case push_6_6:
+            valid = height + 1 < stack_size && top == ((action == push_4_4 || action == push_4_6) ? 4 : 6);
+            if (valid)
+                stack[++height] = (action == push_4_6 || action == push_6_6) ? 6 : 4;
+            break;
+        default:
+            // pop_B_T removes the top T and reveals B.
+            valid = height > 0 && top == ((action == pop_4_6 || action == pop_6_6) ? 6 : 4) && stack[height - 1] == ((action == pop_4_4 || action == pop_4_6) ? 4 : 6);
+            if (valid)
+                height--;
+            break;
+        }
+        if (valid)
+        {
+            valid = !visited[succ * stack_size + height];
+            visited[succ * stack_size + height] = true;
+        }
+    }
+    free(visited);
+    return valid && height == 0;
+}
+
+/**
+ * @brief Adds the @p size bytes of @p data to the FNV-1a hash @p hash.
+ *
+ * @param hash The hash so far.
+ * @param data The bytes.
+ * @param size Their number.
+ * @return unsigned long long The new hash.
+ */
+static unsigned long long tn_fnv1a(unsigned long long hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compares the names of two nodes, for qsort.
+ *
+ * @param first A pointer to the name of a node.
+ * @param second A pointer to the name of a node.
+ * @return int The order of the names.
+ */
+static int tn_compare_names(const void *first, const void *second)
+{
+    return strcmp(*(char *const *)first, *(char *const *)second);
+}
+
+unsigned long long tn_fingerprint(TunnelNetwork network)
+{
+    int num_nodes = tn_get_num_nodes(network);
+    char **names = (char **)malloc(num_nodes * sizeof(char *));
+    for (int node = 0; node < num_nodes; node++)
+        names[node] = tn_get_node_name(network, node);
+    qsort(names, num_nodes, sizeof(char *), tn_compare_names);
+    int *order = (int *)malloc(num_nodes * sizeof(int));
+    for (int rank = 0; rank < num_nodes; rank++)
+        order[rank] = tn_get_node_from_name(network, names[rank]);
+
+    unsigned long long hash = tn_fnv1a(14695981039346656037ULL, &num_nodes, sizeof(num_nodes));
+    for (int rank = 0; rank < num_nodes; rank++)
+    {
+        int node = order[rank];
+        hash = tn_fnv1a(hash, names[rank], strlen(names[rank]) + 1);
+        hash = tn_fnv1a(hash, &network->node_actions[node], sizeof(int));
+        for (int succ_rank = 0; succ_rank < num_nodes; succ_rank++)
+            if (tn_is_edge(network, node, order[succ_rank]))
+                hash = tn_fnv1a(hash, &succ_rank, sizeof(succ_rank));
+        hash = tn_fnv1a(hash, &num_nodes, sizeof(num_nodes));
+    }
+    free(order);
+    free(names);
+    return hash;
+}
@@ -0,0 +1,157 @@
+#include "TunnelOptimize.h"
+#include "TunnelReduction.h"
+#include "Z3Tools.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool tn_objective_of_string(const char *text, tn_objective *objective)
+{
+    objective->hops = 0;
+    objective->push = 0;
+    objective->edges = 0;
+    char work[strlen(text) + 1];
+    strcpy(work, text);
+    char *save;
+    for (char *term = strtok_r(work, ",", &save); term != NULL; term = strtok_r(NULL, ",", &save))
+    {
+        int weight = 1;
+        char *equal = strchr(term, '=');
+        if (equal != NULL)
+        {
+            *equal = '\0';
+            char *end;
+            weight = (int)strtol(equal + 1, &end, 10);
+            if (*end != '\0' || end == equal + 1 || weight < 0)
+                return false;
+        }
+        if (strcmp(term, "hops") == 0)
+            objective->hops = weight;
+        else if (strcmp(term, "push") == 0)
+            objective->push = weight;
+        else if (strcmp(term, "cost") == 0)
+            objective->edges = weight;
+        else
+            return false;
+    }
+    return true;
+}
+
+long tn_objective_value(TunnelNetwork network, tn_objective objective, tn_step *path, int size_path)
+{
+    long value = 0;
+    for (int i = 0; i < size_path; i++)
+    {
+        value += objective.hops;
+        if (path[i].action >= push_4_4 && path[i].action <= push_6_6)
+            value += objective.push;
+        value += (long)objective.edges * tn_get_edge_cost(network, path[i].source, path[i].target);
+    }
+    return value;
+}
+
+/**
+ * @brief Returns the formula "the path is on @p node at position @p pos" (whatever the height of the stack).
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param pos The path position.
+ * @param stack_size The number of cells of the stack.
+ * @return Z3_ast
+ */
+static Z3_ast tn_at_node(Z3_context ctx, int node, int pos, int stack_size)
+{
+    Z3_ast heights[stack_size];
+    for (int h = 0; h < stack_size; h++)
+        heights[h] = tn_path_variable(ctx, node, pos, h);
+    return Z3_mk_or(ctx, stack_size, heights);
+}
+
+/**
+ * @brief Returns the formula "the stack has height @p height at position @p pos" (whatever the node).
+ *
+ * @param ctx The solver context.
+ * @param num_nodes The number of nodes.
+ * @param pos The path position.
+ * @param height A height.
+ * @return Z3_ast
+ */
+static Z3_ast tn_at_height(Z3_context ctx, int num_nodes, int pos, int height)
+{
+    Z3_ast nodes[num_nodes];
+    for (int node = 0; node < num_nodes; node++)
+        nodes[node] = tn_path_variable(ctx, node, pos, height);
+    return Z3_mk_or(ctx, num_nodes, nodes);
+}
+
+/**
+ * @brief Adds to @p optimize the soft constraint @p formula with weight @p weight (nothing if the weight is 0).
+ *
+ * @param ctx The solver context.
+ * @param optimize The optimiser.
+ * @param formula The formula which should hold.
+ * @param weight The cost of violating it.
+ */
+static void tn_assert_soft(Z3_context ctx, Z3_optimize optimize, Z3_ast formula, long weight)
+{
+    if (weight <= 0)
+        return;
+    char text[24];
+    snprintf(text, sizeof(text), "%ld", weight);
+    Z3_optimize_assert_soft(ctx, optimize, formula, text, Z3_mk_string_symbol(ctx, "cost"));
+}
+
+Z3_lbool tn_optimize(Z3_context ctx, TunnelNetwork network, int source, int target, int bound, tn_objective objective, tn_step *path, int *size_path)
+{
+    const tn_compiled *view = tn_compile(network);
+    int num_nodes = view->num_nodes;
+    int stack_size = get_stack_size(bound);
+    Z3_optimize optimize = Z3_mk_optimize(ctx);
+    Z3_optimize_inc_ref(ctx, optimize);
+    Z3_optimize_assert(ctx, optimize, tn_reduction_up_to(ctx, network, bound));
+    Z3_ast endpoints[2];
+    tn_reduction_endpoints(ctx, source, target, bound, endpoints);
+    Z3_optimize_assert(ctx, optimize, Z3_mk_and(ctx, 2, endpoints));
+
+    for (int i = 0; i < bound; i++)
+    {
+        Z3_ast done = tn_done_variable(ctx, i);
+        // A step is paid for unless the path has already ended.
+        tn_assert_soft(ctx, optimize, done, objective.hops);
+        if (objective.push > 0)
+        {
+            Z3_ast pushes[stack_size];
+            for (int h = 0; h + 1 < stack_size; h++)
+                pushes[h] = Z3_mk_and(ctx, 2, (Z3_ast[]){tn_at_height(ctx, num_nodes, i, h), tn_at_height(ctx, num_nodes, i + 1, h + 1)});
+            if (stack_size > 1)
+                tn_assert_soft(ctx, optimize, Z3_mk_not(ctx, Z3_mk_or(ctx, stack_size - 1, pushes)), objective.push);
+        }
+        for (int node = 0; node < num_nodes && objective.edges > 0; node++)
+            for (int k = view->succ_offsets[node]; k < view->succ_offsets[node + 1]; k++)
+            {
+                int next = view->succ[k];
+                Z3_ast used = Z3_mk_and(ctx, 3, (Z3_ast[]){Z3_mk_not(ctx, done), tn_at_node(ctx, node, i, stack_size), tn_at_node(ctx, next, i + 1, stack_size)});
+                tn_assert_soft(ctx, optimize, Z3_mk_not(ctx, used), (long)objective.edges * tn_get_edge_cost(network, node, next));
+            }
+    }
+
+    Z3_lbool result = Z3_optimize_check(ctx, optimize, 0, NULL);
+    if (result == Z3_L_TRUE)
+    {
+        Z3_model model = Z3_optimize_get_model(ctx, optimize);
+        Z3_model_inc_ref(ctx, model);
+        *size_path = tn_get_length_from_model(ctx, model, bound);
+        tn_get_path_from_model(ctx, model, network, *size_path, path);
+        Z3_model_dec_ref(ctx, model);
+    }
+    Z3_optimize_dec_ref(ctx, optimize);
+    return result;
+}
+
+int tn_shortest_up_to(Z3_context ctx, TunnelNetwork network, int source, int target, int bound, tn_step *path)
+{
+    tn_objective hops = {1, 0, 0};
+    int size_path = 0;
+    Z3_lbool result = tn_optimize(ctx, network, source, target, bound, hops, path, &size_path);
+    return result == Z3_L_TRUE ? size_path : (result == Z3_L_FALSE ? 0 : -1);
+}
@@ -0,0 +1,216 @@
+#include "TunnelQuery.h"
+#include "TunnelReduction.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct TunnelQuery_s
+{
+    Z3_context ctx;        ///< The solver context.
+    TunnelNetwork network; ///< The network.
+    Z3Session *sessions;   ///< sessions[l] contains the formula for length l (NULL if not built yet).
+    int capacity;          ///< Allocated size of sessions.
+    int num_sessions;      ///< Number of sessions built.
+    bool mutable;          ///< If true, the sessions contain tn_reduction_guarded and the edges and actions are assumptions.
+    int *support_offsets;  ///< In mutable mode, the edges encoded by the sessions (see tn_reduction_guarded)...
+    int *support;          ///< ...and their targets.
+    Z3_ast *literals;      ///< In mutable mode, the literals of tn_reduction_network_literals for the network...
+    int num_literals;      ///< ...their number...
+    unsigned version;      ///< ...and the version of the network they were computed for.
+};
+
+TunnelQuery tn_query_create(Z3_context ctx, TunnelNetwork network)
+{
+    TunnelQuery query = (TunnelQuery)malloc(sizeof(*query));
+    query->ctx = ctx;
+    query->network = network;
+    query->sessions = NULL;
+    query->capacity = 0;
+    query->num_sessions = 0;
+    query->mutable = false;
+    query->support_offsets = NULL;
+    query->support = NULL;
+    query->literals = NULL;
+    query->num_literals = 0;
+    query->version = 0;
+    return query;
+}
+
+/**
+ * @brief Sets the support of @p query, and allocates its literals for it.
+ *
+ * @param query A query in mutable mode.
+ * @param offsets The edges of the support from node are (node, @p targets[k]) for k from offsets[node] to offsets[node + 1] - 1 (kept by @p query).
+ * @param targets The targets of the edges of the support (kept by @p query).
+ */
+static void tn_query_set_support(TunnelQuery query, int *offsets, int *targets)
+{
+    int num_nodes = tn_get_num_nodes(query->network);
+    free(query->support_offsets);
+    free(query->support);
+    free(query->literals);
+    query->support_offsets = offsets;
+    query->support = targets;
+    query->literals = (Z3_ast *)malloc((offsets[num_nodes] + num_nodes * NumActions + 2) * sizeof(Z3_ast));
+}
+
+TunnelQuery tn_query_create_mutable(Z3_context ctx, TunnelNetwork network)
+{
+    TunnelQuery query = tn_query_create(ctx, network);
+    const tn_compiled *view = tn_compile(network);
+    int num_nodes = view->num_nodes;
+    query->mutable = true;
+    int *offsets = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *targets = (int *)malloc((view->num_edges + 1) * sizeof(int));
+    memcpy(offsets, view->succ_offsets, (num_nodes + 1) * sizeof(int));
+    memcpy(targets, view->succ, view->num_edges * sizeof(int));
+    tn_query_set_support(query, offsets, targets);
+    query->num_literals = tn_reduction_network_literals(ctx, network, query->support_offsets, query->support, query->literals);
+    query->version = tn_get_version(network);
+    return query;
+}
+
+void tn_query_delete(TunnelQuery query)
+{
+    for (int length = 0; length < query->capacity; length++)
+        if (query->sessions[length] != NULL)
+            session_delete(query->sessions[length]);
+    free(query->support_offsets);
+    free(query->support);
+    free(query->literals);
+    free(query->sessions);
+    free(query);
+}
+
+/**
+ * @brief Returns the session for length @p length, building it if needed.
+ *
+ * @param query
+ * @param length A length.
+ * @return Z3Session The session, whose formula is tn_reduction_without_endpoints (or tn_reduction_guarded in mutable mode) for @p length.
+ */
+Z3Session tn_query_get_session(TunnelQuery query, int length)
+{
+    if (length >= query->capacity)
+    {
+        int capacity = query->capacity == 0 ? 16 : query->capacity;
+        while (capacity <= length)
+            capacity *= 2;
+        query->sessions = (Z3Session *)realloc(query->sessions, capacity * sizeof(Z3Session));
+        for (int l = query->capacity; l < capacity; l++)
+            query->sessions[l] = NULL;
+        query->capacity = capacity;
+    }
+    if (query->sessions[length] == NULL)
+    {
+        query->sessions[length] = session_create(query->ctx);
+        if (query->mutable)
+            session_assert(query->sessions[length], tn_reduction_guarded(query->ctx, query->network, length, query->support_offsets, query->support));
+        else
+            session_assert(query->sessions[length], tn_reduction_without_endpoints(query->ctx, query->network, length));
+        query->num_sessions++;
+    }
+    return query->sessions[length];
+}
+
+/**
+ * @brief In mutable mode, makes the support of @p query contain every edge of its network: if an edge was added outside of it, the support becomes the
+ *        union of both, and the sessions, which do not encode that edge, are dropped (they are built again for the new support when needed).
+ *
+ * @param query A query in mutable mode.
+ */
+static void tn_query_update_support(TunnelQuery query)
+{
+    const tn_compiled *view = tn_compile(query->network);
+    int num_nodes = view->num_nodes;
+    const int *offsets = query->support_offsets;
+    bool covered = true;
+    // Both lists of successors are sorted.
+    for (int node = 0; node < num_nodes && covered; node++)
+        for (int k = view->succ_offsets[node], s = offsets[node]; k < view->succ_offsets[node + 1] && covered; k++)
+        {
+            while (s < offsets[node + 1] && query->support[s] < view->succ[k])
+                s++;
+            covered = s < offsets[node + 1] && query->support[s] == view->succ[k];
+        }
+    if (covered)
+        return;
+
+    int *union_offsets = (int *)malloc((num_nodes + 1) * sizeof(int));
+    int *union_targets = (int *)malloc((offsets[num_nodes] + view->num_edges + 1) * sizeof(int));
+    int num_union = 0;
+    union_offsets[0] = 0;
+    for (int node = 0; node < num_nodes; node++)
+    {
+        int k = view->succ_offsets[node], s = offsets[node];
+        while (k < view->succ_offsets[node + 1] || s < offsets[node + 1])
+        {
+            if (s == offsets[node + 1] || (k < view->succ_offsets[node + 1] && view->succ[k] < query->support[s]))
+                union_targets[num_union++] = view->succ[k++];
+            else
+            {
+                if (k < view->succ_offsets[node + 1] && view->succ[k] == query->support[s])
+                    k++;
+                union_targets[num_union++] = query->support[s++];
+            }
+        }
+        union_offsets[node + 1] = num_union;
+    }
+    tn_query_set_support(query, union_offsets, union_targets);
+    for (int length = 0; length < query->capacity; length++)
+        if (query->sessions[length] != NULL)
+        {
+            session_delete(query->sessions[length]);
+            query->sessions[length] = NULL;
+        }
+}
+
+Z3_lbool tn_query_check(TunnelQuery query, int source, int target, int length, tn_step *path)
+{
+    if (query->mutable && query->version != tn_get_version(query->network))
+    {
+        tn_query_update_support(query);
+        query->num_literals = tn_reduction_network_literals(query->ctx, query->network, query->support_offsets, query->support, query->literals);
+        query->version = tn_get_version(query->network);
+    }
+    Z3Session session = tn_query_get_session(query, length);
+    Z3_lbool result;
+    if (query->mutable)
+    {
+        // The endpoints go after the literals of the network.
+        tn_reduction_endpoints(query->ctx, source, target, length, query->literals + query->num_literals);
+        result = session_check_assumptions(session, query->num_literals + 2, query->literals);
+    }
+    else
+    {
+        Z3_ast endpoints[2];
+        tn_reduction_endpoints(query->ctx, source, target, length, endpoints);
+        result = session_check_assumptions(session, 2, endpoints);
+    }
+    if (result == Z3_L_TRUE)
+        tn_get_path_from_model(query->ctx, session_get_model(session), query->network, length, path);
+    return result;
+}
+
+int tn_query_solve(TunnelQuery query, int source, int target, int bound, tn_step *path)
+{
+    return tn_query_solve_from(query, source, target, 1, bound, path);
+}
+
+int tn_query_solve_from(TunnelQuery query, int source, int target, int first, int bound, tn_step *path)
+{
+    for (int length = first; length <= bound; length++)
+    {
+        Z3_lbool result = tn_query_check(query, source, target, length, path);
+        if (result == Z3_L_TRUE)
+            return length;
+        if (result == Z3_L_UNDEF)
+            return -1;
+    }
+    return 0;
+}
+
+int tn_query_num_sessions(TunnelQuery query)
+{
+    return query->num_sessions;
+}
@@ -1,5 +1,6 @@
 #include "TunnelReduction.h"
 #include "Z3Tools.h"
+#include "Memory.h"
 #include <stdio.h>
 #include <stdlib.h>  
 
@@ -60,6 +61,23 @@ int get_stack_size(int length)
     return length / 2 + 1;
 }
 
+/**
+ * @brief Allocates a scratch array of @p size formulae, counted as reduction memory. Exits if the memory is not available.
+ *
+ * @param size The number of formulae.
+ * @return Z3_ast* The array, to be freed with memory_free.
+ */
+Z3_ast *tn_scratch_array(long size)
+{
+    Z3_ast *array = (Z3_ast *)memory_malloc((size > 0 ? size : 1) * sizeof(Z3_ast), MemoryReduction);
+    if (array == NULL)
+    {
+        fprintf(stderr, "Error: could not allocate %ld formulae for the reduction.\n", size);
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
 /**
  * @brief Crée la contrainte φ₁ : Unicité de l'état à chaque position
  * Cette fonction garantit qu'à chaque position du chemin, on se trouve
@@ -76,11 +94,11 @@ Z3_ast unicité(Z3_context ctx, TunnelNetwork reseau, int length){
     
    //Créer un tableau pour stocker les contraintes
     Z3_ast position_constraints[length + 1];
+    int nombre_etat_possibles = nombre_noeuds * taille_max_pile;
+    //Créer un tableau contient toutes les variables x_{nœud,position,hauteur} pour position i
+    Z3_ast *x = tn_scratch_array(nombre_etat_possibles);
      // Pour chaque position i, créer la contrainte d'unicité
     for (int i = 0; i <= length; i++){
-        int nombre_etat_possibles = nombre_noeuds * taille_max_pile;
-        //Créer un tableau contient toutes les variables x_{nœud,position,hauteur} pour position i
-        Z3_ast x[nombre_etat_possibles];
         int cnt = 0;
         
         for (int node = 0; node < nombre_noeuds; node++){
@@ -92,6 +110,7 @@ Z3_ast unicité(Z3_context ctx, TunnelNetwork reseau, int length){
         //Parmi ces variables, EXACTEMENT UNE doit être vraie** (var1 ou var2 ou .... ou varN) pour une position i
         position_constraints[i] = uniqueFormula(ctx, x, nombre_etat_possibles);
     }
+    memory_free(x);
     return Z3_mk_and(ctx, length + 1, position_constraints);
 }
 
@@ -146,14 +165,12 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
 {
     int nombre_noeuds = tn_get_num_nodes(reseau);
     int taille_max_pile = get_stack_size(length);
+    const tn_compiled *vue = tn_compile(reseau);
 
     // Allouer dynamiquement sur le tas au lieu de la pile
-    int max_constraints = length * nombre_noeuds * nombre_noeuds * taille_max_pile * 30;
-    Z3_ast *toutes_contraintes = (Z3_ast *)malloc(max_constraints * sizeof(Z3_ast));
-    if (toutes_contraintes == NULL) {
-        fprintf(stderr, "Erreur: impossible d'allouer la mémoire pour les contraintes\n");
-        exit(1);
-    }
+    long max_constraints = (long)length * nombre_noeuds * nombre_noeuds * taille_max_pile * 30;
+    Z3_ast *toutes_contraintes = tn_scratch_array(max_constraints);
+    Z3_ast *transitions_possibles = tn_scratch_array(nombre_noeuds * 3);
 
     int nb_contraintes = 0;
     // CONTRAINTE 1 : Interdire les transitions avec changement de hauteur invalide
@@ -186,7 +203,7 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
                 Z3_ast x_noeud = tn_path_variable(ctx, noeud, i, haut);
                 for (int noeud_suiv = 0; noeud_suiv < nombre_noeuds; noeud_suiv++){
                     // Si l'arête noeud->noeud_suiv N'EXISTE PAS
-                    if (!tn_is_edge(reseau, noeud, noeud_suiv)){
+                    if (!vue->edges[noeud * nombre_noeuds + noeud_suiv]){
                         // Interdire TOUTES les transitions vers noeud_suiv depuis noeud
 
                         // TRANSMIT
@@ -214,10 +231,10 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
                     Z3_ast contrainte_transmission = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, etat_suivant_meme_hauteur});
                     Z3_ast conditions_transmit[10];
                     int nb_conditions_transmit = 0;
-                    if (tn_node_has_action(reseau, noeud, transmit_4)){
+                    if (vue->actions[noeud] & (1 << transmit_4)){
                         conditions_transmit[nb_conditions_transmit++] = tn_4_variable(ctx, i, haut);
                     }
-                    if (tn_node_has_action(reseau, noeud, transmit_6)){
+                    if (vue->actions[noeud] & (1 << transmit_6)){
                         conditions_transmit[nb_conditions_transmit++] = tn_6_variable(ctx, i, haut);
                     }
                     if (nb_conditions_transmit > 0){
@@ -235,28 +252,28 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
                         Z3_ast conditions_push[10];
                         int nb_conditions_push = 0;
                         
-                        if (tn_node_has_action(reseau, noeud, push_4_4)){
+                        if (vue->actions[noeud] & (1 << push_4_4)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_4_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i + 1, haut + 1)
                             });
                             conditions_push[nb_conditions_push++] = cond;
                         }
-                        if (tn_node_has_action(reseau, noeud, push_4_6)){
+                        if (vue->actions[noeud] & (1 << push_4_6)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_4_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i + 1, haut + 1)
                             });
                             conditions_push[nb_conditions_push++] = cond;
                         }
-                        if (tn_node_has_action(reseau, noeud, push_6_4)){
+                        if (vue->actions[noeud] & (1 << push_6_4)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_6_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i + 1, haut + 1)
                             });
                             conditions_push[nb_conditions_push++] = cond;
                         }
-                        if (tn_node_has_action(reseau, noeud, push_6_6)){
+                        if (vue->actions[noeud] & (1 << push_6_6)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_6_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i + 1, haut + 1)
@@ -277,28 +294,28 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
                         Z3_ast transition_pop = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, etat_suivant_apres_pop});
                         Z3_ast conditions_pop[10];
                         int nb_conditions_pop = 0;
-                        if (tn_node_has_action(reseau, noeud, pop_4_4)){
+                        if (vue->actions[noeud] & (1 << pop_4_4)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_4_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i, haut - 1)
                             });
                             conditions_pop[nb_conditions_pop++] = cond;
                         }
-                        if (tn_node_has_action(reseau, noeud, pop_4_6)) {
+                        if (vue->actions[noeud] & (1 << pop_4_6)) {
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_6_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i, haut - 1)
                             });
                             conditions_pop[nb_conditions_pop++] = cond;
                         }
-                        if (tn_node_has_action(reseau, noeud, pop_6_4)){
+                        if (vue->actions[noeud] & (1 << pop_6_4)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_4_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i, haut - 1)
                             });
                             conditions_pop[nb_conditions_pop++] = cond;
                         }
-                        if (tn_node_has_action(reseau, noeud, pop_6_6)){
+                        if (vue->actions[noeud] & (1 << pop_6_6)){
                             Z3_ast cond = Z3_mk_and(ctx, 2, (Z3_ast[]){
                                 tn_6_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i, haut - 1)
@@ -316,23 +333,18 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
                 }
                 
                 int nb_transitions_possibles = 0;
-                Z3_ast transitions_possibles[nombre_noeuds * 3];
-                for (int noeud_suiv = 0; noeud_suiv < nombre_noeuds; noeud_suiv++){
-                    if (!tn_is_edge(reseau,noeud, noeud_suiv))
-                        continue;
-                    
+                for (int k = vue->succ_offsets[noeud]; k < vue->succ_offsets[noeud + 1]; k++){
+                    int noeud_suiv = vue->succ[k];
                     // TRANSMIT
-                    if (tn_node_has_action(reseau,noeud, transmit_4) || tn_node_has_action(reseau,noeud, transmit_6)){
+                    if (vue->transmit[noeud]){
                         transitions_possibles[nb_transitions_possibles++] = tn_path_variable(ctx, noeud_suiv, i + 1, haut);
                     }
                     // PUSH
-                    if (haut + 1 < taille_max_pile && (tn_node_has_action(reseau,noeud, push_4_4) || tn_node_has_action(reseau,noeud, push_4_6) ||
-                         tn_node_has_action(reseau,noeud, push_6_4) || tn_node_has_action(reseau,noeud, push_6_6))){
+                    if (haut + 1 < taille_max_pile && vue->push[noeud]){
                         transitions_possibles[nb_transitions_possibles++] = tn_path_variable(ctx, noeud_suiv, i + 1, haut + 1);
                     }
                     // POP
-                    if (haut > 0 && (tn_node_has_action(reseau,noeud, pop_4_4) || tn_node_has_action(reseau,noeud, pop_4_6) ||
-                         tn_node_has_action(reseau,noeud, pop_6_4) || tn_node_has_action(reseau,noeud, pop_6_6))){
+                    if (haut > 0 && vue->pop[noeud]){
                         transitions_possibles[nb_transitions_possibles++] = tn_path_variable(ctx, noeud_suiv, i + 1, haut - 1);
                     }
                 }
@@ -345,7 +357,8 @@ Z3_ast creer_contraintes_transitions(Z3_context ctx, TunnelNetwork reseau, int l
     }
     Z3_ast result = Z3_mk_and(ctx, nb_contraintes, toutes_contraintes);
     // Libérer la mémoire allouée
-    free(toutes_contraintes);
+    memory_free(toutes_contraintes);
+    memory_free(transitions_possibles);
     
     return result;
 }
@@ -366,13 +379,13 @@ Z3_ast creer_contrainte_pile_bien_definie(Z3_context ctx, TunnelNetwork reseau,
     int nombre_noeuds = tn_get_num_nodes(reseau);
     int taille_max_pile= get_stack_size(length);
     int nombre_contraintes  = 0;
-    Z3_ast toutes_contraintes[(length + 1) * taille_max_pile* taille_max_pile];
+    Z3_ast *toutes_contraintes = tn_scratch_array((long)(length + 1) * taille_max_pile * taille_max_pile);
+    Z3_ast *variables_hauteur = tn_scratch_array((long)taille_max_pile * nombre_noeuds);
     
     for (int i = 0; i <= length; i++){
         for (int h = 0; h < taille_max_pile; h++){
             // Condition: si la pile est de hauteur h
             int nb_vars_hauteur = 0;
-            Z3_ast variables_hauteur[taille_max_pile * nombre_noeuds];
             
             for (int node = 0; node < nombre_noeuds; node++){
                 for (int height = 0; height < taille_max_pile; height++){
@@ -403,7 +416,10 @@ Z3_ast creer_contrainte_pile_bien_definie(Z3_context ctx, TunnelNetwork reseau,
         }
     }
     
-    return Z3_mk_and(ctx, nombre_contraintes , toutes_contraintes);
+    Z3_ast result = Z3_mk_and(ctx, nombre_contraintes , toutes_contraintes);
+    memory_free(toutes_contraintes);
+    memory_free(variables_hauteur);
+    return result;
 }
 
 /**
@@ -418,27 +434,27 @@ Z3_ast creer_contrainte_pile_bien_definie(Z3_context ctx, TunnelNetwork reseau,
 Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int length){
     int nombre_noeuds= tn_get_num_nodes(reseau);
     int taille_max_pile= get_stack_size(length);
+    const tn_compiled *vue = tn_compile(reseau);
     
     int nombre_contraintes = 0;
-    Z3_ast toutes_contraintes[length * nombre_noeuds* nombre_noeuds* taille_max_pile* 15];
+    Z3_ast *toutes_contraintes = tn_scratch_array((long)length * nombre_noeuds * nombre_noeuds * taille_max_pile * 15);
     
     for (int i = 0; i < length; i++){
         for (int noeud= 0; noeud< nombre_noeuds; noeud++){
-            for (int noeud_suiv= 0; noeud_suiv< nombre_noeuds; noeud_suiv++){
-                if (!tn_is_edge(reseau, noeud,noeud_suiv))
-                    continue;
+            for (int k = vue->succ_offsets[noeud]; k < vue->succ_offsets[noeud + 1]; k++){
+                int noeud_suiv = vue->succ[k];
                 for (int haut = 0; haut < taille_max_pile; haut++){
                     Z3_ast x_noeud = tn_path_variable(ctx, noeud, i, haut);
                     
                     // === TRANSMIT_4 ===
-                    if (tn_node_has_action(reseau, noeud, transmit_4)){
+                    if (vue->actions[noeud] & (1 << transmit_4)){
                         Z3_ast x_noued_suiv = tn_path_variable(ctx,noeud_suiv, i + 1, haut);
                         Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noued_suiv});
                         Z3_ast top_is_4 = tn_4_variable(ctx, i, haut);
                         toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition, top_is_4);
                     }
                     // === TRANSMIT_6 ===
-                    if (tn_node_has_action(reseau, noeud, transmit_6)){
+                    if (vue->actions[noeud] & (1 << transmit_6)){
                         Z3_ast x_noued_suiv = tn_path_variable(ctx,noeud_suiv, i + 1, haut);
                         Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noued_suiv});
                         Z3_ast top_is_6 = tn_6_variable(ctx, i, haut);
@@ -450,7 +466,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                         Z3_ast x_noued_suiv_push = tn_path_variable(ctx,noeud_suiv, i + 1, haut + 1);
                         Z3_ast transition_push = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noued_suiv_push});
                         // PUSH_4_4: sommet actuel=4, nouveau sommet=4
-                        if (tn_node_has_action(reseau, noeud, push_4_4)){
+                        if (vue->actions[noeud] & (1 << push_4_4)){
                             Z3_ast conds[2] = {
                                 tn_4_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i + 1, haut + 1)
@@ -458,7 +474,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                             toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition_push, Z3_mk_and(ctx, 2, conds));
                         }
                         // PUSH_4_6: sommet actuel=4, nouveau sommet=6
-                        if (tn_node_has_action(reseau, noeud, push_4_6)){
+                        if (vue->actions[noeud] & (1 << push_4_6)){
                             Z3_ast conds[2] = {
                                 tn_4_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i + 1, haut + 1)
@@ -466,7 +482,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                             toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition_push, Z3_mk_and(ctx, 2, conds));
                         }
                         // PUSH_6_4: sommet actuel=6, nouveau sommet=4
-                        if (tn_node_has_action(reseau, noeud, push_6_4)){
+                        if (vue->actions[noeud] & (1 << push_6_4)){
                             Z3_ast conds[2] = {
                                 tn_6_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i + 1, haut + 1)
@@ -474,7 +490,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                             toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition_push, Z3_mk_and(ctx, 2, conds));
                         }
                         // PUSH_6_6: sommet actuel=6, nouveau sommet=6
-                        if (tn_node_has_action(reseau, noeud, push_6_6)){
+                        if (vue->actions[noeud] & (1 << push_6_6)){
                             Z3_ast conds[2] = {
                                 tn_6_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i + 1, haut + 1)
@@ -488,7 +504,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                         Z3_ast x_noued_suiv_pop = tn_path_variable(ctx,noeud_suiv, i + 1, haut - 1);
                         Z3_ast transition_pop = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noued_suiv_pop});
                         // POP_4_4: sommet=4, sous-sommet=4
-                        if (tn_node_has_action(reseau, noeud, pop_4_4)){
+                        if (vue->actions[noeud] & (1 << pop_4_4)){
                             Z3_ast conds[2] = {
                                 tn_4_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i, haut - 1)
@@ -496,7 +512,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                             toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition_pop, Z3_mk_and(ctx, 2, conds));
                         }
                         // POP_4_6: sommet=6, sous-sommet=4
-                        if (tn_node_has_action(reseau, noeud, pop_4_6)){
+                        if (vue->actions[noeud] & (1 << pop_4_6)){
                             Z3_ast conds[2] = {
                                 tn_6_variable(ctx, i, haut),
                                 tn_4_variable(ctx, i, haut - 1)
@@ -504,7 +520,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                             toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition_pop, Z3_mk_and(ctx, 2, conds));
                         }
                         // POP_6_4: sommet=4, sous-sommet=6
-                        if (tn_node_has_action(reseau, noeud, pop_6_4)){
+                        if (vue->actions[noeud] & (1 << pop_6_4)){
                             Z3_ast conds[2] = {
                                 tn_4_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i, haut - 1)
@@ -512,7 +528,7 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
                             toutes_contraintes[nombre_contraintes++] = Z3_mk_implies(ctx, transition_pop, Z3_mk_and(ctx, 2, conds));
                         }
                         // POP_6_6: sommet=6, sous-sommet=6
-                        if (tn_node_has_action(reseau, noeud, pop_6_6)){
+                        if (vue->actions[noeud] & (1 << pop_6_6)){
                             Z3_ast conds[2] = {
                                 tn_6_variable(ctx, i, haut),
                                 tn_6_variable(ctx, i, haut - 1)
@@ -524,7 +540,9 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
             }
         }
     }
-    return Z3_mk_and(ctx, nombre_contraintes, toutes_contraintes);
+    Z3_ast result = Z3_mk_and(ctx, nombre_contraintes, toutes_contraintes);
+    memory_free(toutes_contraintes);
+    return result;
 }
 
 /**
@@ -547,21 +565,20 @@ Z3_ast create_top_operation_constraint(Z3_context ctx, TunnelNetwork reseau, int
 Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, int length){
     int nombre_noeuds= tn_get_num_nodes(reseau);
     int taille_max_pile= get_stack_size(length);
+    const tn_compiled *vue = tn_compile(reseau);
     
     int num_constraints = 0;
-    Z3_ast all_constraints[length * nombre_noeuds * nombre_noeuds * taille_max_pile * 10];
+    Z3_ast *all_constraints = tn_scratch_array((long)length * nombre_noeuds * nombre_noeuds * taille_max_pile * 10);
     
     for (int i = 0; i < length; i++){
         for (int noeud= 0; noeud< nombre_noeuds; noeud++){
-            for (int noeud_suiv = 0; noeud_suiv < nombre_noeuds; noeud_suiv++){
-                if (!tn_is_edge(reseau, noeud, noeud_suiv))
-                    continue;
-                
+            for (int k = vue->succ_offsets[noeud]; k < vue->succ_offsets[noeud + 1]; k++){
+                int noeud_suiv = vue->succ[k];
                 for (int haut = 0; haut < taille_max_pile; haut++){
                     Z3_ast x_noeud = tn_path_variable(ctx, noeud, i, haut);
 
                     // TRANSMIT:
-                    if (tn_node_has_action(reseau, noeud, transmit_4) || tn_node_has_action(reseau, noeud, transmit_6)){
+                    if (vue->transmit[noeud]){
                         Z3_ast x_noeud_suiv = tn_path_variable(ctx, noeud_suiv, i + 1, haut);
                         Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noeud_suiv});
                         // Toutes les cellules restent identiques
@@ -579,7 +596,7 @@ Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, i
                     // PUSH
                     if (haut + 1 < taille_max_pile){
                         // PUSH 4->4: ajoute 4 au sommet
-                        if (tn_node_has_action(reseau, noeud, push_4_4)){
+                        if (vue->actions[noeud] & (1 << push_4_4)){
                             Z3_ast x_noeud_suiv = tn_path_variable(ctx, noeud_suiv, i + 1, haut + 1);
                             Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noeud_suiv});
                             int num_conds = 1;
@@ -594,7 +611,7 @@ Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, i
                         }
                         
                         // PUSH 4->6: ajoute 6 au sommet
-                        if (tn_node_has_action(reseau, noeud, push_4_6)){
+                        if (vue->actions[noeud] & (1 << push_4_6)){
                             Z3_ast x_noeud_suiv = tn_path_variable(ctx, noeud_suiv, i + 1, haut + 1);
                             Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noeud_suiv});
                             
@@ -612,7 +629,7 @@ Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, i
                         }
                         
                         // PUSH 6->4 et PUSH 6->6 
-                        if (tn_node_has_action(reseau, noeud, push_6_4)){
+                        if (vue->actions[noeud] & (1 << push_6_4)){
                             Z3_ast x_noeud_suiv = tn_path_variable(ctx, noeud_suiv, i + 1, haut + 1);
                             Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noeud_suiv});
                             
@@ -628,7 +645,7 @@ Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, i
                             all_constraints[num_constraints++] = Z3_mk_implies(ctx, transition, Z3_mk_and(ctx, num_conds, conds));
                         }
                         
-                        if (tn_node_has_action(reseau, noeud, push_6_6)){
+                        if (vue->actions[noeud] & (1 << push_6_6)){
                             Z3_ast x_noeud_suiv = tn_path_variable(ctx, noeud_suiv, i + 1, haut + 1);
                             Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noeud_suiv});
                             
@@ -646,8 +663,7 @@ Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, i
                     }
                     
                     // POP: retire le sommet
-                    if (haut > 0 && (tn_node_has_action(reseau, noeud, pop_4_4) || tn_node_has_action(reseau, noeud, pop_4_6) ||
-                                  tn_node_has_action(reseau, noeud, pop_6_4) || tn_node_has_action(reseau, noeud, pop_6_6))){
+                    if (haut > 0 && vue->pop[noeud]){
                         Z3_ast x_noeud_suiv = tn_path_variable(ctx, noeud_suiv, i + 1, haut - 1);
                         Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){x_noeud, x_noeud_suiv});
                         
@@ -667,7 +683,9 @@ Z3_ast create_stack_evolution_constraint(Z3_context ctx, TunnelNetwork reseau, i
         }
     }
     
-    return Z3_mk_and(ctx, num_constraints, all_constraints);
+    Z3_ast result = Z3_mk_and(ctx, num_constraints, all_constraints);
+    memory_free(all_constraints);
+    return result;
 }
 /**
  * @brief Crée la contrainte φ₈ : chemin simple (pas de nœud visité deux fois)
@@ -686,7 +704,7 @@ Z3_ast create_simple_path_constraint(Z3_context ctx, TunnelNetwork reseau, int l
     int taille_max_pile= get_stack_size(length);
     
     int nombre_contraintes = 0;
-    Z3_ast toutes_contraintes[nombre_noeuds * length * length * taille_max_pile];
+    Z3_ast *toutes_contraintes = tn_scratch_array((long)nombre_noeuds * length * length * taille_max_pile);
     
     // Pour chaque nœud noeud et hauteur haut 
     for (int noeud= 0; noeud< nombre_noeuds; noeud++){
@@ -705,16 +723,470 @@ Z3_ast create_simple_path_constraint(Z3_context ctx, TunnelNetwork reseau, int l
         }
     }
     
-    return Z3_mk_and(ctx, nombre_contraintes, toutes_contraintes);
+    Z3_ast result = Z3_mk_and(ctx, nombre_contraintes, toutes_contraintes);
+    memory_free(toutes_contraintes);
+    return result;
+}
+
+/**
+ * @brief Creates the variable "the edge (@p source, @p target) exists" of the guarded reduction.
+ *
+ * @param ctx The solver context.
+ * @param source A node.
+ * @param target A node.
+ * @return Z3_ast
+ */
+Z3_ast tn_edge_variable(Z3_context ctx, int source, int target)
+{
+    char name[60];
+    snprintf(name, 60, "edge %d to %d", source, target);
+    return mk_bool_var(ctx, name);
+}
+
+/**
+ * @brief Creates the variable "@p node can perform @p action" of the guarded reduction.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param action An action.
+ * @return Z3_ast
+ */
+Z3_ast tn_action_variable(Z3_context ctx, int node, stack_action action)
+{
+    char name[60];
+    snprintf(name, 60, "node %d has action %d", node, action);
+    return mk_bool_var(ctx, name);
+}
+
+/**
+ * @brief Returns tn_4_variable or tn_6_variable, depending on @p protocol.
+ *
+ * @param ctx The solver context.
+ * @param protocol 4 or 6.
+ * @param pos The path position.
+ * @param height The height of the cell.
+ * @return Z3_ast
+ */
+static Z3_ast tn_protocol_variable(Z3_context ctx, int protocol, int pos, int height)
+{
+    return protocol == 4 ? tn_4_variable(ctx, pos, height) : tn_6_variable(ctx, pos, height);
+}
+
+/**
+ * @brief Returns the formula "the cells 0 to @p top of the stack are the same at positions @p pos and @p pos+1".
+ *
+ * @param ctx The solver context.
+ * @param pos The path position.
+ * @param top The highest cell preserved (-1 for none).
+ * @return Z3_ast
+ */
+static Z3_ast tn_preserved_stack(Z3_context ctx, int pos, int top)
+{
+    Z3_ast preserved[2 * (top + 1) + 1];
+    int num_preserved = 0;
+    for (int k = 0; k <= top; k++)
+    {
+        preserved[num_preserved++] = Z3_mk_eq(ctx, tn_4_variable(ctx, pos, k), tn_4_variable(ctx, pos + 1, k));
+        preserved[num_preserved++] = Z3_mk_eq(ctx, tn_6_variable(ctx, pos, k), tn_6_variable(ctx, pos + 1, k));
+    }
+    if (num_preserved == 0)
+        return Z3_mk_true(ctx);
+    return Z3_mk_and(ctx, num_preserved, preserved);
+}
+
+/**
+ * @brief Creates the variable "the path has ended at position @p pos or before" of the reduction for all sizes up to a bound (tn_reduction_up_to).
+ *
+ * @param ctx The solver context.
+ * @param pos The path position.
+ * @return Z3_ast
+ */
+Z3_ast tn_done_variable(Z3_context ctx, int pos)
+{
+    char name[60];
+    snprintf(name, 60, "done at pos %d", pos);
+    return mk_bool_var(ctx, name);
+}
+
+/**
+ * @brief Returns the highest height of the stack at position @p pos of a path of size @p length: the stack is empty (height 0) at both ends of the path,
+ *        and each step changes its height by at most one.
+ *
+ * @param pos The path position.
+ * @param length The size of the path.
+ * @return int
+ */
+static int tn_top_height(int pos, int length)
+{
+    return pos < length - pos ? pos : length - pos;
+}
+
+/**
+ * @brief Returns the highest height of the stack at position @p pos in the frame-by-frame construction: the height grows by at most one per step,
+ *        and the stack has @p stack_size cells.
+ *
+ * @param pos The path position.
+ * @param stack_size The number of cells of the stack.
+ * @return int
+ */
+static int tn_frame_top_height(int pos, int stack_size)
+{
+    return pos < stack_size - 1 ? pos : stack_size - 1;
+}
+
+/**
+ * @brief Returns φ₁ and φ₄ at position @p pos: exactly one state (node, height), and the cells of the stack up to its height each contain exactly one protocol.
+ *
+ * @param ctx The solver context.
+ * @param num_nodes The number of nodes.
+ * @param pos The path position.
+ * @param stack_size The number of cells of the stack.
+ * @return Z3_ast
+ */
+static Z3_ast tn_position_constraints(Z3_context ctx, int num_nodes, int pos, int stack_size)
+{
+    Z3_ast *states = tn_scratch_array((long)num_nodes * stack_size);
+    int num_states = 0;
+    for (int node = 0; node < num_nodes; node++)
+        for (int h = 0; h < stack_size; h++)
+            states[num_states++] = tn_path_variable(ctx, node, pos, h);
+    Z3_ast constraints[stack_size + 1];
+    constraints[0] = uniqueFormula(ctx, states, num_states);
+    for (int h = 0; h < stack_size; h++)
+    {
+        for (int node = 0; node < num_nodes; node++)
+            states[node] = tn_path_variable(ctx, node, pos, h);
+        Z3_ast cells[h + 1];
+        for (int k = 0; k <= h; k++)
+            cells[k] = Z3_mk_xor(ctx, tn_4_variable(ctx, pos, k), tn_6_variable(ctx, pos, k));
+        constraints[h + 1] = Z3_mk_implies(ctx, Z3_mk_or(ctx, num_nodes, states), Z3_mk_and(ctx, h + 1, cells));
+    }
+    memory_free(states);
+    return Z3_mk_and(ctx, stack_size + 1, constraints);
+}
+
+/**
+ * @brief Returns the formula "@p action can be performed at position @p i with a stack of height @p height": the protocols it reads on the stack at
+ *        position @p i and, for a push, the one it puts on top at position @p i+1; and "@p node can perform @p action" (tn_action_variable) if @p guarded.
+ *
+ * @param ctx The solver context.
+ * @param node A node.
+ * @param action An action.
+ * @param i The path position.
+ * @param height The height of the stack at position @p i.
+ * @param guarded Whether the actions are variables.
+ * @return Z3_ast
+ */
+static Z3_ast tn_action_condition(Z3_context ctx, int node, stack_action action, int i, int height, bool guarded)
+{
+    // The protocols of the actions: on top before and after for transmit and push, on top and below for pop.
+    const int protocols[NumActions][2] = {{4, 4}, {6, 6}, {4, 4}, {4, 6}, {6, 4}, {6, 6}, {4, 4}, {6, 4}, {4, 6}, {6, 6}};
+    Z3_ast conditions[3];
+    int num_conditions = 0;
+    if (guarded)
+        conditions[num_conditions++] = tn_action_variable(ctx, node, action);
+    conditions[num_conditions++] = tn_protocol_variable(ctx, protocols[action][0], i, height);
+    if ((1 << action) & PushActions)
+        conditions[num_conditions++] = tn_protocol_variable(ctx, protocols[action][1], i + 1, height + 1);
+    else if ((1 << action) & PopActions)
+        conditions[num_conditions++] = tn_protocol_variable(ctx, protocols[action][1], i, height - 1);
+    return Z3_mk_and(ctx, num_conditions, conditions);
+}
+
+/**
+ * @brief Adds to @p constraints φ₃ and φ₆ for the step from position @p i to position @p i+1: each state goes to one of the states it reaches through
+ *        an edge with a transmit, a push or a pop, and each of these transitions implies that one action of its source allows it, and the evolution of
+ *        the stack. Only the edges listed by @p offsets and @p targets are encoded: φ₁ at position @p i+1 (exactly one state) excludes the others.
+ *        The actions are variables (tn_action_variable), and so is each edge listed (tn_edge_variable), if @p guarded; otherwise they are read from
+ *        @p network. If @p stutter, the step keeps the node, the height and the stack instead when the path has ended at position @p i (tn_done_variable).
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param i The position of the step.
+ * @param top The highest height of the stack at position @p i.
+ * @param next_top The highest height of the stack at position @p i+1.
+ * @param offsets The edges encoded from node are (node, targets[k]) for k from offsets[node] to offsets[node + 1] - 1.
+ * @param targets The targets of the edges encoded.
+ * @param guarded Whether the edges and the actions are variables.
+ * @param stutter Whether the path may end before the step.
+ * @param constraints The array to fill, of size at least tn_step_transitions_size.
+ * @return int The number of constraints added.
+ */
+static int tn_step_transitions(Z3_context ctx, const TunnelNetwork network, int i, int top, int next_top, const int *offsets, const int *targets, bool guarded,
+                               bool stutter, Z3_ast *constraints)
+{
+    const tn_compiled *view = tn_compile(network);
+    int num_nodes = view->num_nodes;
+    // The kinds of steps (transmit, push and pop), their actions and how they change the height of the stack.
+    const int kinds[3] = {TransmitActions, PushActions, PopActions};
+    const int deltas[3] = {0, 1, -1};
+    int num_constraints = 0;
+    Z3_ast done = tn_done_variable(ctx, i);
+    Z3_ast *next_states = tn_scratch_array((long)3 * num_nodes);
+    if (stutter)
+        constraints[num_constraints++] = Z3_mk_implies(ctx, done, tn_preserved_stack(ctx, i, top < next_top ? top : next_top));
+    for (int node = 0; node < num_nodes; node++)
+    {
+        int actions = guarded ? (1 << NumActions) - 1 : view->actions[node];
+        for (int height = 0; height <= top; height++)
+        {
+            Z3_ast x_node = tn_path_variable(ctx, node, i, height);
+            Z3_ast moving = x_node;
+            if (stutter)
+            {
+                Z3_ast stay = height <= next_top ? tn_path_variable(ctx, node, i + 1, height) : Z3_mk_false(ctx);
+                constraints[num_constraints++] = Z3_mk_implies(ctx, Z3_mk_and(ctx, 2, (Z3_ast[]){done, x_node}), stay);
+                moving = Z3_mk_and(ctx, 2, (Z3_ast[]){Z3_mk_not(ctx, done), x_node});
+            }
+
+            // The conditions allowing a step of each kind from this state, whatever the next node (NULL if there is none).
+            Z3_ast valid[3];
+            for (int kind = 0; kind < 3; kind++)
+            {
+                valid[kind] = NULL;
+                int next_height = height + deltas[kind];
+                if (next_height < 0 || next_height > next_top || (actions & kinds[kind]) == 0)
+                    continue;
+                Z3_ast options[4];
+                int num_options = 0;
+                for (stack_action action = 0; action < NumActions; action++)
+                    if (actions & kinds[kind] & (1 << action))
+                        options[num_options++] = tn_action_condition(ctx, node, action, i, height, guarded);
+                valid[kind] = Z3_mk_and(ctx, 2, (Z3_ast[]){Z3_mk_or(ctx, num_options, options), tn_preserved_stack(ctx, i, next_height < height ? next_height : height)});
+            }
+
+            int num_next = 0;
+            for (int k = offsets[node]; k < offsets[node + 1]; k++)
+                for (int kind = 0; kind < 3; kind++)
+                {
+                    if (valid[kind] == NULL)
+                        continue;
+                    int next = targets[k];
+                    Z3_ast next_state = tn_path_variable(ctx, next, i + 1, height + deltas[kind]);
+                    next_states[num_next++] = next_state;
+                    Z3_ast transition = Z3_mk_and(ctx, 2, (Z3_ast[]){moving, next_state});
+                    if (guarded)
+                        constraints[num_constraints++] = Z3_mk_implies(ctx, transition, tn_edge_variable(ctx, node, next));
+                    constraints[num_constraints++] = Z3_mk_implies(ctx, transition, valid[kind]);
+                }
+            constraints[num_constraints++] = Z3_mk_implies(ctx, moving, num_next > 0 ? Z3_mk_or(ctx, num_next, next_states) : Z3_mk_false(ctx));
+        }
+    }
+    memory_free(next_states);
+    return num_constraints;
+}
+
+/**
+ * @brief Returns the max number of constraints added by tn_step_transitions.
+ *
+ * @param num_nodes The number of nodes.
+ * @param num_edges The number of edges encoded.
+ * @param top The highest height of the stack at the position of the step.
+ * @return long
+ */
+static long tn_step_transitions_size(int num_nodes, int num_edges, int top)
+{
+    return (long)(top + 1) * (2L * num_nodes + 6L * num_edges) + 1;
+}
+
+/**
+ * @brief Creates φ₃ and φ₆ for every step of a path of size @p length (see tn_step_transitions).
+ *
+ * @param ctx The solver context.
+ * @param network A Tunnel Network.
+ * @param length The size of the path.
+ * @param offsets The edges encoded from node are (node, targets[k]) for k from offsets[node] to offsets[node + 1] - 1.
+ * @param targets The targets of the edges encoded.
+ * @param guarded Whether the edges and the actions are variables.
+ * @param stutter Whether the path may end before @p length.
+ * @return Z3_ast The formula.
+ */
+static Z3_ast tn_guarded_transitions(Z3_context ctx, const TunnelNetwork network, int length, const int *offsets, const int *targets, bool guarded, bool stutter)
+{
+    int num_nodes = tn_get_num_nodes(network);
+    long size = 0;
+    for (int i = 0; i < length; i++)
+        size += tn_step_transitions_size(num_nodes, offsets[num_nodes], tn_top_height(i, length));
+    Z3_ast *constraints = tn_scratch_array(size);
+    int num_constraints = 0;
+    for (int i = 0; i < length; i++)
+        num_constraints += tn_step_transitions(ctx, network, i, tn_top_height(i, length), tn_top_height(i + 1, length), offsets, targets, guarded, stutter,
+                                               constraints + num_constraints);
+    Z3_ast result = Z3_mk_and(ctx, num_constraints, constraints);
+    memory_free(constraints);
+    return result;
 }
 
-//((((((((((((((((()))))))))))))))))
-Z3_ast tn_reduction(Z3_context ctx, const TunnelNetwork network, int length){
-     printf("=== DEBUT tn_reduction, length=%d ===\n", length);
+/**
+ * @brief Creates φ₁ and φ₄ for every position of a path of size @p length, with the heights the stack can reach at each position (see tn_top_height).
+ *
+ * @param ctx The solver context.
+ * @param num_nodes The number of nodes.
+ * @param length The size of the path.
+ * @return Z3_ast The formula.
+ */
+static Z3_ast tn_bounded_positions(Z3_context ctx, int num_nodes, int length)
+{
+    Z3_ast constraints[length + 1];
+    for (int pos = 0; pos <= length; pos++)
+        constraints[pos] = tn_position_constraints(ctx, num_nodes, pos, tn_top_height(pos, length) + 1);
+    return Z3_mk_and(ctx, length + 1, constraints);
+}
+
+/**
+ * @brief Creates φ₈ for a path of size @p length, with the heights the stack can reach at each position (see tn_top_height): a state (node, height)
+ *        cannot be visited twice. If @p stutter, the path may end before @p length, and the steps after its end may stay on the same state.
+ *
+ * @param ctx The solver context.
+ * @param num_nodes The number of nodes.
+ * @param length The size of the path.
+ * @param stutter Whether the path may end before @p length.
+ * @return Z3_ast The formula.
+ */
+static Z3_ast tn_bounded_simple_path(Z3_context ctx, int num_nodes, int length, bool stutter)
+{
+    Z3_ast *constraints = tn_scratch_array((long)num_nodes * get_stack_size(length) * (length + 1) * length / 2);
+    int num_constraints = 0;
+    for (int node = 0; node < num_nodes; node++)
+        for (int i = 0; i <= length; i++)
+            for (int j = i + 1; j <= length; j++)
+                for (int h = 0; h <= tn_top_height(i, length) && h <= tn_top_height(j, length); h++)
+                {
+                    Z3_ast both[3] = {tn_path_variable(ctx, node, i, h), tn_path_variable(ctx, node, j, h)};
+                    if (stutter)
+                        both[2] = Z3_mk_not(ctx, tn_done_variable(ctx, j - 1));
+                    constraints[num_constraints++] = Z3_mk_not(ctx, Z3_mk_and(ctx, stutter ? 3 : 2, both));
+                }
+    Z3_ast result = Z3_mk_and(ctx, num_constraints, constraints);
+    memory_free(constraints);
+    return result;
+}
+
+Z3_ast tn_reduction_up_to(Z3_context ctx, const TunnelNetwork network, int length)
+{
+    const tn_compiled *view = tn_compile(network);
+    Z3_ast *constraints = tn_scratch_array(length + 8);
+    int num_constraints = 0;
+    constraints[num_constraints++] = tn_bounded_positions(ctx, view->num_nodes, length);
+    constraints[num_constraints++] = tn_guarded_transitions(ctx, network, length, view->succ_offsets, view->succ, false, true);
+    constraints[num_constraints++] = tn_bounded_simple_path(ctx, view->num_nodes, length, true);
+    constraints[num_constraints++] = tn_4_variable(ctx, 0, 0);
+    constraints[num_constraints++] = tn_4_variable(ctx, length, 0);
+    // The path has at least one step, and once it has ended it stays ended.
+    constraints[num_constraints++] = Z3_mk_not(ctx, tn_done_variable(ctx, 0));
+    constraints[num_constraints++] = tn_done_variable(ctx, length);
+    for (int i = 0; i < length; i++)
+        constraints[num_constraints++] = Z3_mk_implies(ctx, tn_done_variable(ctx, i), tn_done_variable(ctx, i + 1));
+    Z3_ast result = Z3_mk_and(ctx, num_constraints, constraints);
+    memory_free(constraints);
+    return result;
+}
+
+int tn_get_length_from_model(Z3_context ctx, Z3_model model, int length)
+{
+    for (int pos = 1; pos < length; pos++)
+        if (value_of_var_in_model(ctx, model, tn_done_variable(ctx, pos)))
+            return pos;
+    return length;
+}
+
+Z3_ast tn_reduction_guarded(Z3_context ctx, const TunnelNetwork network, int length, const int *support_offsets, const int *support)
+{
+    int num_nodes = tn_get_num_nodes(network);
+    Z3_ast constraints[] = {tn_bounded_positions(ctx, num_nodes, length),
+                            tn_guarded_transitions(ctx, network, length, support_offsets, support, true, false),
+                            tn_bounded_simple_path(ctx, num_nodes, length, false),
+                            tn_4_variable(ctx, 0, 0),
+                            tn_4_variable(ctx, length, 0)};
+    return Z3_mk_and(ctx, 5, constraints);
+}
+
+int tn_reduction_network_literals(Z3_context ctx, const TunnelNetwork network, const int *support_offsets, const int *support, Z3_ast *literals)
+{
+    const tn_compiled *view = tn_compile(network);
+    int num_nodes = view->num_nodes;
+    int num_literals = 0;
+    for (int source = 0; source < num_nodes; source++)
+        for (int k = support_offsets[source]; k < support_offsets[source + 1]; k++)
+        {
+            Z3_ast edge = tn_edge_variable(ctx, source, support[k]);
+            literals[num_literals++] = view->edges[source * num_nodes + support[k]] ? edge : Z3_mk_not(ctx, edge);
+        }
+    for (int node = 0; node < num_nodes; node++)
+        for (stack_action action = 0; action < NumActions; action++)
+        {
+            Z3_ast has_action = tn_action_variable(ctx, node, action);
+            literals[num_literals++] = (view->actions[node] & (1 << action)) ? has_action : Z3_mk_not(ctx, has_action);
+        }
+    return num_literals;
+}
+
+Z3_ast tn_reduction_first_frame(Z3_context ctx, const TunnelNetwork network, int stack_size)
+{
+    return Z3_mk_and(ctx, 2, (Z3_ast[]){tn_position_constraints(ctx, tn_get_num_nodes(network), 0, tn_frame_top_height(0, stack_size) + 1), tn_4_variable(ctx, 0, 0)});
+}
+
+Z3_ast tn_reduction_frame(Z3_context ctx, const TunnelNetwork network, int pos, int stack_size)
+{
+    const tn_compiled *view = tn_compile(network);
+    int num_nodes = view->num_nodes;
+    int top = tn_frame_top_height(pos, stack_size);
+    int previous_top = tn_frame_top_height(pos - 1, stack_size);
+    Z3_ast *constraints = tn_scratch_array(tn_step_transitions_size(num_nodes, view->num_edges, previous_top) + (long)num_nodes * (top + 1) * pos + 1);
+    int num_constraints = tn_step_transitions(ctx, network, pos - 1, previous_top, top, view->succ_offsets, view->succ, false, false, constraints);
+    constraints[num_constraints++] = tn_position_constraints(ctx, num_nodes, pos, top + 1);
+    // φ₈ between the new position and the previous ones.
+    for (int node = 0; node < num_nodes; node++)
+        for (int j = 0; j < pos; j++)
+            for (int h = 0; h <= top && h <= tn_frame_top_height(j, stack_size); h++)
+                constraints[num_constraints++] = Z3_mk_not(ctx, Z3_mk_and(ctx, 2, (Z3_ast[]){tn_path_variable(ctx, node, j, h), tn_path_variable(ctx, node, pos, h)}));
+    Z3_ast result = Z3_mk_and(ctx, num_constraints, constraints);
+    memory_free(constraints);
+    return result;
+}
+
+void tn_reduction_final_frame(Z3_context ctx, int target, int pos, Z3_ast *literals)
+{
+    literals[0] = tn_path_variable(ctx, target, pos, 0);
+    literals[1] = tn_4_variable(ctx, pos, 0);
+}
+
+char *tn_family_name(int family)
+{
+    char *names[TN_NUM_FAMILIES] = {"phi_1", "phi_2", "phi_3", "phi_4", "phi_6", "phi_8"};
+    if (family < 0 || family >= TN_NUM_FAMILIES)
+        return "";
+    return names[family];
+}
+
+Z3_ast tn_reduction_family(Z3_context ctx, const TunnelNetwork network, int length, int family)
+{
+    switch (family)
+    {
+    case 0:
+        return unicité(ctx, network, length);
+    case 1:
+        return contrainte_depart_arrivee(ctx, network, length);
+    case 2:
+        return creer_contraintes_transitions(ctx, network, length);
+    case 3:
+        return creer_contrainte_pile_bien_definie(ctx, network, length);
+    case 4:
+        return create_stack_evolution_constraint(ctx, network, length);
+    case 5:
+        return create_simple_path_constraint(ctx, network, length);
+    }
+    return Z3_mk_true(ctx);
+}
+
+Z3_ast tn_reduction(Z3_context ctx, const TunnelNetwork network, int length)
+{
+#ifdef DEBUG
+    printf("=== DEBUT tn_reduction, length=%d ===\n", length);
     printf("Noeud initial: %d (%s)\n", tn_get_initial(network), tn_get_node_name(network, tn_get_initial(network)));
     printf("Noeud final: %d (%s)\n", tn_get_final(network), tn_get_node_name(network, tn_get_final(network)));
     printf("Nombre de noeuds: %d\n", tn_get_num_nodes(network));
-    
+
     // Afficher toutes les arêtes
     int num_nodes = tn_get_num_nodes(network);
     printf("Arêtes:\n");
@@ -729,45 +1201,45 @@ Z3_ast tn_reduction(Z3_context ctx, const TunnelNetwork network, int length){
         }
     }
     fflush(stdout);
-    
-    printf("Création phi_1...\n");
-    fflush(stdout);
-    Z3_ast phi_1 = unicité(ctx, network, length);
-    
-    printf("Création phi_2...\n");
-    fflush(stdout);
-    Z3_ast phi_2 = contrainte_depart_arrivee(ctx, network, length);
-    
-    printf("Création phi_3...\n");
-    fflush(stdout);
-    Z3_ast phi_3 = creer_contraintes_transitions(ctx, network, length);
-    
-    printf("Création phi_4...\n");
-    fflush(stdout);
-    Z3_ast phi_4 = creer_contrainte_pile_bien_definie(ctx, network, length);
-    
-    printf("Création phi_6...\n");
-    fflush(stdout);
-    Z3_ast phi_6 = create_stack_evolution_constraint(ctx, network, length);
-    
-    printf("Création phi_8...\n");
-    fflush(stdout);
-    Z3_ast phi_8 = create_simple_path_constraint(ctx, network, length);
-    
-    printf("Assemblage...\n");
-    fflush(stdout);
-    Z3_ast constraints[6] = {phi_1, phi_2, phi_3, phi_4, phi_6, phi_8};
-    
-    printf("=== FIN tn_reduction ===\n");
-    fflush(stdout);
-    return Z3_mk_and(ctx, 6, constraints);
+#endif
+
+    Z3_ast constraints[TN_NUM_FAMILIES];
+    for (int family = 0; family < TN_NUM_FAMILIES; family++)
+    {
+#ifdef DEBUG
+        printf("Création %s...\n", tn_family_name(family));
+        fflush(stdout);
+#endif
+        constraints[family] = tn_reduction_family(ctx, network, length, family);
+    }
+    return Z3_mk_and(ctx, TN_NUM_FAMILIES, constraints);
 }
+
+Z3_ast tn_reduction_without_endpoints(Z3_context ctx, const TunnelNetwork network, int length)
+{
+    const tn_compiled *view = tn_compile(network);
+    Z3_ast constraints[] = {tn_bounded_positions(ctx, view->num_nodes, length),
+                            tn_guarded_transitions(ctx, network, length, view->succ_offsets, view->succ, false, false),
+                            tn_bounded_simple_path(ctx, view->num_nodes, length, false),
+                            tn_4_variable(ctx, 0, 0),
+                            tn_4_variable(ctx, length, 0)};
+    return Z3_mk_and(ctx, 5, constraints);
+}
+
+void tn_reduction_endpoints(Z3_context ctx, int source, int target, int length, Z3_ast *literals)
+{
+    literals[0] = tn_path_variable(ctx, source, 0, 0);
+    literals[1] = tn_path_variable(ctx, target, length, 0);
+}
+
 void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int bound, tn_step *path)
 {
     int num_nodes = tn_get_num_nodes(network);
     int stack_size = get_stack_size(bound);
     
+#ifdef DEBUG
     printf("\n=== DEBUG tn_get_path_from_model ===\n");
+#endif
     
     for (int pos = 0; pos < bound; pos++)
     {
@@ -784,25 +1256,31 @@ void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork networ
                 {
                     src = n;
                     src_height = height;
+#ifdef DEBUG
                     printf("Position %d: noeud %s (id=%d) hauteur %d\n", 
                            pos, tn_get_node_name(network, n), n, height);
+#endif
                 }
                 if (value_of_var_in_model(ctx, model, tn_path_variable(ctx, n, pos + 1, height)))
                 {
                     tgt = n;
                     tgt_height = height;
+#ifdef DEBUG
                     if (pos == bound - 1) {
                         printf("Position %d: noeud %s (id=%d) hauteur %d\n", 
                                pos + 1, tn_get_node_name(network, n), n, height);
                     }
+#endif
                 }
             }
         }
         
+#ifdef DEBUG
         printf("Transition %d: %s(h=%d) -> %s(h=%d)\n", 
                pos, 
                tn_get_node_name(network, src), src_height,
                tn_get_node_name(network, tgt), tgt_height);
+#endif
         
         int action = 0;
         if (src_height == tgt_height)
@@ -841,11 +1319,15 @@ void tn_get_path_from_model(Z3_context ctx, Z3_model model, TunnelNetwork networ
                 action = pop_6_6;
         }
         
+#ifdef DEBUG
         printf("Action: %s\n", tn_string_of_stack_action(action));
+#endif
         path[pos] = tn_step_create(action, src, tgt);
     }
     
+#ifdef DEBUG
     printf("=== FIN DEBUG ===\n\n");
+#endif
 }
 void tn_print_model(Z3_context ctx, Z3_model model, TunnelNetwork network, int bound)
 {
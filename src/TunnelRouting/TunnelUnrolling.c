@@ -0,0 +1,96 @@
+#include "TunnelUnrolling.h"
+#include "TunnelReduction.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+struct TunnelUnrolling_s
+{
+    Z3_context ctx;        ///< The solver context.
+    TunnelNetwork network; ///< The network.
+    Z3Session session;     ///< The session containing the first frame and frames 1 to num_frames.
+    int max_length;        ///< The largest size allowed.
+    int stack_size;        ///< The number of cells of the stack in every frame.
+    int num_frames;        ///< The number of frames added after the first one.
+};
+
+TunnelUnrolling tn_unrolling_create(Z3_context ctx, TunnelNetwork network, int max_length)
+{
+    TunnelUnrolling unrolling = (TunnelUnrolling)malloc(sizeof(*unrolling));
+    unrolling->ctx = ctx;
+    unrolling->network = network;
+    unrolling->session = session_create(ctx);
+    unrolling->max_length = max_length;
+    unrolling->stack_size = get_stack_size(max_length);
+    unrolling->num_frames = 0;
+    session_assert(unrolling->session, tn_reduction_first_frame(ctx, network, unrolling->stack_size));
+    return unrolling;
+}
+
+/**
+ * @brief Returns the variable "frame @p pos is part of the path". Each frame is asserted under its variable, which implies the one of the previous frame,
+ *        so that a query for size l only assumes the variable of frame l, and the frames after l (built for another query) do not constrain it.
+ *
+ * @param ctx The solver context.
+ * @param pos The position of the frame.
+ * @return Z3_ast
+ */
+static Z3_ast tn_frame_variable(Z3_context ctx, int pos)
+{
+    char name[40];
+    snprintf(name, 40, "frame %d active", pos);
+    return mk_bool_var(ctx, name);
+}
+
+void tn_unrolling_delete(TunnelUnrolling unrolling)
+{
+    session_delete(unrolling->session);
+    free(unrolling);
+}
+
+Z3_lbool tn_unrolling_check(TunnelUnrolling unrolling, int source, int target, int length, tn_step *path)
+{
+    if (length > unrolling->max_length)
+    {
+        fprintf(stderr, "Error: size %d is larger than the size %d the unrolling was created for.\n", length, unrolling->max_length);
+        exit(EXIT_FAILURE);
+    }
+    for (int pos = unrolling->num_frames + 1; pos <= length; pos++)
+    {
+        Z3_ast active = tn_frame_variable(unrolling->ctx, pos);
+        session_assert(unrolling->session, Z3_mk_implies(unrolling->ctx, active, tn_reduction_frame(unrolling->ctx, unrolling->network, pos, unrolling->stack_size)));
+        if (pos > 1)
+            session_assert(unrolling->session, Z3_mk_implies(unrolling->ctx, active, tn_frame_variable(unrolling->ctx, pos - 1)));
+        unrolling->num_frames = pos;
+    }
+    Z3_ast assumptions[4];
+    assumptions[0] = tn_path_variable(unrolling->ctx, source, 0, 0);
+    tn_reduction_final_frame(unrolling->ctx, target, length, assumptions + 1);
+    assumptions[3] = tn_frame_variable(unrolling->ctx, length);
+    Z3_lbool result = session_check_assumptions(unrolling->session, 4, assumptions);
+    if (result == Z3_L_TRUE)
+        tn_get_path_from_model(unrolling->ctx, session_get_model(unrolling->session), unrolling->network, length, path);
+    return result;
+}
+
+int tn_unrolling_solve(TunnelUnrolling unrolling, int source, int target, int bound, tn_step *path)
+{
+    for (int length = 1; length <= bound; length++)
+    {
+        Z3_lbool result = tn_unrolling_check(unrolling, source, target, length, path);
+        if (result == Z3_L_TRUE)
+            return length;
+        if (result == Z3_L_UNDEF)
+            return -1;
+    }
+    return 0;
+}
+
+int tn_unrolling_num_frames(TunnelUnrolling unrolling)
+{
+    return unrolling->num_frames;
+}
+
+Z3Session tn_unrolling_get_session(TunnelUnrolling unrolling)
+{
+    return unrolling->session;
+}
@@ -12,6 +12,7 @@
  */
 
 #include "Graph.h"
+#include "Memory.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -20,10 +21,10 @@ parameterList *parameter_list_add_parameter(parameterList *list, char *name, cha
 {
 	if (list == NULL)
 	{
-		list = (parameterList *)malloc(sizeof(parameterList));
-		list->name = (char *)malloc((strlen(name) + 1) * sizeof(char));
+		list = (parameterList *)memory_malloc(sizeof(parameterList), MemoryGraph);
+		list->name = (char *)memory_malloc((strlen(name) + 1) * sizeof(char), MemoryGraph);
 		strcpy(list->name, name);
-		list->value = (char *)malloc((strlen(value) + 1) * sizeof(char));
+		list->value = (char *)memory_malloc((strlen(value) + 1) * sizeof(char), MemoryGraph);
 		strcpy(list->value, value);
 		list->next = NULL;
 		return list;
@@ -50,10 +51,10 @@ parameterList *parameter_list_copy(parameterList *source)
 {
 	if (source == NULL)
 		return NULL;
-	parameterList *result = (parameterList *)malloc(sizeof(parameterList));
-	result->name = (char *)malloc((strlen(source->name) + 1) * sizeof(char));
+	parameterList *result = (parameterList *)memory_malloc(sizeof(parameterList), MemoryGraph);
+	result->name = (char *)memory_malloc((strlen(source->name) + 1) * sizeof(char), MemoryGraph);
 	strcpy(result->name, source->name);
-	result->value = (char *)malloc((strlen(source->value) + 1) * sizeof(char));
+	result->value = (char *)memory_malloc((strlen(source->value) + 1) * sizeof(char), MemoryGraph);
 	strcpy(result->value, source->value);
 	result->next = parameter_list_copy(source->next);
 	return result;
@@ -77,9 +78,9 @@ void parameter_list_delete(parameterList *list)
 	if (list == NULL)
 		return;
 	parameter_list_delete(list->next);
-	free(list->name);
-	free(list->value);
-	free(list);
+	memory_free(list->name);
+	memory_free(list->value);
+	memory_free(list);
 }
 
 void graph_print(Graph graph)
@@ -121,45 +122,104 @@ Graph graph_copy(Graph graph)
 	copy.name = graph.name;
 	copy.numNodes = graph.numNodes;
 	copy.numEdges = graph.numEdges;
-	copy.nodes = (char **)malloc(copy.numNodes * sizeof(char *));
-	copy.edges = (bool *)malloc(copy.numNodes * copy.numNodes * sizeof(bool));
+	copy.nodes = (char **)memory_malloc(copy.numNodes * sizeof(char *), MemoryGraph);
+	copy.edges = (bool *)memory_malloc(copy.numNodes * copy.numNodes * sizeof(bool), MemoryGraph);
 
 	for (int i = 0; i < copy.numNodes * copy.numNodes; i++)
 		copy.edges[i] = graph.edges[i];
 
-	copy.parameters = (parameterList **)malloc(graph.numNodes * sizeof(parameterList *));
+	copy.parameters = (parameterList **)memory_malloc(graph.numNodes * sizeof(parameterList *), MemoryGraph);
 	for (int i = 0; i < graph.numNodes; i++)
 		copy.parameters[i] = parameter_list_copy(graph.parameters[i]);
 
-	copy.edge_parameters = (parameterList **)malloc(graph.numNodes * graph.numNodes * sizeof(parameterList *));
+	copy.edge_parameters = (parameterList **)memory_malloc(graph.numNodes * graph.numNodes * sizeof(parameterList *), MemoryGraph);
 	for (int i = 0; i < graph.numNodes * graph.numNodes; i++)
 		copy.edge_parameters[i] = parameter_list_copy(graph.edge_parameters[i]);
 
 	return copy;
 }
 
+Graph graph_induced_subgraph(Graph graph, const int *nodes, int num_nodes)
+{
+	Graph result;
+	result.name = (char *)malloc((strlen(graph.name) + 1) * sizeof(char));
+	strcpy(result.name, graph.name);
+	result.numNodes = num_nodes;
+	result.numEdges = 0;
+	result.nodes = (char **)memory_malloc(num_nodes * sizeof(char *), MemoryGraph);
+	result.parameters = (parameterList **)memory_malloc(num_nodes * sizeof(parameterList *), MemoryGraph);
+	result.edges = (bool *)memory_malloc(num_nodes * num_nodes * sizeof(bool), MemoryGraph);
+	result.edge_parameters = (parameterList **)memory_malloc(num_nodes * num_nodes * sizeof(parameterList *), MemoryGraph);
+	for (int i = 0; i < num_nodes; i++)
+	{
+		result.nodes[i] = (char *)memory_malloc((strlen(graph.nodes[nodes[i]]) + 1) * sizeof(char), MemoryGraph);
+		strcpy(result.nodes[i], graph.nodes[nodes[i]]);
+		result.parameters[i] = parameter_list_copy(graph.parameters[nodes[i]]);
+		for (int j = 0; j < num_nodes; j++)
+		{
+			int original = nodes[i] * graph.numNodes + nodes[j];
+			result.edges[i * num_nodes + j] = graph.edges[original];
+			result.edge_parameters[i * num_nodes + j] = parameter_list_copy(graph.edge_parameters[original]);
+			// Each pair of adjacent nodes is counted once, as the parser does for an undirected graph.
+			if (j >= i && (graph.edges[original] || graph.edges[nodes[j] * graph.numNodes + nodes[i]]))
+				result.numEdges++;
+		}
+	}
+	return result;
+}
+
+int graph_components(Graph graph, int *component)
+{
+	int num_nodes = graph.numNodes;
+	for (int node = 0; node < num_nodes; node++)
+		component[node] = -1;
+	int *stack = (int *)malloc((num_nodes + 1) * sizeof(int));
+	int num_components = 0;
+	for (int root = 0; root < num_nodes; root++)
+	{
+		if (component[root] >= 0)
+			continue;
+		int size = 0;
+		stack[size++] = root;
+		component[root] = num_components;
+		while (size > 0)
+		{
+			int node = stack[--size];
+			for (int other = 0; other < num_nodes; other++)
+				if (component[other] < 0 && (graph.edges[node * num_nodes + other] || graph.edges[other * num_nodes + node]))
+				{
+					component[other] = num_components;
+					stack[size++] = other;
+				}
+		}
+		num_components++;
+	}
+	free(stack);
+	return num_components;
+}
+
 void graph_delete(Graph graph)
 {
 	if (graph.edges != NULL)
-		free(graph.edges);
+		memory_free(graph.edges);
 	if (graph.nodes != NULL)
 	{
 		for (int i = 0; i < graph.numNodes; i++)
 		{
 			if (graph.nodes[i] != NULL)
-				free(graph.nodes[i]);
+				memory_free(graph.nodes[i]);
 		}
-		free(graph.nodes);
+		memory_free(graph.nodes);
 	}
 	// Pour les automates.
 
 	for (int i = 0; i < graph.numNodes; i++)
 		parameter_list_delete(graph.parameters[i]);
-	free(graph.parameters);
+	memory_free(graph.parameters);
 
 	for (int i = 0; i < graph.numNodes * graph.numNodes; i++)
 		parameter_list_delete(graph.edge_parameters[i]);
-	free(graph.edge_parameters);
+	memory_free(graph.edge_parameters);
 
 	graph.numEdges = 0;
 	graph.numNodes = 0;
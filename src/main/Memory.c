@@ -0,0 +1,229 @@
+#include "Memory.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Bytes currently allocated in each category, and all categories together (last cell).
+ *
+ */
+static size_t current[MemoryNumCategories + 1];
+
+/**
+ * @brief Peak of current since the start or the last memory_reset_peaks.
+ *
+ */
+static size_t peak[MemoryNumCategories + 1];
+
+#ifdef MEMORY_ACCOUNTING
+
+/**
+ * @brief Header put before each counted allocation. Its size keeps the memory returned aligned as malloc's.
+ *
+ */
+typedef union
+{
+    struct
+    {
+        size_t size;              ///< Size asked by the user.
+        memory_category category; ///< Category it is counted in.
+    } info;
+    max_align_t alignment; ///< Unused, only there for the size of the union.
+} memory_header;
+
+/**
+ * @brief Adds @p delta to the counter @p index and updates its peak. Safe to call from several threads.
+ *
+ * @param index A category, or MemoryNumCategories for the total.
+ * @param delta The number of bytes allocated (or freed, as a negative value).
+ */
+static void memory_count(int index, ptrdiff_t delta)
+{
+    size_t value = __atomic_add_fetch(&current[index], (size_t)delta, __ATOMIC_RELAXED);
+    if (delta <= 0)
+        return;
+    size_t old_peak = __atomic_load_n(&peak[index], __ATOMIC_RELAXED);
+    while (value > old_peak && !__atomic_compare_exchange_n(&peak[index], &old_peak, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+/**
+ * @brief Counts an allocation of @p size bytes in @p category (or a free if @p sign is -1).
+ *
+ * @param size A size.
+ * @param category A category.
+ * @param sign 1 for an allocation, -1 for a free.
+ */
+static void memory_account(size_t size, memory_category category, int sign)
+{
+    memory_count(category, sign * (ptrdiff_t)size);
+    memory_count(MemoryNumCategories, sign * (ptrdiff_t)size);
+}
+
+/**
+ * @brief Fills the header at @p block and returns the memory given to the user.
+ *
+ * @param block A block of size sizeof(memory_header) + @p size.
+ * @param size The size asked by the user.
+ * @param category Its category.
+ * @return void* The memory after the header.
+ */
+static void *memory_register(memory_header *block, size_t size, memory_category category)
+{
+    if (block == NULL)
+        return NULL;
+    block->info.size = size;
+    block->info.category = category;
+    memory_account(size, category, 1);
+    return block + 1;
+}
+
+void *memory_malloc(size_t size, memory_category category)
+{
+    return memory_register((memory_header *)malloc(sizeof(memory_header) + size), size, category);
+}
+
+void *memory_calloc(size_t num, size_t size, memory_category category)
+{
+    if (size != 0 && num > (SIZE_MAX - sizeof(memory_header)) / size)
+        return NULL;
+    return memory_register((memory_header *)calloc(1, sizeof(memory_header) + num * size), num * size, category);
+}
+
+void *memory_realloc(void *pointer, size_t size, memory_category category)
+{
+    if (pointer == NULL)
+        return memory_malloc(size, category);
+    memory_header *block = (memory_header *)pointer - 1;
+    size_t old_size = block->info.size;
+    memory_category old_category = block->info.category;
+    memory_header *resized = (memory_header *)realloc(block, sizeof(memory_header) + size);
+    if (resized == NULL)
+        return NULL;
+    memory_account(old_size, old_category, -1);
+    return memory_register(resized, size, category);
+}
+
+void memory_free(void *pointer)
+{
+    if (pointer == NULL)
+        return;
+    memory_header *block = (memory_header *)pointer - 1;
+    memory_account(block->info.size, block->info.category, -1);
+    free(block);
+}
+
+#endif
+
+bool memory_accounting_enabled(void)
+{
+#ifdef MEMORY_ACCOUNTING
+    return true;
+#else
+    return false;
+#endif
+}
+
+char *memory_category_name(memory_category category)
+{
+    static char *names[MemoryNumCategories] = {"graph", "parser", "reduction"};
+    return names[category];
+}
+
+size_t memory_current(memory_category category)
+{
+    return __atomic_load_n(&current[category], __ATOMIC_RELAXED);
+}
+
+size_t memory_peak(memory_category category)
+{
+    return __atomic_load_n(&peak[category], __ATOMIC_RELAXED);
+}
+
+size_t memory_total_peak(void)
+{
+    return __atomic_load_n(&peak[MemoryNumCategories], __ATOMIC_RELAXED);
+}
+
+void memory_reset_peaks(void)
+{
+    for (int i = 0; i <= MemoryNumCategories; i++)
+        __atomic_store_n(&peak[i], __atomic_load_n(&current[i], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Reads the field @p key (in KiB) of /proc/self/status.
+ *
+ * @param key The name of the field, with its colon ("VmRSS:").
+ * @return long Its value, or -1 if it cannot be read.
+ */
+static long read_status_field(const char *key)
+{
+    FILE *status = fopen("/proc/self/status", "r");
+    if (status == NULL)
+        return -1;
+    char line[256];
+    long value = -1;
+    size_t key_length = strlen(key);
+    while (fgets(line, sizeof(line), status) != NULL)
+    {
+        if (strncmp(line, key, key_length) == 0)
+        {
+            value = strtol(line + key_length, NULL, 10);
+            break;
+        }
+    }
+    fclose(status);
+    return value;
+}
+
+long memory_rss(void)
+{
+    return read_status_field("VmRSS:");
+}
+
+long memory_rss_peak(void)
+{
+    return read_status_field("VmHWM:");
+}
+
+bool memory_reset_rss_peak(void)
+{
+    FILE *clear_refs = fopen("/proc/self/clear_refs", "w");
+    if (clear_refs == NULL)
+        return false;
+    bool written = fputs("5", clear_refs) >= 0;
+    return fclose(clear_refs) == 0 && written;
+}
+
+/**
+ * @brief Number of memory_concurrency_begin not yet ended.
+ *
+ */
+static int concurrent_sections = 0;
+
+void memory_concurrency_begin(void)
+{
+    __atomic_add_fetch(&concurrent_sections, 1, __ATOMIC_RELAXED);
+}
+
+void memory_concurrency_end(void)
+{
+    __atomic_sub_fetch(&concurrent_sections, 1, __ATOMIC_RELAXED);
+}
+
+memory_usage memory_phase_end(void)
+{
+    memory_usage usage;
+    usage.rss_peak = memory_rss_peak();
+    for (int i = 0; i < MemoryNumCategories; i++)
+        usage.heap_peak[i] = memory_peak(i);
+    usage.shared = __atomic_load_n(&concurrent_sections, __ATOMIC_RELAXED) > 0;
+    if (!usage.shared)
+    {
+        memory_reset_rss_peak();
+        memory_reset_peaks();
+    }
+    return usage;
+}
@@ -0,0 +1,284 @@
+#include "Metrics.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/**
+ * @brief Maximal length of the name of a measure.
+ *
+ */
+#define MetricNameSize 64
+
+/**
+ * @brief A named measure: a phase (wall and cpu used), a counter (value used) or a label (text used).
+ *
+ */
+typedef struct
+{
+    char name[MetricNameSize]; ///< The name of the measure.
+    double wall;               ///< Wall-clock duration (phases) or value (counters).
+    double cpu;                ///< CPU duration (phases).
+    char *text;                ///< Value (labels).
+    bool has_memory;           ///< True if memory is known (phases).
+    memory_usage memory;       ///< Memory used (phases).
+} metric_entry;
+
+/**
+ * @brief A growable array of measures, kept in insertion order.
+ *
+ */
+typedef struct
+{
+    metric_entry *entries; ///< The measures.
+    int size;              ///< Number of measures.
+    int capacity;          ///< Allocated size of entries.
+} metric_list;
+
+struct Metrics_s
+{
+    metric_list labels;   ///< Textual information.
+    metric_list phases;   ///< Timed phases.
+    metric_list counters; ///< Numerical information.
+    metric_list solver;   ///< Statistics of the SAT solver.
+};
+
+/**
+ * @brief Reads the clock @p clock_id in seconds.
+ *
+ * @param clock_id A clock of clock_gettime.
+ * @return double Its value.
+ */
+double read_clock(clockid_t clock_id)
+{
+    struct timespec now;
+    clock_gettime(clock_id, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+time_point time_now(void)
+{
+    time_point result;
+    result.wall = read_clock(CLOCK_MONOTONIC);
+    result.cpu = read_clock(CLOCK_PROCESS_CPUTIME_ID);
+    return result;
+}
+
+double time_elapsed(time_point start)
+{
+    return read_clock(CLOCK_MONOTONIC) - start.wall;
+}
+
+Metrics metrics_create(void)
+{
+    Metrics metrics = (Metrics)calloc(1, sizeof(*metrics));
+    return metrics;
+}
+
+/**
+ * @brief Empties @p list (keeps its memory).
+ *
+ * @param list A list of measures.
+ */
+void metric_list_clear(metric_list *list)
+{
+    for (int i = 0; i < list->size; i++)
+        free(list->entries[i].text);
+    list->size = 0;
+}
+
+void metrics_delete(Metrics metrics)
+{
+    metrics_reset(metrics);
+    free(metrics->labels.entries);
+    free(metrics->phases.entries);
+    free(metrics->counters.entries);
+    free(metrics->solver.entries);
+    free(metrics);
+}
+
+void metrics_reset(Metrics metrics)
+{
+    metric_list_clear(&metrics->labels);
+    metric_list_clear(&metrics->phases);
+    metric_list_clear(&metrics->counters);
+    metric_list_clear(&metrics->solver);
+}
+
+/**
+ * @brief Returns the measure named @p name in @p list, adding it (zeroed) at the end if not present.
+ *
+ * @param list A list of measures.
+ * @param name A name.
+ * @param replace If false, a new entry is always added (phases can be repeated).
+ * @return metric_entry* The measure.
+ */
+metric_entry *metric_list_get(metric_list *list, const char *name, bool replace)
+{
+    if (replace)
+        for (int i = 0; i < list->size; i++)
+            if (strcmp(list->entries[i].name, name) == 0)
+                return &list->entries[i];
+    if (list->size == list->capacity)
+    {
+        list->capacity = list->capacity == 0 ? 16 : 2 * list->capacity;
+        list->entries = (metric_entry *)realloc(list->entries, list->capacity * sizeof(metric_entry));
+    }
+    metric_entry *entry = &list->entries[list->size++];
+    snprintf(entry->name, MetricNameSize, "%s", name);
+    entry->wall = 0;
+    entry->cpu = 0;
+    entry->text = NULL;
+    entry->has_memory = false;
+    return entry;
+}
+
+void metrics_set_label(Metrics metrics, const char *name, const char *value)
+{
+    metric_entry *entry = metric_list_get(&metrics->labels, name, true);
+    free(entry->text);
+    entry->text = (char *)malloc((strlen(value) + 1) * sizeof(char));
+    strcpy(entry->text, value);
+}
+
+void metrics_set_counter(Metrics metrics, const char *name, double value)
+{
+    metric_list_get(&metrics->counters, name, true)->wall = value;
+}
+
+void metrics_add_phase(Metrics metrics, const char *name, time_point start)
+{
+    time_point end = time_now();
+    memory_usage memory = memory_phase_end();
+    metrics_add_phase_duration(metrics, name, end.wall - start.wall, end.cpu - start.cpu, &memory);
+}
+
+void metrics_add_phase_duration(Metrics metrics, const char *name, double wall, double cpu, const memory_usage *memory)
+{
+    metric_entry *entry = metric_list_get(&metrics->phases, name, false);
+    entry->wall = wall;
+    entry->cpu = cpu;
+    if (memory != NULL)
+    {
+        entry->has_memory = true;
+        entry->memory = *memory;
+    }
+}
+
+void metrics_add_formula_size(Metrics metrics, Z3_context ctx, const char *family, Z3_ast formula)
+{
+    int num_variables, num_clauses;
+    formula_size(ctx, formula, &num_variables, &num_clauses);
+    char name[MetricNameSize];
+    snprintf(name, MetricNameSize, "%s.variables", family);
+    metrics_set_counter(metrics, name, num_variables);
+    snprintf(name, MetricNameSize, "%s.clauses", family);
+    metrics_set_counter(metrics, name, num_clauses);
+}
+
+void metrics_add_session_statistics(Metrics metrics, Z3Session session)
+{
+    const char *keys[] = {"conflicts", "decisions", "propagations", "memory", "max memory"};
+    for (int i = 0; i < 5; i++)
+        metric_list_get(&metrics->solver, keys[i], true)->wall = session_get_statistic(session, keys[i]);
+}
+
+void print_json_string(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '"' || *text == '\\')
+            fputc('\\', file);
+        if ((unsigned char)*text < 0x20)
+            fprintf(file, "\\u%04x", *text);
+        else
+            fputc(*text, file);
+    }
+    fputc('"', file);
+}
+
+void print_json_number(FILE *file, const char *format, double value)
+{
+    if (isfinite(value))
+        fprintf(file, format, value);
+    else
+        fputs("null", file);
+}
+
+/**
+ * @brief Writes the numerical measures of @p list as a JSON object in @p file.
+ *
+ * @param file A file.
+ * @param list A list of measures.
+ */
+void print_json_values(FILE *file, metric_list *list)
+{
+    fputc('{', file);
+    for (int i = 0; i < list->size; i++)
+    {
+        if (i > 0)
+            fputc(',', file);
+        print_json_string(file, list->entries[i].name);
+        fputc(':', file);
+        print_json_number(file, "%.15g", list->entries[i].wall);
+    }
+    fputc('}', file);
+}
+
+/**
+ * @brief Writes the memory used by a phase as JSON members (starting with a comma) in @p file.
+ *
+ * @param file A file.
+ * @param memory The memory used.
+ */
+void print_json_memory(FILE *file, const memory_usage *memory)
+{
+    fprintf(file, ",\"rss_peak\":%ld", memory->rss_peak);
+    // Peaks measured while other threads were working are those of the whole run.
+    if (memory->shared)
+        fprintf(file, ",\"peak_scope\":\"process\"");
+    if (!memory_accounting_enabled())
+        return;
+    fprintf(file, ",\"heap_peak\":{");
+    for (int category = 0; category < MemoryNumCategories; category++)
+        fprintf(file, "%s\"%s\":%zu", category > 0 ? "," : "", memory_category_name(category), memory->heap_peak[category]);
+    fputc('}', file);
+}
+
+void metrics_print_json(Metrics metrics, FILE *file)
+{
+    fputc('{', file);
+    for (int i = 0; i < metrics->labels.size; i++)
+    {
+        print_json_string(file, metrics->labels.entries[i].name);
+        fputc(':', file);
+        print_json_string(file, metrics->labels.entries[i].text);
+        fputc(',', file);
+    }
+    fprintf(file, "\"phases\":[");
+    for (int i = 0; i < metrics->phases.size; i++)
+    {
+        if (i > 0)
+            fputc(',', file);
+        fprintf(file, "{\"name\":");
+        print_json_string(file, metrics->phases.entries[i].name);
+        fprintf(file, ",\"wall\":");
+        print_json_number(file, "%.9f", metrics->phases.entries[i].wall);
+        fprintf(file, ",\"cpu\":");
+        print_json_number(file, "%.9f", metrics->phases.entries[i].cpu);
+        if (metrics->phases.entries[i].has_memory)
+            print_json_memory(file, &metrics->phases.entries[i].memory);
+        fputc('}', file);
+    }
+    fprintf(file, "],\"counters\":");
+    print_json_values(file, &metrics->counters);
+    fprintf(file, ",\"solver\":");
+    print_json_values(file, &metrics->solver);
+    fprintf(file, ",\"memory\":{\"rss\":%ld", memory_rss());
+    if (memory_accounting_enabled())
+        for (int category = 0; category < MemoryNumCategories; category++)
+            fprintf(file, ",\"%s\":%zu", memory_category_name(category), memory_current(category));
+    fprintf(file, "}}\n");
+    fflush(file);
+}
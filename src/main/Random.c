@@ -0,0 +1,31 @@
+#include "Random.h"
+
+void random_seed(random_generator *generator, unsigned long long seed)
+{
+    // splitmix64 step, so that close seeds give unrelated sequences.
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    generator->state = z == 0 ? 0x9E3779B97F4A7C15ULL : z;
+}
+
+unsigned long long random_next(random_generator *generator)
+{
+    unsigned long long x = generator->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    generator->state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+int random_int(random_generator *generator, int bound)
+{
+    return (int)((random_next(generator) >> 11) % (unsigned long long)bound);
+}
+
+double random_double(random_generator *generator)
+{
+    return (random_next(generator) >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,160 @@
+#include "ThreadPool.h"
+#include "Memory.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @brief A submitted task, in the queue of the pool.
+ *
+ */
+typedef struct thread_pool_job_s
+{
+    thread_pool_task task;          ///< The function to run.
+    void *argument;                 ///< Its argument.
+    struct thread_pool_job_s *next; ///< The next task in the queue.
+} thread_pool_job;
+
+/**
+ * @brief A worker thread and its index.
+ *
+ */
+typedef struct
+{
+    pthread_t thread; ///< The thread.
+    int index;        ///< Its index in the pool.
+    ThreadPool pool;  ///< The pool it belongs to.
+} thread_pool_worker;
+
+struct ThreadPool_s
+{
+    pthread_mutex_t lock;        ///< Protects everything below.
+    pthread_cond_t available;    ///< Signaled when a task is queued or the pool stops.
+    pthread_cond_t idle;         ///< Signaled when the last pending task is done.
+    thread_pool_job *head;       ///< First task of the queue (NULL if empty).
+    thread_pool_job *tail;       ///< Last task of the queue.
+    int pending;                 ///< Number of tasks submitted and not done yet (queued or running).
+    bool stopping;               ///< Set by thread_pool_delete to make the workers return.
+    int num_workers;             ///< Number of workers.
+    thread_pool_worker *workers; ///< The workers.
+};
+
+/**
+ * @brief Main loop of a worker: takes the tasks of the queue one by one until the pool stops.
+ *
+ * @param argument The thread_pool_worker.
+ * @return void* NULL.
+ */
+static void *thread_pool_worker_loop(void *argument)
+{
+    thread_pool_worker *worker = (thread_pool_worker *)argument;
+    ThreadPool pool = worker->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (true)
+    {
+        while (pool->head == NULL && !pool->stopping)
+            pthread_cond_wait(&pool->available, &pool->lock);
+        if (pool->head == NULL)
+            break;
+        thread_pool_job *job = pool->head;
+        pool->head = job->next;
+        if (pool->head == NULL)
+            pool->tail = NULL;
+        pthread_mutex_unlock(&pool->lock);
+
+        job->task(job->argument, worker->index);
+        free(job);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->pending--;
+        if (pool->pending == 0)
+            pthread_cond_broadcast(&pool->idle);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool thread_pool_create(int num_workers)
+{
+    if (num_workers < 1)
+        num_workers = 1;
+    ThreadPool pool = (ThreadPool)malloc(sizeof(*pool));
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->available, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    pool->head = NULL;
+    pool->tail = NULL;
+    pool->pending = 0;
+    pool->stopping = false;
+    pool->num_workers = num_workers;
+    if (num_workers > 1)
+        memory_concurrency_begin();
+    pool->workers = (thread_pool_worker *)malloc(num_workers * sizeof(thread_pool_worker));
+    for (int i = 0; i < num_workers; i++)
+    {
+        pool->workers[i].index = i;
+        pool->workers[i].pool = pool;
+        if (pthread_create(&pool->workers[i].thread, NULL, thread_pool_worker_loop, &pool->workers[i]) != 0)
+        {
+            fprintf(stderr, "Cannot start worker thread %d. Exiting.\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return pool;
+}
+
+void thread_pool_delete(ThreadPool pool)
+{
+    thread_pool_wait(pool);
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->num_workers; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->available);
+    pthread_mutex_destroy(&pool->lock);
+    if (pool->num_workers > 1)
+        memory_concurrency_end();
+    free(pool->workers);
+    free(pool);
+}
+
+void thread_pool_submit(ThreadPool pool, thread_pool_task task, void *argument)
+{
+    thread_pool_job *job = (thread_pool_job *)malloc(sizeof(thread_pool_job));
+    job->task = task;
+    job->argument = argument;
+    job->next = NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail == NULL)
+        pool->head = job;
+    else
+        pool->tail->next = job;
+    pool->tail = job;
+    pool->pending++;
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_wait(ThreadPool pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int thread_pool_num_workers(ThreadPool pool)
+{
+    return pool->num_workers;
+}
+
+int thread_pool_num_processors(void)
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors < 1 ? 1 : (int)processors;
+}
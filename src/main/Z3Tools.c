@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 Z3_context make_context(void)
 {
@@ -140,3 +141,246 @@ bool value_of_var_in_model(Z3_context ctx, Z3_model model, Z3_ast variable)
     fprintf(stderr, "Error: Used on a non-boolean formula, or other unknown error\n");
     exit(1);
 }
+
+
+/**
+ * @brief Set of AST identifiers (open addressing), used to visit each shared subformula once.
+ *
+ */
+typedef struct
+{
+    unsigned *ids;     ///< The table (identifiers are stored shifted by one, 0 meaning empty).
+    unsigned capacity; ///< The size of the table (a power of 2).
+    unsigned size;     ///< The number of identifiers stored.
+} ast_id_set;
+
+/**
+ * @brief Adds @p id to @p set.
+ *
+ * @param set A set.
+ * @param id An AST identifier.
+ * @return true if @p id was not in @p set yet.
+ * @return false otherwise.
+ */
+static bool ast_id_set_add(ast_id_set *set, unsigned id)
+{
+    if (2 * (set->size + 1) > set->capacity)
+    {
+        ast_id_set bigger = {(unsigned *)calloc(2 * set->capacity, sizeof(unsigned)), 2 * set->capacity, 0};
+        for (unsigned i = 0; i < set->capacity; i++)
+            if (set->ids[i] != 0)
+                ast_id_set_add(&bigger, set->ids[i] - 1);
+        free(set->ids);
+        *set = bigger;
+    }
+    unsigned slot = (id * 2654435761u) & (set->capacity - 1);
+    while (set->ids[slot] != 0)
+    {
+        if (set->ids[slot] == id + 1)
+            return false;
+        slot = (slot + 1) & (set->capacity - 1);
+    }
+    set->ids[slot] = id + 1;
+    set->size++;
+    return true;
+}
+
+/**
+ * @brief Tells if @p formula is a conjunction.
+ *
+ * @param ctx The context of the solver.
+ * @param formula A formula.
+ * @return true if the head symbol of @p formula is a conjunction.
+ * @return false otherwise.
+ */
+static bool is_conjunction(Z3_context ctx, Z3_ast formula)
+{
+    if (Z3_get_ast_kind(ctx, formula) != Z3_APP_AST)
+        return false;
+    Z3_app app = Z3_to_app(ctx, formula);
+    return Z3_get_decl_kind(ctx, Z3_get_app_decl(ctx, app)) == Z3_OP_AND;
+}
+
+void formula_size(Z3_context ctx, Z3_ast formula, int *num_variables, int *num_clauses)
+{
+    ast_id_set visited = {(unsigned *)calloc(1024, sizeof(unsigned)), 1024, 0};
+    int capacity = 1024;
+    int top = 0;
+    Z3_ast *todo = (Z3_ast *)malloc(capacity * sizeof(Z3_ast));
+    bool *in_conjunction = (bool *)malloc(capacity * sizeof(bool));
+    todo[top] = formula;
+    in_conjunction[top++] = true;
+    *num_variables = 0;
+    *num_clauses = 0;
+
+    while (top > 0)
+    {
+        Z3_ast current = todo[--top];
+        bool top_level = in_conjunction[top];
+        bool conjunction = top_level && is_conjunction(ctx, current);
+        if (top_level && !conjunction)
+            (*num_clauses)++;
+        bool first_visit = ast_id_set_add(&visited, Z3_get_ast_id(ctx, current));
+        if ((!first_visit && !conjunction) || Z3_get_ast_kind(ctx, current) != Z3_APP_AST)
+            continue;
+        Z3_app app = Z3_to_app(ctx, current);
+        unsigned num_args = Z3_get_app_num_args(ctx, app);
+        if (first_visit && num_args == 0 && Z3_get_decl_kind(ctx, Z3_get_app_decl(ctx, app)) == Z3_OP_UNINTERPRETED)
+            (*num_variables)++;
+        for (unsigned arg = 0; arg < num_args; arg++)
+        {
+            if (top == capacity)
+            {
+                capacity *= 2;
+                todo = (Z3_ast *)realloc(todo, capacity * sizeof(Z3_ast));
+                in_conjunction = (bool *)realloc(in_conjunction, capacity * sizeof(bool));
+            }
+            todo[top] = Z3_get_app_arg(ctx, app, arg);
+            in_conjunction[top++] = conjunction;
+        }
+    }
+
+    free(todo);
+    free(in_conjunction);
+    free(visited.ids);
+}
+
+struct Z3Session_s
+{
+    Z3_context ctx;   ///< The context of the session.
+    Z3_solver solver; ///< The solver (reference counted by the session).
+    Z3_model model;   ///< The model of the last satisfiable check (NULL otherwise).
+};
+
+Z3Session session_create(Z3_context ctx)
+{
+    Z3Session session = (Z3Session)malloc(sizeof(*session));
+    session->ctx = ctx;
+    session->solver = Z3_mk_solver(ctx);
+    Z3_solver_inc_ref(ctx, session->solver);
+    session->model = NULL;
+    return session;
+}
+
+/**
+ * @brief Releases the model held by @p session, if any.
+ *
+ * @param session A session.
+ */
+static void session_release_model(Z3Session session)
+{
+    if (session->model != NULL)
+        Z3_model_dec_ref(session->ctx, session->model);
+    session->model = NULL;
+}
+
+void session_delete(Z3Session session)
+{
+    session_release_model(session);
+    Z3_solver_dec_ref(session->ctx, session->solver);
+    free(session);
+}
+
+Z3_context session_get_context(Z3Session session)
+{
+    return session->ctx;
+}
+
+void session_assert(Z3Session session, Z3_ast formula)
+{
+    Z3_solver_assert(session->ctx, session->solver, formula);
+}
+
+void session_push(Z3Session session)
+{
+    Z3_solver_push(session->ctx, session->solver);
+}
+
+void session_pop(Z3Session session, unsigned num_scopes)
+{
+    Z3_solver_pop(session->ctx, session->solver, num_scopes);
+}
+
+/**
+ * @brief Stores the model of the solver of @p session if @p result says there is one.
+ *
+ * @param session A session.
+ * @param result The result of the check that just ended.
+ * @return Z3_lbool @p result.
+ */
+static Z3_lbool session_record_result(Z3Session session, Z3_lbool result)
+{
+    if (result == Z3_L_TRUE)
+    {
+        session->model = Z3_solver_get_model(session->ctx, session->solver);
+        if (session->model != NULL)
+            Z3_model_inc_ref(session->ctx, session->model);
+    }
+    return result;
+}
+
+Z3_lbool session_check(Z3Session session)
+{
+    session_release_model(session);
+    return session_record_result(session, Z3_solver_check(session->ctx, session->solver));
+}
+
+Z3_lbool session_check_assumptions(Z3Session session, int num_assumptions, Z3_ast *assumptions)
+{
+    session_release_model(session);
+    return session_record_result(session, Z3_solver_check_assumptions(session->ctx, session->solver, num_assumptions, assumptions));
+}
+
+Z3_model session_get_model(Z3Session session)
+{
+    return session->model;
+}
+
+double session_get_statistic(Z3Session session, const char *key)
+{
+    Z3_stats stats = Z3_solver_get_statistics(session->ctx, session->solver);
+    Z3_stats_inc_ref(session->ctx, stats);
+    double value = 0;
+    unsigned size = Z3_stats_size(session->ctx, stats);
+    for (unsigned i = 0; i < size; i++)
+    {
+        if (strcmp(Z3_stats_get_key(session->ctx, stats, i), key) != 0)
+            continue;
+        if (Z3_stats_is_uint(session->ctx, stats, i))
+            value = Z3_stats_get_uint_value(session->ctx, stats, i);
+        else
+            value = Z3_stats_get_double_value(session->ctx, stats, i);
+        break;
+    }
+    Z3_stats_dec_ref(session->ctx, stats);
+    return value;
+}
+
+void session_print_statistics(Z3Session session, FILE *file)
+{
+    Z3_stats stats = Z3_solver_get_statistics(session->ctx, session->solver);
+    Z3_stats_inc_ref(session->ctx, stats);
+    unsigned size = Z3_stats_size(session->ctx, stats);
+    for (unsigned i = 0; i < size; i++)
+    {
+        if (Z3_stats_is_uint(session->ctx, stats, i))
+            fprintf(file, "%s: %u\n", Z3_stats_get_key(session->ctx, stats, i), Z3_stats_get_uint_value(session->ctx, stats, i));
+        else
+            fprintf(file, "%s: %g\n", Z3_stats_get_key(session->ctx, stats, i), Z3_stats_get_double_value(session->ctx, stats, i));
+    }
+    Z3_stats_dec_ref(session->ctx, stats);
+}
+
+void session_set_timeout(Z3Session session, unsigned milliseconds)
+{
+    Z3_params params = Z3_mk_params(session->ctx);
+    Z3_params_inc_ref(session->ctx, params);
+    Z3_params_set_uint(session->ctx, params, Z3_mk_string_symbol(session->ctx, "timeout"), milliseconds == 0 ? 4294967295u : milliseconds);
+    Z3_solver_set_params(session->ctx, session->solver, params);
+    Z3_params_dec_ref(session->ctx, params);
+}
+
+void session_interrupt(Z3Session session)
+{
+    Z3_interrupt(session->ctx);
+}
\ No newline at end of file
@@ -12,7 +12,9 @@
 #include "Graph.h"
 #include "Parsing.h"
 #include "Z3Tools.h"
+#include "Metrics.h"
 #include "Parser.h"
+#include "ThreadPool.h"
 #ifdef REPARTITION
 #include "RepartitionGraph.h"
 #include "RepartitionResolution.h"
@@ -22,6 +24,10 @@
 #include "ColouredGraph.h"
 #include "ColouringResolution.h"
 #include "ColouringReduction.h"
+#include "ColouringCore.h"
+#include "ColouringChromatic.h"
+#include "ColouringTabu.h"
+#include "ColouringDecomposition.h"
 #endif
 #ifdef DEADLOCK_CHECKING
 #include "LockAutomaton.h"
@@ -32,10 +38,14 @@
 #include "TunnelNetwork.h"
 #include "TunnelBF.h"
 #include "TunnelReduction.h"
+#include "TunnelQuery.h"
+#include "TunnelCache.h"
+#include "TunnelOptimize.h"
+#include "TunnelUnrolling.h"
 #endif
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -90,6 +100,23 @@ void usage()
     printf("\n");
     printf(" -v         Activate verbose mode (displays parsed graphs)\n");
     printf(" -B         Solves the problem using the brute force algorithm\n");
+#ifdef COLOURING
+    printf(" -D N       Colouring only: solves the problem using the DSATUR branch and bound on N threads (0 for the number of processors, 1 for a sequential search).\n");
+    printf(" -L SECONDS Colouring only: searches a colouring with the TabuCol local search for at most SECONDS seconds (it cannot prove there is none).\n");
+    printf(" -s SEED    Colouring only: seed of TabuCol (1 by default).\n");
+    printf(" -A         Colouring only: runs TabuCol (-L, 10 seconds by default) and DSATUR (-D, 1 thread by default) together, the first definitive answer wins.\n");
+    printf(" -Q SECONDS Colouring only: before solving, a clique of more than k nodes, which proves there is no k-colouring, is searched greedily, then exactly for at most SECONDS seconds (0 for the greedy search only).");
+    printf(" Without -Q, no clique is searched and every engine refutes the colouring by itself. With -m, a colouring refuted by a clique gets its own measures (\"engine\":\"clique\").\n");
+    printf(" -J N       Colouring: solves each connected component of the graph (of its k-core, unless -K) separately with -B, -D and -R, on N threads (0 for the number of processors), and merges the colourings.");
+    printf(" Tunnel: drops the nodes outside the connected components of the initial and final nodes before solving (N is ignored, and so is -J with -q).\n");
+    printf(" -b         Colouring only: with -J, solves each biconnected block (what is left connected when any single node is removed) separately instead of each connected component,");
+    printf(" and exchanges colours inside the blocks so that they agree on the nodes they share.\n");
+    printf(" -K         Colouring only: colours the whole graph, instead of colouring its k-core (what is left after removing repeatedly the nodes with less than k neighbours) and extending the colouring.\n");
+    printf(" -X SEARCH  Colouring only: computes the chromatic number of the graph (the fewest colours) with a single formula, k walking down from a greedy colouring (\"down\") or searched by dichotomy (\"binary\"), the colours being written in the encoding of -E.\n");
+    printf(" -E ENC     Colouring only: encoding of the colours in the reduction, \"direct\" (one variable per node and colour, the default), \"order\" (node n has a colour greater than c),");
+    printf(" \"log\" (the colour in binary, the codes from k on forbidden) or \"bitvector\" (a bit-vector lower than k per node, distinct on each edge). The last three cost O(k) or O(log k) clauses per node instead of O(k²).\n");
+    printf(" -Y SYM     Colouring only: symmetry breaking of the reduction, \"none\", \"clique\" (the nodes of a large clique get fixed colours, the default) or \"precedence\" (besides, colour c+1 is used only if colour c is).\n");
+#endif
     printf(" -R         Solves the problem using a reduction\n");
     printf(" -F         Displays the formula computed ");
 #ifdef SUBJECT
@@ -99,9 +126,154 @@ void usage()
     printf(" -M         Displays the model of the satisfied formula, to help understanding why it is true, especially when there are variables not representing a part of the solution.\n");
     printf(" -t         Displays the solution found [if not present, only displays the existence of the solution].\n");
     printf(" -f         Writes the result with colors in a .dot file. See next option for the name. These files will be produced in the folder 'sol'.\n");
+    printf(" -m FILE    Appends measures of the run (time and memory of each phase, size of formulae, solver statistics) to FILE as one JSON object per line (per solved length for Tunnel, or a single one with -S and -O, whose length is the value of -c and whose size is the one of the path found). Use \"-\" for the standard output.\n");
+#ifdef TUNNEL
+    printf(" -q FILE    Tunnel only: answers every query of FILE over the network instead of the single (initial, final) query. Each line of FILE is \"SOURCE TARGET [BOUND]\" (node names, BOUND defaults to the value of -c; # starts a comment).");
+    printf(" The reduction is built once per length, the endpoints of each query are passed as assumptions. Writes one JSON object per query on the standard output. Uses the brute force if -B is given without -R.\n");
+#endif
+#ifdef TUNNEL
+    printf(" -C DIR     Tunnel only: keeps the answers (and paths found) of the brute force and the reduction in the directory DIR, and reuses them when the same network (same nodes, actions and edges) is asked the same query with the same bound.");
+    printf(" Paths read from DIR are checked before being used. The least recently used answers are removed when DIR is over %ld MiB.\n", TN_CACHE_DEFAULT_SIZE / (1024 * 1024));
+#endif
+#ifdef TUNNEL
+    printf(" -O COST    Tunnel only: with -R, searches the path of size at most the value of -c of smallest COST, in a single run of the Z3 optimiser, instead of the shortest one.");
+    printf(" COST is a list of terms separated by commas among \"hops\" (number of steps), \"push\" (number of push actions) and \"cost\" (sum of the \"cost\" attributes of the edges used, 1 by default), each optionally weighted (\"cost,push=10\"). Ignored with -q, and its answers are not kept by -C.\n");
+    printf(" -S         Tunnel only: with -R, uses a single formula for all the sizes up to the value of -c (the path may end early and stay on its last state), and finds the shortest path");
+    printf(" in a single run of the Z3 optimiser minimising the number of steps (as -O hops), instead of one formula per size.\n");
+    printf(" -I         Tunnel only: with -R, unrolls the reduction frame by frame in a single solver session (bounded model checking): each size only adds the constraints of its last step,");
+    printf(" the end of the path being an assumption, instead of building a new formula for each size.\n");
+#endif
+    printf(" -T N       Solves each file as a separate problem instead of combining them, on N worker threads (0 for the number of processors). Each file is parsed, initialised and solved by a worker with its own solver context;");
+    printf(" the results (and the measures of -m) are printed in the order of the files. Options -v, -F, -M, -f and -q are ignored in this mode, and -S, -I, -C and -O are refused.\n");
     printf(" -o NAME    Writes the output graph in \"NAME_Brute.dot\" or \"NAME_SAT.dot\" depending of the algorithm used and the formula in \"NAME.formula\". [if not present: \"default_SAT.dot\", \"default_Brute.dot\" and \"default.formula\"]\n");
 }
 
+#ifdef TUNNEL
+/**
+ * @brief Writes @p path as a JSON array of steps in @p file.
+ *
+ * @param file A file.
+ * @param network The network.
+ * @param path A path.
+ * @param size_path Its size.
+ */
+void tn_print_path_json(FILE *file, TunnelNetwork network, tn_step *path, int size_path)
+{
+    fputc('[', file);
+    for (int i = 0; i < size_path; i++)
+    {
+        fprintf(file, "%s{\"source\":", i > 0 ? "," : "");
+        print_json_string(file, tn_get_node_name(network, path[i].source));
+        fprintf(file, ",\"action\":");
+        print_json_string(file, tn_string_of_stack_action(path[i].action));
+        fprintf(file, ",\"target\":");
+        print_json_string(file, tn_get_node_name(network, path[i].target));
+        fputc('}', file);
+    }
+    fputc(']', file);
+}
+
+/**
+ * @brief Answers the queries of the file @p queryName over @p network (see option -q), and writes one JSON object per query on the standard output, as soon as it is answered.
+ *
+ * @param network The network.
+ * @param queryName The name of the file of queries.
+ * @param default_bound The bound of queries which do not give one.
+ * @param bruteForce Uses the brute force instead of the reduction.
+ * @param cache The cache of answers (NULL if none).
+ * @return true if the file could be read.
+ * @return false otherwise.
+ */
+bool tn_answer_queries(TunnelNetwork network, char *queryName, int default_bound, bool bruteForce, TunnelCache cache)
+{
+    FILE *queries = fopen(queryName, "r");
+    if (queries == NULL)
+    {
+        printf("Cannot open %s to read queries. Exiting.\n", queryName);
+        return false;
+    }
+    Z3_context ctx = make_context();
+    TunnelQuery query = tn_query_create(ctx, network);
+    int initial = tn_get_initial(network);
+    int final = tn_get_final(network);
+    unsigned long long fingerprint = cache != NULL ? tn_fingerprint(network) : 0;
+    char line[1024];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), queries) != NULL)
+    {
+        line_number++;
+        char *start = line + strspn(line, " \t");
+        if (*start == '#' || *start == '\n' || *start == '\0')
+            continue;
+        char source_name[256], target_name[256];
+        int bound = default_bound;
+        int num_read = sscanf(start, "%255s %255s %d", source_name, target_name, &bound);
+        printf("{\"line\":%d", line_number);
+        if (num_read < 2 || bound < 1)
+        {
+            printf(",\"error\":\"expected SOURCE TARGET [BOUND]\"}\n");
+            fflush(stdout);
+            continue;
+        }
+        printf(",\"source\":");
+        print_json_string(stdout, source_name);
+        printf(",\"target\":");
+        print_json_string(stdout, target_name);
+        printf(",\"bound\":%d", bound);
+        int source = tn_get_node_from_name(network, source_name);
+        int target = tn_get_node_from_name(network, target_name);
+        if (source < 0 || target < 0)
+        {
+            printf(",\"error\":\"unknown node\"}\n");
+            fflush(stdout);
+            continue;
+        }
+        tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+        if (path == NULL)
+        {
+            printf(",\"error\":\"bound too large\"}\n");
+            fflush(stdout);
+            continue;
+        }
+        time_point queryStart = time_now();
+        tn_cache_key key = {fingerprint, source, target, bound, bruteForce ? "bf" : "sat"};
+        int length, num_unsat = 0;
+        bool cached = cache != NULL && tn_cache_lookup(cache, network, &key, &length, path, &num_unsat);
+        if (cached)
+            ;
+        else if (bruteForce)
+        {
+            tn_set_initial(network, source);
+            tn_set_final(network, target);
+            length = tn_brute_force(network, bound, path);
+        }
+        else
+            length = tn_query_solve_from(query, source, target, num_unsat + 1, bound, path);
+        double wall = time_elapsed(queryStart);
+        if (cache != NULL && !cached && length >= 0)
+            tn_cache_store(cache, network, &key, length, path);
+        printf(",\"result\":\"%s\",\"time\":", length > 0 ? "sat" : (length == 0 ? "unsat" : "unknown"));
+        print_json_number(stdout, "%.9f", wall);
+        if (cache != NULL)
+            printf(",\"cached\":%s", cached ? "true" : "false");
+        if (length > 0)
+        {
+            printf(",\"length\":%d,\"path\":", length);
+            tn_print_path_json(stdout, network, path, length);
+        }
+        printf("}\n");
+        fflush(stdout);
+        free(path);
+    }
+    tn_set_initial(network, initial);
+    tn_set_final(network, final);
+    tn_query_delete(query);
+    Z3_del_context(ctx);
+    fclose(queries);
+    return true;
+}
+#endif
+
 enum problemType
 {
     Repartition,
@@ -110,6 +282,755 @@ enum problemType
     Tunnel
 };
 
+/**
+ * @brief The options shared by all the jobs of option -T.
+ *
+ */
+typedef struct
+{
+    enum problemType problem; ///< The problem to solve.
+    char *problem_parameter;  ///< The value of option -c.
+    bool bruteForce;          ///< Solves with the brute force.
+    bool reduction;           ///< Solves with the reduction.
+    bool displayTerminal;     ///< Prints the solutions found.
+    bool measures;            ///< Writes the measures of the reduction (option -m).
+    int dsaturWorkers;        ///< Number of threads of the DSATUR branch and bound (option -D), -1 if it is not used.
+    char *symmetryName;       ///< The symmetry breaking of the colouring reduction (option -Y), NULL for the default.
+    bool colouringCore;       ///< Colours only the k-core of the graph, then extends the colouring (not with option -K).
+    char *chromaticSearch;    ///< How to search the chromatic number (option -X), NULL if it is not searched.
+    double tabuSeconds;       ///< Time budget of TabuCol (option -L), negative if it is not used.
+    unsigned long long seed;  ///< Seed of TabuCol (option -s).
+    bool race;                ///< Runs TabuCol and DSATUR together (option -A).
+    double cliqueSeconds;     ///< Time budget of the exact search of a clique refuting the colouring (option -Q), negative if no clique is searched.
+    int componentWorkers;     ///< Number of threads solving the connected components separately (option -J), -1 if the graph is not decomposed.
+    bool blocks;              ///< Decomposes the colouring into biconnected blocks instead of connected components (option -b).
+    char *encodingName;       ///< The encoding of the colours in the colouring reduction (option -E), NULL for the default.
+} job_options;
+
+/**
+ * @brief One file of option -T. A worker parses, initialises and solves it, writing its report and measures in memory, so that the main thread can print them in the order of the files.
+ *
+ */
+typedef struct
+{
+    char *fileName;              ///< The file to solve.
+    const job_options *options;  ///< The options of the run.
+    char *report;                ///< What would be printed on the standard output.
+    size_t report_size;          ///< Size of report.
+    char *measures;              ///< The JSON lines of the measures.
+    size_t measures_size;        ///< Size of measures.
+    double parse_wall;           ///< Wall-clock time of the parsing.
+    double parse_cpu;            ///< CPU time of the process during the parsing.
+    memory_usage parse_memory;   ///< Memory used by the parsing.
+    bool done;                   ///< Set when report and measures are complete (protected by lock).
+    pthread_mutex_t *lock;       ///< Shared by all the jobs.
+    pthread_cond_t *finished;    ///< Signaled when a job is done.
+} file_job;
+
+#ifdef COLOURING
+/**
+ * @brief Reads the symmetry breaking of option -Y. Exits if it is not valid.
+ *
+ * @param name The value of option -Y, NULL if it is absent.
+ * @return colouring_symmetry The symmetry breaking (colouring_symmetry_clique if @p name is NULL).
+ */
+colouring_symmetry colouring_symmetry_of_option(char *name)
+{
+    colouring_symmetry symmetry = colouring_symmetry_clique;
+    if (name != NULL && !colouring_symmetry_of_string(name, &symmetry))
+    {
+        printf("Invalid symmetry breaking %s (expected none, clique or precedence). Exiting.\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return symmetry;
+}
+
+/**
+ * @brief Reads the encoding of the colours of option -E. Exits if it is not valid.
+ *
+ * @param name The value of option -E, NULL if it is absent.
+ * @return colouring_encoding The encoding (colouring_encoding_direct if @p name is NULL).
+ */
+colouring_encoding colouring_encoding_of_option(char *name)
+{
+    colouring_encoding encoding = colouring_encoding_direct;
+    if (name != NULL && !colouring_encoding_of_string(name, &encoding))
+    {
+        printf("Invalid encoding of the colours %s (expected direct, order, log or bitvector). Exiting.\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return encoding;
+}
+
+/**
+ * @brief Reads the search of the chromatic number of option -X. Exits if it is not valid.
+ *
+ * @param name The value of option -X.
+ * @return true if k is searched by dichotomy ("binary").
+ * @return false if k walks down from the greedy bound ("down").
+ */
+bool chromatic_binary_of_option(char *name)
+{
+    if (strcmp(name, "binary") != 0 && strcmp(name, "down") != 0)
+    {
+        printf("Invalid search of the chromatic number %s (expected down or binary). Exiting.\n", name);
+        exit(EXIT_FAILURE);
+    }
+    return strcmp(name, "binary") == 0;
+}
+
+/**
+ * @brief Searches a clique of more than @p num_colours nodes in @p graph, which proves it has no colouring with @p num_colours colours.
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours.
+ * @param seconds The time budget of the exact search (0 for the greedy search only, negative for no search at all).
+ * @param clique Array to return the nodes of the clique.
+ * @return int The size of the clique found if it has more than @p num_colours nodes, 0 otherwise.
+ * @pre @p clique must be an array of size at least the number of nodes of @p graph.
+ */
+int colouring_refuting_clique(ColouredGraph graph, int num_colours, double seconds, int *clique)
+{
+    if (seconds < 0)
+        return 0;
+    int size = colouring_max_clique(graph, clique, num_colours + 1, seconds, NULL);
+    return size > num_colours ? size : 0;
+}
+
+/**
+ * @brief Fills @p metrics with the measures of a colouring refuted by a clique (option -Q), which no engine solved.
+ *
+ * @param metrics The measures (cleared first).
+ * @param fileName The name of the file of the graph.
+ * @param num_colours The number of colours.
+ * @param num_nodes The number of nodes of the graph searched (its k-core with -K).
+ * @param size_clique The size of the clique found.
+ * @param parse_wall The wall-clock time of the parsing.
+ * @param parse_cpu The CPU time of the parsing.
+ * @param parseMemory The memory used by the parsing.
+ * @param cliqueStart When the search of the clique started.
+ */
+void colouring_clique_metrics(Metrics metrics, const char *fileName, int num_colours, int num_nodes, int size_clique, double parse_wall, double parse_cpu,
+                              const memory_usage *parseMemory, time_point cliqueStart)
+{
+    metrics_reset(metrics);
+    metrics_set_label(metrics, "problem", "Colouring");
+    metrics_set_label(metrics, "file", fileName);
+    metrics_set_label(metrics, "engine", "clique");
+    metrics_set_label(metrics, "result", "unsat");
+    metrics_set_counter(metrics, "colours", num_colours);
+    metrics_set_counter(metrics, "core_nodes", num_nodes);
+    metrics_set_counter(metrics, "clique", size_clique);
+    metrics_add_phase_duration(metrics, "parse", parse_wall, parse_cpu, parseMemory);
+    metrics_add_phase(metrics, "clique", cliqueStart);
+}
+
+/**
+ * @brief colouring_engine of the brute force.
+ *
+ * @param graph A piece of the graph.
+ * @param num_colours The number of colours.
+ * @param data Unused.
+ * @return int 1 if there is a colouring, 0 otherwise.
+ */
+int colouring_engine_brute_force(ColouredGraph graph, int num_colours, void *data)
+{
+    return colouring_brute_force(graph, num_colours) ? 1 : 0;
+}
+
+/**
+ * @brief colouring_engine of DSATUR.
+ *
+ * @param graph A piece of the graph.
+ * @param num_colours The number of colours.
+ * @param data A pointer to the number of threads of DSATUR.
+ * @return int 1 if there is a colouring, 0 otherwise.
+ */
+int colouring_engine_dsatur(ColouredGraph graph, int num_colours, void *data)
+{
+    return colouring_dsatur(graph, num_colours, *(int *)data) ? 1 : 0;
+}
+
+/**
+ * @brief The options of the colouring reduction, the data of colouring_engine_reduction.
+ *
+ */
+typedef struct
+{
+    colouring_symmetry symmetry; ///< The symmetry breaking (option -Y).
+    colouring_encoding encoding; ///< The encoding of the colours (option -E).
+} colouring_reduction_options;
+
+/**
+ * @brief colouring_engine of the reduction, with its own solver context (Z3 contexts cannot be shared between threads).
+ *
+ * @param graph A piece of the graph.
+ * @param num_colours The number of colours.
+ * @param data A pointer to the colouring_reduction_options.
+ * @return int 1 if there is a colouring, 0 if there is none, -1 if the solver could not decide.
+ */
+int colouring_engine_reduction(ColouredGraph graph, int num_colours, void *data)
+{
+    colouring_reduction_options *reduction = (colouring_reduction_options *)data;
+    Z3_context ctx = make_context();
+    Z3Session session = session_create(ctx);
+    session_assert(session, colouring_reduction_encoded(ctx, graph, num_colours, reduction->symmetry, reduction->encoding));
+    Z3_lbool isSat = session_check(session);
+    if (isSat == Z3_L_TRUE)
+        colour_graph_from_model(ctx, session_get_model(session), graph, num_colours, reduction->encoding);
+    session_delete(session);
+    Z3_del_context(ctx);
+    return isSat == Z3_L_TRUE ? 1 : (isSat == Z3_L_FALSE ? 0 : -1);
+}
+
+/**
+ * @brief Solves the colouring problem of @p graph piece by piece with @p engine (option -J).
+ *
+ * @param graph A ColouredGraph.
+ * @param num_colours The number of colours.
+ * @param engine The engine.
+ * @param data The data of the engine.
+ * @param num_workers The number of threads.
+ * @param blocks Decomposes the graph into biconnected blocks instead of connected components (option -b).
+ * @param num_pieces If not NULL, will contain the number of pieces.
+ * @return int 1 if there is a colouring, 0 if there is none, -1 if the engine could not decide for some piece.
+ */
+int colouring_decomposed(ColouredGraph graph, int num_colours, colouring_engine engine, void *data, int num_workers, bool blocks, int *num_pieces)
+{
+    if (blocks)
+        return colouring_by_blocks(graph, num_colours, engine, data, num_workers, num_pieces);
+    return colouring_by_components(graph, num_colours, engine, data, num_workers, num_pieces);
+}
+
+/**
+ * @brief Solves the colouring problem of option -T for @p graph, the graph of @p job.
+ *
+ * @param job A job.
+ * @param graph Its graph.
+ * @param report Where to write the result.
+ * @param measures Where to write the measures.
+ */
+void colouring_solve_job(file_job *job, Graph graph, FILE *report, FILE *measures)
+{
+    const job_options *options = job->options;
+    int num_colours = 3;
+    if (strcmp(options->problem_parameter, "") != 0)
+        num_colours = atoi(options->problem_parameter);
+    ColouredGraph coloured_graph = cg_initialize(graph);
+    ColouringCore core = NULL;
+    ColouredGraph solved_graph = coloured_graph;
+    if (options->colouringCore)
+    {
+        core = colouring_core_create(coloured_graph, num_colours);
+        solved_graph = colouring_core_get_graph(core);
+        fprintf(report, "The %d-core of this graph has %d nodes (%d nodes peeled).\n", num_colours, cg_get_num_nodes(solved_graph), colouring_core_num_peeled(core));
+    }
+
+    int clique[cg_get_num_nodes(solved_graph) + 1];
+    time_point cliqueStart = time_now();
+    int size_clique = colouring_refuting_clique(solved_graph, num_colours, options->cliqueSeconds, clique);
+    if (size_clique > 0)
+    {
+        fprintf(report, "Clique: there is no %d-colouring of this graph, it has a clique of %d nodes:", num_colours, size_clique);
+        for (int i = 0; i < size_clique; i++)
+            fprintf(report, " %s", cg_get_node_name(solved_graph, clique[i]));
+        fprintf(report, "\n");
+        if (options->measures)
+        {
+            Metrics metrics = metrics_create();
+            colouring_clique_metrics(metrics, job->fileName, num_colours, cg_get_num_nodes(solved_graph), size_clique, job->parse_wall, job->parse_cpu,
+                                     &job->parse_memory, cliqueStart);
+            metrics_print_json(metrics, measures);
+            metrics_delete(metrics);
+        }
+    }
+    bool refuted = size_clique > 0;
+
+    if (options->bruteForce && !refuted)
+    {
+        time_point start = time_now();
+        bool res;
+        if (options->componentWorkers >= 0)
+            res = colouring_decomposed(solved_graph, num_colours, colouring_engine_brute_force, NULL, options->componentWorkers, options->blocks, NULL) == 1;
+        else
+            res = colouring_brute_force(solved_graph, num_colours);
+        double end = time_elapsed(start);
+        if (res)
+        {
+            if (core != NULL)
+                colouring_core_extend(core);
+            fprintf(report, "Brute force: there is a %d-colouring of this graph (%g seconds).\n", num_colours, end);
+            if (options->displayTerminal)
+                cg_fprint_colors(report, coloured_graph);
+        }
+        else
+            fprintf(report, "Brute force: there is no %d-colouring of this graph (%g seconds).\n", num_colours, end);
+    }
+
+    if (options->dsaturWorkers >= 0 && !options->race && !refuted)
+    {
+        time_point start = time_now();
+        bool res;
+        int workers = options->dsaturWorkers;
+        if (options->componentWorkers >= 0)
+            res = colouring_decomposed(solved_graph, num_colours, colouring_engine_dsatur, &workers, options->componentWorkers, options->blocks, NULL) == 1;
+        else
+            res = colouring_dsatur(solved_graph, num_colours, workers);
+        double end = time_elapsed(start);
+        if (res)
+        {
+            if (core != NULL)
+                colouring_core_extend(core);
+            fprintf(report, "DSATUR: there is a %d-colouring of this graph (%g seconds).\n", num_colours, end);
+            if (options->displayTerminal)
+                cg_fprint_colors(report, coloured_graph);
+        }
+        else
+            fprintf(report, "DSATUR: there is no %d-colouring of this graph (%g seconds).\n", num_colours, end);
+    }
+
+    if (options->race && !refuted)
+    {
+        time_point start = time_now();
+        bool by_tabu;
+        bool res = colouring_race(solved_graph, num_colours, options->dsaturWorkers, options->tabuSeconds, options->seed, &by_tabu);
+        double end = time_elapsed(start);
+        if (res)
+        {
+            if (core != NULL)
+                colouring_core_extend(core);
+            fprintf(report, "Race (%s first): there is a %d-colouring of this graph (%g seconds).\n", by_tabu ? "TabuCol" : "DSATUR", num_colours, end);
+            if (options->displayTerminal)
+                cg_fprint_colors(report, coloured_graph);
+        }
+        else
+            fprintf(report, "Race (DSATUR first): there is no %d-colouring of this graph (%g seconds).\n", num_colours, end);
+    }
+    else if (options->tabuSeconds >= 0 && !refuted)
+    {
+        time_point start = time_now();
+        bool res = colouring_tabu(solved_graph, num_colours, options->tabuSeconds, options->seed);
+        double end = time_elapsed(start);
+        if (res)
+        {
+            if (core != NULL)
+                colouring_core_extend(core);
+            fprintf(report, "TabuCol: there is a %d-colouring of this graph (%g seconds).\n", num_colours, end);
+            if (options->displayTerminal)
+                cg_fprint_colors(report, coloured_graph);
+        }
+        else
+            fprintf(report, "TabuCol: no %d-colouring found (%g seconds), there may be one.\n", num_colours, end);
+    }
+
+    if (options->reduction && !refuted && options->componentWorkers >= 0)
+    {
+        time_point start = time_now();
+        colouring_reduction_options reduction = {colouring_symmetry_of_option(options->symmetryName), colouring_encoding_of_option(options->encodingName)};
+        int num_components;
+        int res = colouring_decomposed(solved_graph, num_colours, colouring_engine_reduction, &reduction, options->componentWorkers, options->blocks, &num_components);
+        double end = time_elapsed(start);
+        if (res == 1)
+        {
+            if (core != NULL)
+                colouring_core_extend(core);
+            fprintf(report, "Reduction (%d %s%s): there is a %d-colouring of this graph (%g seconds).\n", num_components, options->blocks ? "block" : "component", num_components > 1 ? "s" : "", num_colours, end);
+            if (options->displayTerminal)
+                cg_fprint_colors(report, coloured_graph);
+        }
+        else if (res == 0)
+            fprintf(report, "Reduction (%d %s%s): no %d-colouring of this graph is possible (%g seconds).\n", num_components, options->blocks ? "block" : "component", num_components > 1 ? "s" : "", num_colours, end);
+        else
+            fprintf(report, "Reduction (%d %s%s): not able to decide if there is a %d-colouring of this graph (%g seconds).\n", num_components, options->blocks ? "block" : "component", num_components > 1 ? "s" : "", num_colours, end);
+    }
+    else if (options->reduction && !refuted)
+    {
+        Z3_context ctx = make_context();
+        Metrics metrics = metrics_create();
+        metrics_set_label(metrics, "problem", "Colouring");
+        metrics_set_label(metrics, "file", job->fileName);
+        metrics_set_counter(metrics, "colours", num_colours);
+        metrics_set_counter(metrics, "core_nodes", cg_get_num_nodes(solved_graph));
+        metrics_add_phase_duration(metrics, "parse", job->parse_wall, job->parse_cpu, &job->parse_memory);
+
+        time_point start = time_now();
+        metrics_set_label(metrics, "symmetry", options->symmetryName != NULL ? options->symmetryName : "clique");
+        metrics_set_label(metrics, "encoding", options->encodingName != NULL ? options->encodingName : "direct");
+        colouring_encoding encoding = colouring_encoding_of_option(options->encodingName);
+        Z3_ast formula = colouring_reduction_encoded(ctx, solved_graph, num_colours, colouring_symmetry_of_option(options->symmetryName), encoding);
+        metrics_add_phase(metrics, "colouring_reduction", start);
+        time_point phaseStart = time_now();
+        Z3Session session = session_create(ctx);
+        session_assert(session, formula);
+        metrics_add_phase(metrics, "assert", phaseStart);
+        phaseStart = time_now();
+        Z3_lbool isSat = session_check(session);
+        metrics_add_phase(metrics, "check", phaseStart);
+        double end = time_elapsed(start);
+
+        switch (isSat)
+        {
+        case Z3_L_FALSE:
+            fprintf(report, "Reduction: no %d-colouring of this graph is possible (%g seconds).\n", num_colours, end);
+            break;
+
+        case Z3_L_UNDEF:
+            fprintf(report, "Reduction: not able to decide if there is a %d-colouring of this graph (%g seconds).\n", num_colours, end);
+            break;
+
+        case Z3_L_TRUE:
+            fprintf(report, "Reduction: there is a %d-colouring of this graph (%g seconds).\n", num_colours, end);
+            if (options->displayTerminal)
+            {
+                colour_graph_from_model(ctx, session_get_model(session), solved_graph, num_colours, encoding);
+                if (core != NULL)
+                    colouring_core_extend(core);
+                cg_fprint_colors(report, coloured_graph);
+            }
+            break;
+        }
+
+        if (options->measures)
+        {
+            metrics_set_label(metrics, "result", isSat == Z3_L_TRUE ? "sat" : isSat == Z3_L_FALSE ? "unsat" : "unknown");
+            metrics_add_formula_size(metrics, ctx, "colouring_reduction", formula);
+            metrics_add_session_statistics(metrics, session);
+            metrics_print_json(metrics, measures);
+        }
+
+        metrics_delete(metrics);
+        session_delete(session);
+        Z3_del_context(ctx);
+    }
+
+    if (options->chromaticSearch != NULL)
+    {
+        Z3_context ctx = make_context();
+        time_point start = time_now();
+        int num_calls;
+        int chromatic = colouring_chromatic_number(ctx, coloured_graph, colouring_symmetry_of_option(options->symmetryName), colouring_encoding_of_option(options->encodingName), chromatic_binary_of_option(options->chromaticSearch), &num_calls);
+        double end = time_elapsed(start);
+        if (chromatic >= 0)
+        {
+            fprintf(report, "Chromatic number: %d (%d solver calls, %g seconds).\n", chromatic, num_calls, end);
+            if (options->displayTerminal)
+                cg_fprint_colors(report, coloured_graph);
+        }
+        else
+            fprintf(report, "Chromatic number: not able to decide (%d solver calls, %g seconds).\n", num_calls, end);
+        Z3_del_context(ctx);
+    }
+
+    if (core != NULL)
+        colouring_core_delete(core);
+    cg_delete(coloured_graph);
+}
+#endif
+
+#ifdef TUNNEL
+/**
+ * @brief Starts the measures of one length of a tunnel problem: clears @p metrics, then sets its labels and length and the phases of parsing and
+ *        initialisation, shared by every length.
+ *
+ * @param metrics The measures.
+ * @param fileName The name of the file of the problem.
+ * @param length The size of the path (the bound for the engines solving every size at once).
+ * @param parse_wall The wall-clock time of the parsing.
+ * @param parse_cpu The CPU time of the parsing.
+ * @param parseMemory The memory used by the parsing.
+ * @param initStart When tn_initialize started.
+ * @param initEnd When tn_initialize ended.
+ * @param initMemory The memory used by tn_initialize.
+ */
+void tn_metrics_start(Metrics metrics, const char *fileName, int length, double parse_wall, double parse_cpu, const memory_usage *parseMemory,
+                      time_point initStart, time_point initEnd, const memory_usage *initMemory)
+{
+    metrics_reset(metrics);
+    metrics_set_label(metrics, "problem", "Tunnel");
+    metrics_set_label(metrics, "file", fileName);
+    metrics_set_counter(metrics, "length", length);
+    metrics_add_phase_duration(metrics, "parse", parse_wall, parse_cpu, parseMemory);
+    metrics_add_phase_duration(metrics, "tn_initialize", initEnd.wall - initStart.wall, initEnd.cpu - initStart.cpu, initMemory);
+}
+
+/**
+ * @brief Solves the tunnel problem of option -T for @p graph, the graph of @p job.
+ *
+ * @param job A job.
+ * @param graph Its graph.
+ * @param report Where to write the result.
+ * @param measures Where to write the measures (one line per length).
+ */
+void tn_solve_job(file_job *job, Graph graph, FILE *report, FILE *measures)
+{
+    const job_options *options = job->options;
+    time_point initStart = time_now();
+    TunnelNetwork network = tn_initialize(graph);
+    Graph pruned;
+    bool is_pruned = options->componentWorkers >= 0 && tn_endpoints_subgraph(network, &pruned);
+    if (is_pruned)
+    {
+        fprintf(report, "Components: %d nodes dropped, outside the components of the initial and final nodes.\n", graph_num_nodes(graph) - graph_num_nodes(pruned));
+        tn_delete(network);
+        network = tn_initialize(pruned);
+    }
+    time_point initEnd = time_now();
+    memory_usage initMemory = memory_phase_end();
+
+    int bound = 10;
+    if (strcmp(options->problem_parameter, "") != 0)
+        bound = atoi(options->problem_parameter);
+    tn_step path[bound];
+
+    if (options->bruteForce)
+    {
+        time_point start = time_now();
+        int res = tn_brute_force(network, bound, path);
+        double end = time_elapsed(start);
+        if (res > 0)
+        {
+            fprintf(report, "Brute force: there is a simple path of size %d (%g seconds).\n", res, end);
+            if (options->displayTerminal)
+                tn_fprint_path(report, network, path, res);
+        }
+        else
+            fprintf(report, "Brute force: there is no simple path of size at most %d (%g seconds).\n", bound, end);
+    }
+
+    if (options->reduction)
+    {
+        Z3_context ctx = make_context();
+        Z3Session session = session_create(ctx);
+        Metrics metrics = metrics_create();
+        time_point start = time_now();
+        Z3_lbool isSat = Z3_L_FALSE;
+        int l = 0;
+
+        while (isSat == Z3_L_FALSE && l < bound)
+        {
+            l++;
+            tn_metrics_start(metrics, job->fileName, l, job->parse_wall, job->parse_cpu, &job->parse_memory, initStart, initEnd, &initMemory);
+
+            Z3_ast families[TN_NUM_FAMILIES];
+            for (int family = 0; family < TN_NUM_FAMILIES; family++)
+            {
+                time_point familyStart = time_now();
+                families[family] = tn_reduction_family(ctx, network, l, family);
+                metrics_add_phase(metrics, tn_family_name(family), familyStart);
+            }
+            Z3_ast formula = Z3_mk_and(ctx, TN_NUM_FAMILIES, families);
+
+            time_point phaseStart = time_now();
+            session_push(session);
+            session_assert(session, formula);
+            metrics_add_phase(metrics, "assert", phaseStart);
+            phaseStart = time_now();
+            isSat = session_check(session);
+            metrics_add_phase(metrics, "check", phaseStart);
+
+            if (isSat == Z3_L_TRUE)
+            {
+                phaseStart = time_now();
+                tn_get_path_from_model(ctx, session_get_model(session), network, l, path);
+                metrics_add_phase(metrics, "decode", phaseStart);
+            }
+
+            if (options->measures)
+            {
+                metrics_set_label(metrics, "result", isSat == Z3_L_TRUE ? "sat" : isSat == Z3_L_FALSE ? "unsat" : "unknown");
+                for (int family = 0; family < TN_NUM_FAMILIES; family++)
+                    metrics_add_formula_size(metrics, ctx, tn_family_name(family), families[family]);
+                metrics_add_session_statistics(metrics, session);
+                metrics_print_json(metrics, measures);
+            }
+            session_pop(session, 1);
+        }
+        double end = time_elapsed(start);
+
+        switch (isSat)
+        {
+        case Z3_L_FALSE:
+            fprintf(report, "Reduction: no simple path of size at most %d exists (%g seconds).\n", bound, end);
+            break;
+
+        case Z3_L_UNDEF:
+            fprintf(report, "Reduction: not able to decide if there is a simple path of size %d (%g seconds).\n", l, end);
+            break;
+
+        case Z3_L_TRUE:
+            fprintf(report, "Reduction: there is a simple path of size %d (%g seconds).\n", l, end);
+            if (options->displayTerminal)
+                tn_fprint_path(report, network, path, l);
+            break;
+        }
+
+        metrics_delete(metrics);
+        session_delete(session);
+        Z3_del_context(ctx);
+    }
+
+    tn_delete(network);
+    if (is_pruned)
+        graph_delete(pruned);
+}
+#endif
+
+/**
+ * @brief Task of the thread pool for option -T: parses the file of @p argument (a file_job), solves it and marks it done.
+ *        The solver context is created by the worker for the job and deleted with it, so that no memory of a file stays in the worker.
+ *
+ * @param argument A file_job.
+ * @param worker The index of the worker.
+ */
+void solve_file_job(void *argument, int worker)
+{
+    file_job *job = (file_job *)argument;
+    FILE *report = open_memstream(&job->report, &job->report_size);
+    FILE *measures = open_memstream(&job->measures, &job->measures_size);
+    fprintf(report, "\n*** %s ***\n", job->fileName);
+
+    if (access(job->fileName, R_OK) != 0)
+        fprintf(report, "file %s does not exist or cannot be read.\n", job->fileName);
+    else
+    {
+        time_point parseStart = time_now();
+        Graph graph = get_graph_from_file(job->fileName);
+        time_point parseEnd = time_now();
+        job->parse_wall = parseEnd.wall - parseStart.wall;
+        job->parse_cpu = parseEnd.cpu - parseStart.cpu;
+        job->parse_memory = memory_phase_end();
+
+        switch (job->options->problem)
+        {
+#ifdef COLOURING
+        case Colouring:
+            colouring_solve_job(job, graph, report, measures);
+            break;
+#endif
+#ifdef TUNNEL
+        case Tunnel:
+            tn_solve_job(job, graph, report, measures);
+            break;
+#endif
+        default:
+            fprintf(report, "This problem cannot be solved file by file.\n");
+            break;
+        }
+        graph_delete(graph);
+    }
+
+    fclose(report);
+    fclose(measures);
+    pthread_mutex_lock(job->lock);
+    job->done = true;
+    pthread_cond_broadcast(job->finished);
+    pthread_mutex_unlock(job->lock);
+}
+
+/**
+ * @brief Solves each of the @p num_files files of @p fileNames as a separate problem on @p num_workers threads (option -T), and prints the results in the order of the files.
+ *
+ * @param fileNames The files.
+ * @param num_files Their number.
+ * @param num_workers The number of threads (0 for the number of processors).
+ * @param options The options of the run.
+ * @param metricsFile Where to write the measures (NULL if not asked).
+ */
+void solve_files_in_parallel(char **fileNames, int num_files, int num_workers, const job_options *options, FILE *metricsFile)
+{
+    if (num_workers <= 0)
+        num_workers = thread_pool_num_processors();
+    if (num_workers > num_files)
+        num_workers = num_files;
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t finished = PTHREAD_COND_INITIALIZER;
+    file_job *jobs = (file_job *)calloc(num_files, sizeof(file_job));
+    ThreadPool pool = thread_pool_create(num_workers);
+    for (int i = 0; i < num_files; i++)
+    {
+        jobs[i].fileName = fileNames[i];
+        jobs[i].options = options;
+        jobs[i].lock = &lock;
+        jobs[i].finished = &finished;
+        thread_pool_submit(pool, solve_file_job, &jobs[i]);
+    }
+
+    for (int i = 0; i < num_files; i++)
+    {
+        pthread_mutex_lock(&lock);
+        while (!jobs[i].done)
+            pthread_cond_wait(&finished, &lock);
+        pthread_mutex_unlock(&lock);
+        fwrite(jobs[i].report, 1, jobs[i].report_size, stdout);
+        fflush(stdout);
+        if (metricsFile != NULL)
+        {
+            fwrite(jobs[i].measures, 1, jobs[i].measures_size, metricsFile);
+            fflush(metricsFile);
+        }
+        free(jobs[i].report);
+        free(jobs[i].measures);
+    }
+
+    thread_pool_delete(pool);
+    pthread_cond_destroy(&finished);
+    pthread_mutex_destroy(&lock);
+    free(jobs);
+}
+
+/**
+ * @brief One file parsed by parse_files_in_parallel.
+ *
+ */
+typedef struct
+{
+    char *fileName; ///< The file to parse.
+    Graph *graph;   ///< Where to store its graph.
+} parse_job;
+
+/**
+ * @brief Task of the thread pool of parse_files_in_parallel: parses the file of @p argument (a parse_job).
+ *
+ * @param argument A parse_job.
+ * @param worker The index of the worker.
+ */
+void parse_file_job(void *argument, int worker)
+{
+    parse_job *job = (parse_job *)argument;
+    *job->graph = get_graph_from_file(job->fileName);
+}
+
+/**
+ * @brief Parses the @p num_files files of @p fileNames at the same time, on one thread per processor (each parsing has its own scanner).
+ *
+ * @param fileNames The files.
+ * @param num_files Their number.
+ * @param graphs Array to store their graphs, in the order of the files.
+ */
+void parse_files_in_parallel(char **fileNames, int num_files, Graph *graphs)
+{
+    int num_workers = thread_pool_num_processors();
+    if (num_workers > num_files)
+        num_workers = num_files;
+    if (num_workers <= 1)
+    {
+        for (int i = 0; i < num_files; i++)
+            graphs[i] = get_graph_from_file(fileNames[i]);
+        return;
+    }
+    parse_job *jobs = (parse_job *)malloc(num_files * sizeof(parse_job));
+    ThreadPool pool = thread_pool_create(num_workers);
+    for (int i = 0; i < num_files; i++)
+    {
+        jobs[i].fileName = fileNames[i];
+        jobs[i].graph = &graphs[i];
+        thread_pool_submit(pool, parse_file_job, &jobs[i]);
+    }
+    thread_pool_wait(pool);
+    thread_pool_delete(pool);
+    free(jobs);
+}
+
 int main(int argc, char *argv[])
 {
     if (argc < 2)
@@ -128,12 +1049,30 @@ int main(int argc, char *argv[])
     bool printModel = false;
     char *problem_parameter = "";
     char *solutionName = "default";
+    char *metricsName = NULL;
+    char *queryName = NULL;
+    char *cacheName = NULL;
+    char *objectiveName = NULL;
+    bool upTo = false;
+    bool unroll = false;
+    int num_workers = -1;
+    int dsaturWorkers = -1;
+    char *symmetryName = NULL;
+    bool colouringCore = true;
+    char *chromaticSearch = NULL;
+    double tabuSeconds = -1;
+    unsigned long long seed = 1;
+    bool race = false;
+    double cliqueSeconds = -1;
+    int componentWorkers = -1;
+    bool blocks = false;
+    char *encodingName = NULL;
     /*char *realArgs[argc];
     int numArgs = 0;*/
 
     int option;
 
-    while ((option = getopt(argc, argv, ":hP:c:vFBGRMtfo:")) != -1)
+    while ((option = getopt(argc, argv, ":hP:c:vFBD:GRMtfo:m:q:T:C:O:SIY:KX:L:s:AQ:J:bE:")) != -1)
     {
         switch (option)
         {
@@ -162,6 +1101,39 @@ int main(int argc, char *argv[])
         case 'B':
             bruteForce = true;
             break;
+        case 'D':
+            dsaturWorkers = atoi(optarg);
+            break;
+        case 'Y':
+            symmetryName = optarg;
+            break;
+        case 'K':
+            colouringCore = false;
+            break;
+        case 'X':
+            chromaticSearch = optarg;
+            break;
+        case 'L':
+            tabuSeconds = atof(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'A':
+            race = true;
+            break;
+        case 'Q':
+            cliqueSeconds = atof(optarg);
+            break;
+        case 'J':
+            componentWorkers = atoi(optarg);
+            break;
+        case 'b':
+            blocks = true;
+            break;
+        case 'E':
+            encodingName = optarg;
+            break;
         case 'R':
             reduction = true;
             break;
@@ -181,6 +1153,27 @@ int main(int argc, char *argv[])
         case 'o':
             solutionName = optarg;
             break;
+        case 'm':
+            metricsName = optarg;
+            break;
+        case 'q':
+            queryName = optarg;
+            break;
+        case 'T':
+            num_workers = atoi(optarg);
+            break;
+        case 'C':
+            cacheName = optarg;
+            break;
+        case 'O':
+            objectiveName = optarg;
+            break;
+        case 'S':
+            upTo = true;
+            break;
+        case 'I':
+            unroll = true;
+            break;
         case '?':
             printf("unknown option: %c\n", optopt);
             break;
@@ -193,15 +1186,49 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    int num_graphs = argc - optind;
-    Graph graphs[argc - optind];
-    for (int i = optind; i < argc; i++)
+    // The race uses the budget of -L and the threads of -D, or their defaults.
+    if (race && tabuSeconds < 0)
+        tabuSeconds = 10;
+    if (race && dsaturWorkers < 0)
+        dsaturWorkers = 1;
+
+    FILE *metricsFile = NULL;
+    if (metricsName != NULL)
     {
-        graphs[i - optind] = get_graph_from_file(argv[i]);
-        // graph_print(graphs[i - optind]);
-        // printf("\nA\n");
+        metricsFile = strcmp(metricsName, "-") == 0 ? stdout : fopen(metricsName, "a");
+        if (metricsFile == NULL)
+        {
+            printf("Cannot open %s to write measures. Exiting.\n", metricsName);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The jobs of -T only run the per-length reduction, the brute force and the colouring engines.
+    if (num_workers >= 0 && (upTo || unroll || cacheName != NULL || objectiveName != NULL))
+    {
+        printf("Options -S, -I, -C and -O cannot be used with -T. Exiting.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (num_workers >= 0)
+    {
+        job_options options = {problem, problem_parameter, bruteForce, reduction, displayTerminal, metricsFile != NULL, dsaturWorkers, symmetryName, colouringCore, chromaticSearch, tabuSeconds, seed, race, cliqueSeconds, componentWorkers, blocks, encodingName};
+        solve_files_in_parallel(argv + optind, argc - optind, num_workers, &options, metricsFile);
+        if (metricsFile != NULL && metricsFile != stdout)
+            fclose(metricsFile);
+        return 0;
     }
 
+    Metrics metrics = metrics_create();
+
+    int num_graphs = argc - optind;
+    Graph graphs[argc - optind];
+    memory_phase_end();
+    time_point parseStart = time_now();
+    parse_files_in_parallel(argv + optind, num_graphs, graphs);
+    time_point parseEnd = time_now();
+    memory_usage parseMemory = memory_phase_end();
+
     Graph graph = graphs[0];
 
 #ifdef REPARTITION
@@ -216,9 +1243,9 @@ int main(int argc, char *argv[])
         if (bruteForce)
         {
             printf("\n*******************\n*** Brute Force ***\n*******************\n\n");
-            clock_t start = clock();
+            time_point start = time_now();
             bool res = repartition_brute_force(rep_graph);
-            double end = (double)(clock() - start) / CLOCKS_PER_SEC;
+            double end = time_elapsed(start);
             printf("Brute force computed the solution in %g seconds:\n", end);
             if (res)
             {
@@ -245,14 +1272,14 @@ int main(int argc, char *argv[])
 
             Z3_context ctx = make_context();
 
-            clock_t start = clock();
+            time_point start = time_now();
 
             Z3_ast formula;
             formula = repartition_reduction(ctx, rep_graph);
 
-            clock_t timeFormula = clock();
+            time_point timeFormula = time_now();
 
-            printf("formula computed in %g seconds\n", (double)(timeFormula - start) / CLOCKS_PER_SEC);
+            printf("formula computed in %g seconds\n", timeFormula.wall - start.wall);
 
             if (printformula)
             {
@@ -272,12 +1299,14 @@ int main(int argc, char *argv[])
 #endif
             }
 
-            Z3_model model;
-            Z3_lbool isSat = solve_formula(ctx, formula, &model);
+            Z3Session session = session_create(ctx);
+            session_assert(session, formula);
+            Z3_lbool isSat = session_check(session);
+            Z3_model model = session_get_model(session);
 
-            clock_t timeSat = clock();
+            time_point timeSat = time_now();
 
-            printf("solution computed in %g seconds\n", (double)(timeSat - timeFormula) / CLOCKS_PER_SEC);
+            printf("solution computed in %g seconds\n", timeSat.wall - timeFormula.wall);
 
             switch (isSat)
             {
@@ -317,6 +1346,7 @@ int main(int argc, char *argv[])
                 break;
             }
 
+            session_delete(session);
             Z3_del_context(ctx);
         }
 
@@ -342,15 +1372,61 @@ int main(int argc, char *argv[])
         if (verbose)
             cg_print(coloured_graph);
 
+        ColouringCore core = NULL;
+        ColouredGraph solved_graph = coloured_graph;
+        if (colouringCore)
+        {
+            core = colouring_core_create(coloured_graph, num_colours);
+            solved_graph = colouring_core_get_graph(core);
+            printf("The %d-core of this graph has %d nodes (%d nodes peeled).\n", num_colours, cg_get_num_nodes(solved_graph), colouring_core_num_peeled(core));
+        }
+
+        int clique[cg_get_num_nodes(solved_graph) + 1];
+        time_point cliqueStart = time_now();
+        int size_clique = colouring_refuting_clique(solved_graph, num_colours, cliqueSeconds, clique);
+        if (size_clique > 0)
+        {
+            printf("\n**************\n*** Clique ***\n**************\n\n");
+            printf("There is no %d-colouring of this graph: it has a clique of %d nodes (found in %g seconds).\n", num_colours, size_clique, time_elapsed(cliqueStart));
+            if (metricsFile != NULL)
+            {
+                colouring_clique_metrics(metrics, argv[optind], num_colours, cg_get_num_nodes(solved_graph), size_clique, parseEnd.wall - parseStart.wall,
+                                         parseEnd.cpu - parseStart.cpu, &parseMemory, cliqueStart);
+                metrics_print_json(metrics, metricsFile);
+            }
+            if (displayTerminal)
+            {
+                printf("Nodes of the clique:");
+                for (int i = 0; i < size_clique; i++)
+                    printf(" %s", cg_get_node_name(solved_graph, clique[i]));
+                printf("\n");
+            }
+            bruteForce = false;
+            dsaturWorkers = -1;
+            race = false;
+            tabuSeconds = -1;
+            reduction = false;
+        }
+
         if (bruteForce)
         {
             printf("\n*******************\n*** Brute Force ***\n*******************\n\n");
-            clock_t start = clock();
-            bool res = colouring_brute_force(coloured_graph, num_colours);
-            double end = (double)(clock() - start) / CLOCKS_PER_SEC;
-            printf("Brute force computed the solution in %g seconds:\n", end);
+            time_point start = time_now();
+            bool res;
+            int num_components = 1;
+            if (componentWorkers >= 0)
+                res = colouring_decomposed(solved_graph, num_colours, colouring_engine_brute_force, NULL, componentWorkers, blocks, &num_components) == 1;
+            else
+                res = colouring_brute_force(solved_graph, num_colours);
+            double end = time_elapsed(start);
+            printf("Brute force computed the solution in %g seconds", end);
+            if (componentWorkers >= 0)
+                printf(" on %d %s%s", num_components, blocks ? "block" : "component", num_components > 1 ? "s" : "");
+            printf(":\n");
             if (res)
             {
+                if (core != NULL)
+                    colouring_core_extend(core);
                 printf("There is a %d-colouring of this graph.\n", num_colours);
                 if (displayTerminal)
                     cg_print_colors(coloured_graph);
@@ -367,20 +1443,137 @@ int main(int argc, char *argv[])
                 printf("There is no %d-colouring of this graph.\n", num_colours);
         }
 
+        if (dsaturWorkers >= 0 && !race)
+        {
+            printf("\n**************\n*** DSATUR ***\n**************\n\n");
+            time_point start = time_now();
+            bool res;
+            int num_components = 1;
+            if (componentWorkers >= 0)
+                res = colouring_decomposed(solved_graph, num_colours, colouring_engine_dsatur, &dsaturWorkers, componentWorkers, blocks, &num_components) == 1;
+            else
+                res = colouring_dsatur(solved_graph, num_colours, dsaturWorkers);
+            double end = time_elapsed(start);
+            printf("DSATUR computed the solution in %g seconds", end);
+            if (componentWorkers >= 0)
+                printf(" on %d %s%s", num_components, blocks ? "block" : "component", num_components > 1 ? "s" : "");
+            printf(":\n");
+            if (res)
+            {
+                if (core != NULL)
+                    colouring_core_extend(core);
+                printf("There is a %d-colouring of this graph.\n", num_colours);
+                if (displayTerminal)
+                    cg_print_colors(coloured_graph);
+                if (outputFile)
+                {
+                    int length = strlen(solutionName) + 12;
+                    char nameFile[length];
+                    snprintf(nameFile, length, "%s_Dsatur", solutionName);
+                    cg_create_dot(coloured_graph, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else
+                printf("There is no %d-colouring of this graph.\n", num_colours);
+        }
+
+        if (race || tabuSeconds >= 0)
+        {
+            time_point start = time_now();
+            bool res;
+            bool by_tabu = true;
+            if (race)
+            {
+                printf("\n*************************\n*** TabuCol vs DSATUR ***\n*************************\n\n");
+                res = colouring_race(solved_graph, num_colours, dsaturWorkers, tabuSeconds, seed, &by_tabu);
+                printf("%s answered first in %g seconds:\n", by_tabu ? "TabuCol" : "DSATUR", time_elapsed(start));
+            }
+            else
+            {
+                printf("\n***************\n*** TabuCol ***\n***************\n\n");
+                res = colouring_tabu(solved_graph, num_colours, tabuSeconds, seed);
+                printf("TabuCol stopped after %g seconds:\n", time_elapsed(start));
+            }
+            if (res)
+            {
+                if (core != NULL)
+                    colouring_core_extend(core);
+                printf("There is a %d-colouring of this graph.\n", num_colours);
+                if (displayTerminal)
+                    cg_print_colors(coloured_graph);
+                if (outputFile)
+                {
+                    int length = strlen(solutionName) + 12;
+                    char nameFile[length];
+                    snprintf(nameFile, length, "%s_Tabu", solutionName);
+                    cg_create_dot(coloured_graph, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else if (by_tabu)
+                printf("No %d-colouring found, there may be one.\n", num_colours);
+            else
+                printf("There is no %d-colouring of this graph.\n", num_colours);
+        }
+
+        if (reduction && componentWorkers >= 0)
+        {
+            printf("\n**********************************\n*** Reduction to SAT per piece ***\n**********************************\n\n");
+            time_point start = time_now();
+            colouring_reduction_options engine_options = {colouring_symmetry_of_option(symmetryName), colouring_encoding_of_option(encodingName)};
+            int num_components;
+            int res = colouring_decomposed(solved_graph, num_colours, colouring_engine_reduction, &engine_options, componentWorkers, blocks, &num_components);
+            printf("%d %s%s solved in %g seconds:\n", num_components, blocks ? "block" : "component", num_components > 1 ? "s" : "", time_elapsed(start));
+            if (res == 1)
+            {
+                if (core != NULL)
+                    colouring_core_extend(core);
+                printf("There is a %d-colouring of this graph.\n", num_colours);
+                if (displayTerminal)
+                    cg_print_colors(coloured_graph);
+                if (outputFile)
+                {
+                    int length = strlen(solutionName) + 12;
+                    char nameFile[length];
+                    snprintf(nameFile, length, "%s_Sat", solutionName);
+                    cg_create_dot(coloured_graph, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else if (res == 0)
+                printf("No %d-colouring of this graph is possible\n", num_colours);
+            else
+                printf("Not able to decide if there is a %d-colouring of this graph.\n", num_colours);
+            // The formula and the model of each component are not shown: -F and -M need the single formula.
+            reduction = false;
+        }
+
         if (reduction)
         {
             printf("\n************************\n*** Reduction to SAT ***\n************************\n\n");
 
             Z3_context ctx = make_context();
 
-            clock_t start = clock();
+            metrics_reset(metrics);
+            metrics_set_label(metrics, "problem", "Colouring");
+            metrics_set_label(metrics, "file", argv[optind]);
+            metrics_set_counter(metrics, "colours", num_colours);
+            metrics_set_label(metrics, "symmetry", symmetryName != NULL ? symmetryName : "clique");
+            metrics_set_label(metrics, "encoding", encodingName != NULL ? encodingName : "direct");
+            colouring_encoding encoding = colouring_encoding_of_option(encodingName);
+            metrics_set_counter(metrics, "core_nodes", cg_get_num_nodes(solved_graph));
+            metrics_add_phase_duration(metrics, "parse", parseEnd.wall - parseStart.wall, parseEnd.cpu - parseStart.cpu, &parseMemory);
+
+            time_point start = time_now();
 
             Z3_ast formula;
-            formula = colouring_reduction(ctx, coloured_graph, num_colours);
+            formula = colouring_reduction_encoded(ctx, solved_graph, num_colours, colouring_symmetry_of_option(symmetryName), encoding);
 
-            clock_t timeFormula = clock();
+            time_point timeFormula = time_now();
+            metrics_add_phase(metrics, "colouring_reduction", start);
 
-            printf("formula computed in %g seconds\n", (double)(timeFormula - start) / CLOCKS_PER_SEC);
+            printf("formula computed in %g seconds\n", timeFormula.wall - start.wall);
 
             if (printformula)
             {
@@ -396,12 +1589,18 @@ int main(int argc, char *argv[])
                 printf("Formula printed in sol/%s.formula\n", solutionName);
             }
 
-            Z3_model model;
-            Z3_lbool isSat = solve_formula(ctx, formula, &model);
+            time_point phaseStart = time_now();
+            Z3Session session = session_create(ctx);
+            session_assert(session, formula);
+            metrics_add_phase(metrics, "assert", phaseStart);
+            phaseStart = time_now();
+            Z3_lbool isSat = session_check(session);
+            Z3_model model = session_get_model(session);
+            metrics_add_phase(metrics, "check", phaseStart);
 
-            clock_t timeSat = clock();
+            time_point timeSat = time_now();
 
-            printf("solution computed in %g seconds\n", (double)(timeSat - timeFormula) / CLOCKS_PER_SEC);
+            printf("solution computed in %g seconds\n", timeSat.wall - timeFormula.wall);
 
             switch (isSat)
             {
@@ -416,8 +1615,14 @@ int main(int argc, char *argv[])
             case Z3_L_TRUE:
                 printf("There is a %d-colouring of this graph.\n", num_colours);
 
+                phaseStart = time_now();
                 if (displayTerminal || outputFile)
-                    colour_graph_from_model(ctx, model, coloured_graph, num_colours);
+                {
+                    colour_graph_from_model(ctx, model, solved_graph, num_colours, encoding);
+                    if (core != NULL)
+                        colouring_core_extend(core);
+                }
+                metrics_add_phase(metrics, "decode", phaseStart);
 
                 //            if (displayModel)
                 //                printModel(ctx, model, biGraph, numComponent);
@@ -427,7 +1632,7 @@ int main(int argc, char *argv[])
                     cg_print_colors(coloured_graph);
                 }
                 if (printModel)
-                    colouring_print_model(ctx, model, coloured_graph, num_colours);
+                    colouring_print_model(ctx, model, solved_graph, num_colours, encoding);
 
                 if (outputFile)
                 {
@@ -441,9 +1646,47 @@ int main(int argc, char *argv[])
                 break;
             }
 
+            if (metricsFile != NULL)
+            {
+                metrics_set_label(metrics, "result", isSat == Z3_L_TRUE ? "sat" : isSat == Z3_L_FALSE ? "unsat" : "unknown");
+                metrics_add_formula_size(metrics, ctx, "colouring_reduction", formula);
+                metrics_add_session_statistics(metrics, session);
+                metrics_print_json(metrics, metricsFile);
+            }
+
+            session_delete(session);
             Z3_del_context(ctx);
         }
 
+        if (chromaticSearch != NULL)
+        {
+            printf("\n************************\n*** Chromatic number ***\n************************\n\n");
+            Z3_context ctx = make_context();
+            time_point start = time_now();
+            int num_calls;
+            int chromatic = colouring_chromatic_number(ctx, coloured_graph, colouring_symmetry_of_option(symmetryName), colouring_encoding_of_option(encodingName), chromatic_binary_of_option(chromaticSearch), &num_calls);
+            printf("Chromatic number computed in %g seconds (%d solver calls):\n", time_elapsed(start), num_calls);
+            if (chromatic >= 0)
+            {
+                printf("The chromatic number of this graph is %d.\n", chromatic);
+                if (displayTerminal)
+                    cg_print_colors(coloured_graph);
+                if (outputFile)
+                {
+                    int length = strlen(solutionName) + 12;
+                    char nameFile[length];
+                    snprintf(nameFile, length, "%s_Chromatic", solutionName);
+                    cg_create_dot(coloured_graph, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else
+                printf("Not able to decide the chromatic number of this graph.\n");
+            Z3_del_context(ctx);
+        }
+
+        if (core != NULL)
+            colouring_core_delete(core);
         cg_delete(coloured_graph);
     }
 #endif
@@ -479,9 +1722,9 @@ int main(int argc, char *argv[])
         if (bruteForce)
         {
             printf("\n*******************\n*** Brute Force ***\n*******************\n\n");
-            clock_t start = clock();
+            time_point start = time_now();
             bool res = deadlock_brute_force(automata, num_graphs, bound, path);
-            double end = (double)(clock() - start) / CLOCKS_PER_SEC;
+            double end = time_elapsed(start);
             printf("Brute force computed the solution in %g seconds:\n", end);
             if (res)
             {
@@ -507,14 +1750,14 @@ int main(int argc, char *argv[])
 
             Z3_context ctx = make_context();
 
-            clock_t start = clock();
+            time_point start = time_now();
 
             Z3_ast formula;
             formula = deadlock_reduction(ctx, automata, num_graphs, bound);
 
-            clock_t timeFormula = clock();
+            time_point timeFormula = time_now();
 
-            printf("formula computed in %g seconds\n", (double)(timeFormula - start) / CLOCKS_PER_SEC);
+            printf("formula computed in %g seconds\n", timeFormula.wall - start.wall);
 
             if (printformula)
             {
@@ -534,12 +1777,14 @@ int main(int argc, char *argv[])
 #endif
             }
 
-            Z3_model model;
-            Z3_lbool isSat = solve_formula(ctx, formula, &model);
+            Z3Session session = session_create(ctx);
+            session_assert(session, formula);
+            Z3_lbool isSat = session_check(session);
+            Z3_model model = session_get_model(session);
 
-            clock_t timeSat = clock();
+            time_point timeSat = time_now();
 
-            printf("solution computed in %g seconds\n", (double)(timeSat - timeFormula) / CLOCKS_PER_SEC);
+            printf("solution computed in %g seconds\n", timeSat.wall - timeFormula.wall);
 
             switch (isSat)
             {
@@ -578,6 +1823,7 @@ int main(int argc, char *argv[])
                 break;
             }
 
+            session_delete(session);
             Z3_del_context(ctx);
         }
 
@@ -589,8 +1835,20 @@ int main(int argc, char *argv[])
 #ifdef TUNNEL
     if (problem == Tunnel)
     {
-        printf("\n*****************************************\n*** Tunnel Network Problem ***\n*****************************************\n\n");
+        if (queryName == NULL)
+            printf("\n*****************************************\n*** Tunnel Network Problem ***\n*****************************************\n\n");
+        time_point initStart = time_now();
         TunnelNetwork network = tn_initialize(graph);
+        Graph pruned;
+        bool is_pruned = componentWorkers >= 0 && queryName == NULL && tn_endpoints_subgraph(network, &pruned);
+        if (is_pruned)
+        {
+            printf("%d nodes dropped, outside the connected components of the initial and final nodes.\n", graph_num_nodes(graph) - graph_num_nodes(pruned));
+            tn_delete(network);
+            network = tn_initialize(pruned);
+        }
+        time_point initEnd = time_now();
+        memory_usage initMemory = memory_phase_end();
         if (verbose)
         {
             tn_print(network);
@@ -606,14 +1864,41 @@ int main(int argc, char *argv[])
             path[step] = tn_step_empty();
         }
 
+        TunnelCache cache = NULL;
+        if (cacheName != NULL && (cache = tn_cache_open(cacheName, TN_CACHE_DEFAULT_SIZE)) == NULL)
+        {
+            printf("Cannot open the cache directory %s. Exiting.\n", cacheName);
+            exit(EXIT_FAILURE);
+        }
+        unsigned long long fingerprint = cache != NULL ? tn_fingerprint(network) : 0;
+
+        if (queryName != NULL)
+        {
+            if (!tn_answer_queries(network, queryName, bound, bruteForce && !reduction, cache))
+                exit(EXIT_FAILURE);
+            bruteForce = false;
+            reduction = false;
+        }
+
         if (bruteForce)
         {
             printf("\n*******************\n*** Brute Force ***\n*******************\n\n");
 #ifndef SUBJECT
-            clock_t start = clock();
-            int res = tn_brute_force(network, bound, path);
-            double end = (double)(clock() - start) / CLOCKS_PER_SEC;
-            printf("Brute force computed the solution in %g seconds:\n", end);
+            time_point start = time_now();
+            tn_cache_key key = {fingerprint, tn_get_initial(network), tn_get_final(network), bound, "bf"};
+            int res;
+            bool cached = cache != NULL && tn_cache_lookup(cache, network, &key, &res, path, NULL);
+            if (!cached)
+            {
+                res = tn_brute_force(network, bound, path);
+                if (cache != NULL)
+                    tn_cache_store(cache, network, &key, res, path);
+            }
+            double end = time_elapsed(start);
+            if (cached)
+                printf("Brute force solution found in the cache in %g seconds:\n", end);
+            else
+                printf("Brute force computed the solution in %g seconds:\n", end);
             if (res > 0)
             {
                 printf("There is a simple path of size %d.\n", res);
@@ -635,24 +1920,178 @@ int main(int argc, char *argv[])
 #endif
         }
 
+        if (reduction && objectiveName != NULL)
+        {
+            tn_objective objective;
+            if (!tn_objective_of_string(objectiveName, &objective))
+            {
+                printf("Invalid cost %s (expected terms hops, push or cost, optionally followed by =WEIGHT, separated by commas). Exiting.\n", objectiveName);
+                exit(EXIT_FAILURE);
+            }
+            printf("\n*****************************\n*** Optimisation with SAT ***\n*****************************\n\n");
+            Z3_context ctx = make_context();
+            tn_metrics_start(metrics, argv[optind], bound, parseEnd.wall - parseStart.wall, parseEnd.cpu - parseStart.cpu, &parseMemory, initStart, initEnd, &initMemory);
+            metrics_set_label(metrics, "engine", "optimize");
+            time_point start = time_now();
+            int length = 0;
+            Z3_lbool result = tn_optimize(ctx, network, tn_get_initial(network), tn_get_final(network), bound, objective, path, &length);
+            metrics_add_phase(metrics, "optimize", start);
+            printf("Optimisation over the sizes up to %d done in %g seconds\n", bound, time_elapsed(start));
+            if (metricsFile != NULL)
+            {
+                metrics_set_label(metrics, "result", result == Z3_L_TRUE ? "sat" : result == Z3_L_FALSE ? "unsat" : "unknown");
+                if (result == Z3_L_TRUE)
+                    metrics_set_counter(metrics, "size", length);
+                metrics_print_json(metrics, metricsFile);
+            }
+            if (result == Z3_L_TRUE)
+            {
+                printf("The best simple path has size %d and cost %ld.\n", length, tn_objective_value(network, objective, path, length));
+                if (displayTerminal)
+                    tn_print_path(network, path, length);
+                if (outputFile)
+                {
+                    int nameLength = strlen(solutionName) + 12;
+                    char nameFile[nameLength];
+                    snprintf(nameFile, nameLength, "%s_Opt", solutionName);
+                    tn_create_dot(network, path, length, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else if (result == Z3_L_FALSE)
+                printf("No simple path of size at most %d exists\n", bound);
+            else
+                printf("Not able to decide if there is a simple path of size at most %d.\n", bound);
+            Z3_del_context(ctx);
+            reduction = false;
+        }
+
+        tn_cache_key key = {fingerprint, tn_get_initial(network), tn_get_final(network), bound, "sat"};
+        int cachedLength, cachedUnsat = 0;
+        if (reduction && cache != NULL && tn_cache_lookup(cache, network, &key, &cachedLength, path, &cachedUnsat))
+        {
+            printf("\n************************\n*** Reduction to SAT ***\n************************\n\n");
+            printf("Solution found in the cache %s:\n", cacheName);
+            if (cachedLength > 0)
+            {
+                printf("There is a simple path of size %d.\n", cachedLength);
+                if (displayTerminal)
+                    tn_print_path(network, path, cachedLength);
+                if (outputFile)
+                {
+                    int length = strlen(solutionName) + 12;
+                    char nameFile[length];
+                    snprintf(nameFile, length, "%s_Sat", solutionName);
+                    tn_create_dot(network, path, cachedLength, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else
+                printf("No simple path of size at most %d exists\n", bound);
+            reduction = false;
+        }
+
+        if (reduction && (upTo || unroll))
+        {
+            printf("\n************************\n*** Reduction to SAT ***\n************************\n\n");
+            Z3_context ctx = make_context();
+            time_point start = time_now();
+            int found;
+            if (upTo)
+            {
+                tn_metrics_start(metrics, argv[optind], bound, parseEnd.wall - parseStart.wall, parseEnd.cpu - parseStart.cpu, &parseMemory, initStart, initEnd, &initMemory);
+                metrics_set_label(metrics, "engine", "upto");
+                found = tn_shortest_up_to(ctx, network, tn_get_initial(network), tn_get_final(network), bound, path);
+                metrics_add_phase(metrics, "optimize", start);
+                printf("Formula for the sizes up to %d computed and optimised in %g seconds\n", bound, time_elapsed(start));
+                if (metricsFile != NULL)
+                {
+                    metrics_set_label(metrics, "result", found > 0 ? "sat" : found == 0 ? "unsat" : "unknown");
+                    if (found > 0)
+                        metrics_set_counter(metrics, "size", found);
+                    metrics_print_json(metrics, metricsFile);
+                }
+            }
+            else
+            {
+                TunnelUnrolling unrolling = tn_unrolling_create(ctx, network, bound);
+                found = 0;
+                if (cachedUnsat > 0)
+                    printf("No simple path of size at most %d in the cache %s, these sizes are skipped.\n", cachedUnsat, cacheName);
+                for (int l = cachedUnsat + 1; l <= bound && found == 0; l++)
+                {
+                    tn_metrics_start(metrics, argv[optind], l, parseEnd.wall - parseStart.wall, parseEnd.cpu - parseStart.cpu, &parseMemory, initStart, initEnd, &initMemory);
+                    metrics_set_label(metrics, "engine", "unroll");
+                    time_point phaseStart = time_now();
+                    Z3_lbool isSat = tn_unrolling_check(unrolling, tn_get_initial(network), tn_get_final(network), l, path);
+                    metrics_add_phase(metrics, "check", phaseStart);
+                    if (isSat != Z3_L_FALSE)
+                        found = isSat == Z3_L_TRUE ? l : -1;
+                    if (metricsFile != NULL)
+                    {
+                        metrics_set_label(metrics, "result", isSat == Z3_L_TRUE ? "sat" : isSat == Z3_L_FALSE ? "unsat" : "unknown");
+                        metrics_add_session_statistics(metrics, tn_unrolling_get_session(unrolling));
+                        metrics_print_json(metrics, metricsFile);
+                    }
+                }
+                printf("%d frames unrolled and solved in %g seconds\n", tn_unrolling_num_frames(unrolling), time_elapsed(start));
+                tn_unrolling_delete(unrolling);
+            }
+            if (found > 0)
+            {
+                printf("There is a simple path of size %d.\n", found);
+                if (displayTerminal)
+                    tn_print_path(network, path, found);
+                if (outputFile)
+                {
+                    int length = strlen(solutionName) + 12;
+                    char nameFile[length];
+                    snprintf(nameFile, length, "%s_Sat", solutionName);
+                    tn_create_dot(network, path, found, nameFile);
+                    printf("Solution printed in sol/%s.dot.\n", nameFile);
+                }
+            }
+            else if (found == 0)
+                printf("No simple path of size at most %d exists\n", bound);
+            else
+                printf("Not able to decide if there is a simple path of size at most %d.\n", bound);
+            if (cache != NULL && found >= 0)
+                tn_cache_store(cache, network, &key, found, path);
+            Z3_del_context(ctx);
+            reduction = false;
+        }
+
         if (reduction)
         {
             printf("\n************************\n*** Reduction to SAT ***\n************************\n\n");
 
             Z3_context ctx = make_context();
+            Z3Session session = session_create(ctx);
+            int found = 0;
+            bool decided = true;
+            if (cachedUnsat > 0)
+                printf("No simple path of size at most %d in the cache %s, these sizes are skipped.\n", cachedUnsat, cacheName);
 
-            for (int l = 1; l <= bound; l++)
+            for (int l = cachedUnsat + 1; l <= bound; l++)
             {
                 printf("\n--- size %d ---\n", l);
 
-                clock_t start = clock();
+                tn_metrics_start(metrics, argv[optind], l, parseEnd.wall - parseStart.wall, parseEnd.cpu - parseStart.cpu, &parseMemory, initStart, initEnd, &initMemory);
 
-                Z3_ast formula;
-                formula = tn_reduction(ctx, network, l);
+                time_point start = time_now();
 
-                clock_t timeFormula = clock();
+                Z3_ast families[TN_NUM_FAMILIES];
+                for (int family = 0; family < TN_NUM_FAMILIES; family++)
+                {
+                    time_point familyStart = time_now();
+                    families[family] = tn_reduction_family(ctx, network, l, family);
+                    metrics_add_phase(metrics, tn_family_name(family), familyStart);
+                }
+                Z3_ast formula = Z3_mk_and(ctx, TN_NUM_FAMILIES, families);
 
-                printf("formula for size %d computed in %g seconds\n", l, (double)(timeFormula - start) / CLOCKS_PER_SEC);
+                time_point timeFormula = time_now();
+
+                printf("formula for size %d computed in %g seconds\n", l, timeFormula.wall - start.wall);
 
                 if (printformula)
                 {
@@ -672,12 +2111,28 @@ int main(int argc, char *argv[])
 #endif
                 }
 
-                Z3_model model;
-                Z3_lbool isSat = solve_formula(ctx, formula, &model);
+                time_point phaseStart = time_now();
+                session_push(session);
+                session_assert(session, formula);
+                metrics_add_phase(metrics, "assert", phaseStart);
+                phaseStart = time_now();
+                Z3_lbool isSat = session_check(session);
+                Z3_model model = session_get_model(session);
+                metrics_add_phase(metrics, "check", phaseStart);
 
-                clock_t timeSat = clock();
+                if (metricsFile != NULL)
+                {
+                    metrics_set_label(metrics, "result", isSat == Z3_L_TRUE ? "sat" : isSat == Z3_L_FALSE ? "unsat" : "unknown");
+                    for (int family = 0; family < TN_NUM_FAMILIES; family++)
+                        metrics_add_formula_size(metrics, ctx, tn_family_name(family), families[family]);
+                    metrics_add_session_statistics(metrics, session);
+                    if (isSat != Z3_L_TRUE)
+                        metrics_print_json(metrics, metricsFile);
+                }
+
+                time_point timeSat = time_now();
 
-                printf("solution computed in %g seconds\n", (double)(timeSat - timeFormula) / CLOCKS_PER_SEC);
+                printf("solution computed in %g seconds\n", timeSat.wall - timeFormula.wall);
 
                 switch (isSat)
                 {
@@ -687,16 +2142,22 @@ int main(int argc, char *argv[])
 
                 case Z3_L_UNDEF:
                     printf("Not able to decide if there is a simple path of size %d.\n", l);
+                    decided = false;
                     break;
 
                 case Z3_L_TRUE:
                     printf("There is a simple path of size %d.\n", l);
+                    found = l;
+
+                    phaseStart = time_now();
+                    tn_get_path_from_model(ctx, model, network, l, path);
+                    metrics_add_phase(metrics, "decode", phaseStart);
+                    if (metricsFile != NULL)
+                        metrics_print_json(metrics, metricsFile);
 
                     if (!(displayTerminal || outputFile || printModel))
                         goto TN_end;
 
-                    tn_get_path_from_model(ctx, model, network, l, path);
-
                     if (displayTerminal)
                     {
                         tn_print_path(network, path, l);
@@ -715,18 +2176,30 @@ int main(int argc, char *argv[])
 
                     goto TN_end;
                 }
+                session_pop(session, 1);
             }
 
         TN_end:
+            if (cache != NULL && decided)
+                tn_cache_store(cache, network, &key, found, path);
+            session_delete(session);
             Z3_del_context(ctx);
         }
 
+        if (cache != NULL)
+            tn_cache_close(cache);
         tn_delete(network);
+        if (is_pruned)
+            graph_delete(pruned);
     }
 #endif
 
     for (int i = 0; i < num_graphs; i++)
         graph_delete(graphs[i]);
 
+    metrics_delete(metrics);
+    if (metricsFile != NULL && metricsFile != stdout)
+        fclose(metricsFile);
+
     return 0;
 }
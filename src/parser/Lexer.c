@@ -1,6 +1,27 @@
-#line 2 "src/parser/Lexer.c"
+#line 63 "src/parser/Lexer.l"
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+/**
+ * @brief Creates a scanner with its own buffers for the names.
+ *
+ * @param scanner Pointer to the scanner to create.
+ * @return int 0 on success, as yylex_init.
+ */
+int lexer_create(yyscan_t *scanner);
+
+/**
+ * @brief Destroys a scanner created by lexer_create, and its buffers.
+ *
+ * @param scanner A scanner.
+ */
+void lexer_delete(yyscan_t scanner);
+
+#line 23 "src/parser/Lexer.c"
 
-#line 4 "src/parser/Lexer.c"
+#line 25 "src/parser/Lexer.c"
 
 #define  YY_INT_ALIGNED short int
 
@@ -492,16 +513,53 @@ static const flex_int16_t yy_chk[120] =
 #include <stdlib.h>
 #include "GraphList.h"
 #include "Parser.h"
+#include "Memory.h"
+
+/**
+ * @brief Number of buffers of a scanner for the names it reads. The parser reads at most one token ahead before copying the name of the previous
+ *        one, so two buffers used in turn keep that name intact.
+ *
+ */
+#define LEXER_NUM_BUFFERS 2
 
- 
- #define MAXSIZE  1024
-char any_name_s[MAXSIZE];
+/**
+ * @brief The names read by a scanner, kept in its extra data (yyextra) instead of a global variable, so that several scanners can run at the same time.
+ *
+ */
+typedef struct
+{
+    char *names[LEXER_NUM_BUFFERS];  ///< The buffers, grown as needed.
+    size_t sizes[LEXER_NUM_BUFFERS]; ///< Their allocated sizes.
+    int next;                        ///< The buffer receiving the next name.
+} lexer_names;
+
+/**
+ * @brief Copies the name @p text of length @p length in the next buffer of @p names, growing it if needed.
+ *
+ * @param names The buffers of a scanner.
+ * @param text The name read.
+ * @param length Its length.
+ * @return char* The copy, valid until two more names are read.
+ */
+static char *lexer_keep_name(lexer_names *names, const char *text, size_t length)
+{
+    int buffer = names->next;
+    names->next = (buffer + 1) % LEXER_NUM_BUFFERS;
+    if (names->sizes[buffer] < length + 1)
+    {
+        names->sizes[buffer] = 2 * (length + 1);
+        names->names[buffer] = (char *)memory_realloc(names->names[buffer], names->sizes[buffer] * sizeof(char), MemoryParser);
+    }
+    memcpy(names->names[buffer], text, length);
+    names->names[buffer][length] = '\0';
+    return names->names[buffer];
+}
 
-#line 501 "src/parser/Lexer.c"
+#line 559 "src/parser/Lexer.c"
 /* %option outfile="Lexer.c" header-file="Lexer.h"  //for normal make.*/
 #define YY_NO_UNISTD_H 1
 #define YY_NO_INPUT 1
-#line 505 "src/parser/Lexer.c"
+#line 563 "src/parser/Lexer.c"
 
 #define INITIAL 0
 
@@ -773,9 +831,9 @@ YY_DECL
 		}
 
 	{
-#line 64 "src/parser/Lexer.l"
+#line 123 "src/parser/Lexer.l"
 
-#line 779 "src/parser/Lexer.c"
+#line 837 "src/parser/Lexer.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -830,132 +888,129 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 65 "src/parser/Lexer.l"
+#line 124 "src/parser/Lexer.l"
 { }
 	YY_BREAK
 case 2:
 /* rule 2 can match eol */
 YY_RULE_SETUP
-#line 66 "src/parser/Lexer.l"
-{ strcpy(any_name_s,yytext);
-                  yylval->name = any_name_s;
+#line 125 "src/parser/Lexer.l"
+{ yylval->name = lexer_keep_name(yyextra, yytext, yyleng);
                   return(T_STRING); }
 	YY_BREAK
 case 3:
 /* rule 3 can match eol */
 YY_RULE_SETUP
-#line 69 "src/parser/Lexer.l"
+#line 127 "src/parser/Lexer.l"
 ;
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
-#line 70 "src/parser/Lexer.l"
+#line 128 "src/parser/Lexer.l"
 { return(T_LBRACKET); }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 71 "src/parser/Lexer.l"
+#line 129 "src/parser/Lexer.l"
 { return(T_RBRACKET); }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 72 "src/parser/Lexer.l"
+#line 130 "src/parser/Lexer.l"
 { return(T_LPAREN); }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 73 "src/parser/Lexer.l"
+#line 131 "src/parser/Lexer.l"
 { return(T_RPAREN); }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 74 "src/parser/Lexer.l"
+#line 132 "src/parser/Lexer.l"
 { return(T_LBRACE); }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 75 "src/parser/Lexer.l"
+#line 133 "src/parser/Lexer.l"
 { return(T_RBRACE); }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 76 "src/parser/Lexer.l"
+#line 134 "src/parser/Lexer.l"
 { return(T_COMMA); }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 77 "src/parser/Lexer.l"
+#line 135 "src/parser/Lexer.l"
 { return(T_COLON); }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 78 "src/parser/Lexer.l"
+#line 136 "src/parser/Lexer.l"
 { return(T_SEMI); }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 79 "src/parser/Lexer.l"
+#line 137 "src/parser/Lexer.l"
 { return(T_DEDGE); }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 80 "src/parser/Lexer.l"
+#line 138 "src/parser/Lexer.l"
 { return(T_UEDGE); }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 81 "src/parser/Lexer.l"
+#line 139 "src/parser/Lexer.l"
 { return(T_EQ); }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 82 "src/parser/Lexer.l"
+#line 140 "src/parser/Lexer.l"
 { return(T_DIGRAPH); }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 83 "src/parser/Lexer.l"
+#line 141 "src/parser/Lexer.l"
 { return(T_GRAPH); }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 84 "src/parser/Lexer.l"
+#line 142 "src/parser/Lexer.l"
 { return(T_SUBGRAPH); }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 85 "src/parser/Lexer.l"
+#line 143 "src/parser/Lexer.l"
 { return(T_AT); }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 86 "src/parser/Lexer.l"
+#line 144 "src/parser/Lexer.l"
 { return(T_STRICT); }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 87 "src/parser/Lexer.l"
+#line 145 "src/parser/Lexer.l"
 { return(T_NODE); }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 88 "src/parser/Lexer.l"
+#line 146 "src/parser/Lexer.l"
 { return(T_EDGE); }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 89 "src/parser/Lexer.l"
-{ //any_name_s = malloc(sizeof(yytext)+1);
-                  strcpy(any_name_s, yytext);
-                  yylval->name = any_name_s;
+#line 147 "src/parser/Lexer.l"
+{ yylval->name = lexer_keep_name(yyextra, yytext, yyleng);
                   return(T_ID); }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 94 "src/parser/Lexer.l"
+#line 150 "src/parser/Lexer.l"
 ECHO;
 	YY_BREAK
-#line 959 "src/parser/Lexer.c"
+#line 1014 "src/parser/Lexer.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -2099,8 +2154,24 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 94 "src/parser/Lexer.l"
+#line 150 "src/parser/Lexer.l"
 
 
+int lexer_create(yyscan_t *scanner)
+{
+    lexer_names *names = (lexer_names *)memory_calloc(1, sizeof(lexer_names), MemoryParser);
+    int result = yylex_init_extra(names, scanner);
+    if (result != 0)
+        memory_free(names);
+    return result;
+}
 
+void lexer_delete(yyscan_t scanner)
+{
+    lexer_names *names = (lexer_names *)yyget_extra(scanner);
+    for (int buffer = 0; buffer < LEXER_NUM_BUFFERS; buffer++)
+        memory_free(names->names[buffer]);
+    memory_free(names);
+    yylex_destroy(scanner);
+}
 
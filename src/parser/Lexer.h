@@ -2,9 +2,30 @@
 #define yyHEADER_H 1
 #define yyIN_HEADER 1
 
-#line 6 "src/parser/Lexer.h"
+#line 63 "src/parser/Lexer.l"
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+/**
+ * @brief Creates a scanner with its own buffers for the names.
+ *
+ * @param scanner Pointer to the scanner to create.
+ * @return int 0 on success, as yylex_init.
+ */
+int lexer_create(yyscan_t *scanner);
+
+/**
+ * @brief Destroys a scanner created by lexer_create, and its buffers.
+ *
+ * @param scanner A scanner.
+ */
+void lexer_delete(yyscan_t scanner);
+
+#line 27 "src/parser/Lexer.h"
 
-#line 8 "src/parser/Lexer.h"
+#line 29 "src/parser/Lexer.h"
 
 #define  YY_INT_ALIGNED short int
 
@@ -502,9 +523,9 @@ extern int yylex \
 #undef yyTABLES_NAME
 #endif
 
-#line 94 "src/parser/Lexer.l"
+#line 150 "src/parser/Lexer.l"
 
 
-#line 509 "src/parser/Lexer.h"
+#line 530 "src/parser/Lexer.h"
 #undef yyIN_HEADER
 #endif /* yyHEADER_H */
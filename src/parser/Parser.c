@@ -90,7 +90,7 @@
 
 int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
     /* Add error handling routine as needed */
-    printf("Erreur: %s\n",msg);
+    fprintf(stderr, "Erreur: %s\n", msg);
     return 0;
 }
  
@@ -556,12 +556,12 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    91,    91,    94,    95,    98,    99,   102,   103,   106,
-     107,   109,   110,   113,   114,   115,   116,   117,   120,   121,
-     122,   125,   126,   127,   130,   133,   134,   137,   142,   147,
-     149,   153,   154,   160,   164,   170,   171,   172,   173,   176,
-     177,   180,   183,   187,   191,   192,   195,   198,   205,   206,
-     207,   210,   211
+       0,    95,    95,    98,    99,   102,   103,   106,   107,   110,
+     111,   113,   114,   117,   118,   119,   120,   121,   124,   125,
+     126,   129,   130,   131,   134,   137,   138,   141,   146,   151,
+     153,   157,   158,   164,   168,   174,   175,   176,   177,   180,
+     181,   184,   187,   191,   195,   196,   199,   202,   209,   210,
+     211,   214,   215
 };
 #endif
 
@@ -918,7 +918,47 @@ yydestruct (const char *yymsg,
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YY_USE (yykind);
+  switch (yykind)
+    {
+    case YYSYMBOL_attr_list: /* attr_list  */
+#line 88 "src/parser/Parser.y"
+            { parameter_list_delete(((*yyvaluep).parameterInfo).parameters); }
+#line 927 "src/parser/Parser.c"
+        break;
+
+    case YYSYMBOL_a_list: /* a_list  */
+#line 88 "src/parser/Parser.y"
+            { parameter_list_delete(((*yyvaluep).parameterInfo).parameters); }
+#line 933 "src/parser/Parser.c"
+        break;
+
+    case YYSYMBOL_attr_assignment: /* attr_assignment  */
+#line 88 "src/parser/Parser.y"
+            { parameter_list_delete(((*yyvaluep).parameterInfo).parameters); }
+#line 939 "src/parser/Parser.c"
+        break;
+
+    case YYSYMBOL_idrhs: /* idrhs  */
+#line 87 "src/parser/Parser.y"
+            { free(((*yyvaluep).name)); }
+#line 945 "src/parser/Parser.c"
+        break;
+
+    case YYSYMBOL_node_id: /* node_id  */
+#line 87 "src/parser/Parser.y"
+            { free(((*yyvaluep).name)); }
+#line 951 "src/parser/Parser.c"
+        break;
+
+    case YYSYMBOL_edgerhs: /* edgerhs  */
+#line 87 "src/parser/Parser.y"
+            { free(((*yyvaluep).name)); }
+#line 957 "src/parser/Parser.c"
+        break;
+
+      default:
+        break;
+    }
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1187,164 +1227,194 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* input: strict graph_type idrhs T_LBRACE stmt_list T_RBRACE  */
-#line 91 "src/parser/Parser.y"
+#line 95 "src/parser/Parser.y"
                                                             {graph->name = (yyvsp[-3].name);}
-#line 1193 "src/parser/Parser.c"
+#line 1233 "src/parser/Parser.c"
     break;
 
   case 5: /* graph_type: T_DIGRAPH  */
-#line 98 "src/parser/Parser.y"
+#line 102 "src/parser/Parser.y"
                         { graph->directed = true;}
-#line 1199 "src/parser/Parser.c"
+#line 1239 "src/parser/Parser.c"
     break;
 
   case 6: /* graph_type: T_GRAPH  */
-#line 99 "src/parser/Parser.y"
+#line 103 "src/parser/Parser.y"
                         { graph->directed = false;}
-#line 1205 "src/parser/Parser.c"
+#line 1245 "src/parser/Parser.c"
     break;
 
-  case 21: /* attr_list: T_LBRACKET a_list T_RBRACKET  */
+  case 18: /* attr_stmt: T_GRAPH attr_list  */
+#line 124 "src/parser/Parser.y"
+                                               { parameter_list_delete((yyvsp[0].parameterInfo).parameters); }
+#line 1251 "src/parser/Parser.c"
+    break;
+
+  case 19: /* attr_stmt: T_NODE attr_list  */
 #line 125 "src/parser/Parser.y"
+                                                { parameter_list_delete((yyvsp[0].parameterInfo).parameters); }
+#line 1257 "src/parser/Parser.c"
+    break;
+
+  case 20: /* attr_stmt: T_EDGE attr_list  */
+#line 126 "src/parser/Parser.y"
+                                                { parameter_list_delete((yyvsp[0].parameterInfo).parameters); }
+#line 1263 "src/parser/Parser.c"
+    break;
+
+  case 21: /* attr_list: T_LBRACKET a_list T_RBRACKET  */
+#line 129 "src/parser/Parser.y"
                                                 { (yyval.parameterInfo) = (yyvsp[-1].parameterInfo); }
-#line 1211 "src/parser/Parser.c"
+#line 1269 "src/parser/Parser.c"
     break;
 
   case 22: /* attr_list: T_LBRACKET T_RBRACKET  */
-#line 126 "src/parser/Parser.y"
+#line 130 "src/parser/Parser.y"
                                                 { (yyval.parameterInfo).parameters=NULL;}
-#line 1217 "src/parser/Parser.c"
+#line 1275 "src/parser/Parser.c"
     break;
 
   case 23: /* attr_list: T_LBRACKET a_list T_RBRACKET attr_list  */
-#line 127 "src/parser/Parser.y"
+#line 131 "src/parser/Parser.y"
                                                 { 
                                                 (yyval.parameterInfo).parameters = parameter_lists_merge((yyvsp[-2].parameterInfo).parameters,(yyvsp[0].parameterInfo).parameters);
                                                 }
-#line 1225 "src/parser/Parser.c"
+#line 1283 "src/parser/Parser.c"
     break;
 
   case 24: /* attr_list: T_LBRACKET T_RBRACKET attr_list  */
-#line 130 "src/parser/Parser.y"
+#line 134 "src/parser/Parser.y"
                                                 { (yyval.parameterInfo) = (yyvsp[0].parameterInfo); }
-#line 1231 "src/parser/Parser.c"
+#line 1289 "src/parser/Parser.c"
     break;
 
   case 25: /* a_list: attr_assignment  */
-#line 133 "src/parser/Parser.y"
+#line 137 "src/parser/Parser.y"
                                         { (yyval.parameterInfo) = (yyvsp[0].parameterInfo);}
-#line 1237 "src/parser/Parser.c"
+#line 1295 "src/parser/Parser.c"
     break;
 
   case 26: /* a_list: attr_assignment T_COMMA a_list  */
-#line 134 "src/parser/Parser.y"
+#line 138 "src/parser/Parser.y"
                                         { 
                                             (yyval.parameterInfo).parameters = parameter_lists_merge((yyvsp[-2].parameterInfo).parameters,(yyvsp[0].parameterInfo).parameters);
                                           }
-#line 1245 "src/parser/Parser.c"
+#line 1303 "src/parser/Parser.c"
     break;
 
   case 27: /* a_list: attr_assignment a_list  */
-#line 137 "src/parser/Parser.y"
+#line 141 "src/parser/Parser.y"
                                         { 
                                             (yyval.parameterInfo).parameters = parameter_lists_merge((yyvsp[-1].parameterInfo).parameters,(yyvsp[0].parameterInfo).parameters);
                                           }
-#line 1253 "src/parser/Parser.c"
+#line 1311 "src/parser/Parser.c"
     break;
 
   case 28: /* attr_assignment: idrhs T_EQ idrhs  */
-#line 142 "src/parser/Parser.y"
+#line 146 "src/parser/Parser.y"
                                      { 
       (yyval.parameterInfo).parameters = parameter_list_add_parameter(NULL,(yyvsp[-2].name),(yyvsp[0].name));
              free((yyvsp[-2].name)); free((yyvsp[0].name));}
-#line 1261 "src/parser/Parser.c"
+#line 1319 "src/parser/Parser.c"
     break;
 
   case 29: /* idrhs: T_ID  */
-#line 147 "src/parser/Parser.y"
+#line 151 "src/parser/Parser.y"
                     { (yyval.name) = (char*)malloc((strlen((yyvsp[0].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[0].name));
                     }
-#line 1268 "src/parser/Parser.c"
+#line 1326 "src/parser/Parser.c"
     break;
 
   case 30: /* idrhs: T_STRING  */
-#line 149 "src/parser/Parser.y"
+#line 153 "src/parser/Parser.y"
                     { (yyval.name) = (char*)malloc((strlen((yyvsp[0].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[0].name));
                     }
-#line 1275 "src/parser/Parser.c"
+#line 1333 "src/parser/Parser.c"
     break;
 
   case 31: /* node_stmt: node_id  */
-#line 153 "src/parser/Parser.y"
+#line 157 "src/parser/Parser.y"
                             { free((yyvsp[0].name)); }
-#line 1281 "src/parser/Parser.c"
+#line 1339 "src/parser/Parser.c"
     break;
 
   case 32: /* node_stmt: node_id attr_list  */
-#line 154 "src/parser/Parser.y"
+#line 158 "src/parser/Parser.y"
                             {   
                                 add_parameters_to_node((yyvsp[-1].name),(yyvsp[0].parameterInfo).parameters,graph->nodes);
                                 free((yyvsp[-1].name));
                             }
-#line 1290 "src/parser/Parser.c"
+#line 1348 "src/parser/Parser.c"
     break;
 
   case 33: /* node_id: T_ID  */
-#line 160 "src/parser/Parser.y"
+#line 164 "src/parser/Parser.y"
                     { 
                       (yyval.name) = (char*)malloc((strlen((yyvsp[0].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[0].name));
                       if(graph->nodes == NULL) graph->nodes = addNode((yyvsp[0].name),NULL); else addOrUpdateNode((yyvsp[0].name),graph->nodes);
                     }
-#line 1299 "src/parser/Parser.c"
+#line 1357 "src/parser/Parser.c"
     break;
 
   case 34: /* node_id: T_ID port  */
-#line 164 "src/parser/Parser.y"
+#line 168 "src/parser/Parser.y"
                     { 
                       (yyval.name) = (char*)malloc((strlen((yyvsp[-1].name))+1)*sizeof(char)); strcpy((yyval.name),(yyvsp[-1].name));
                       if(graph->nodes == NULL) graph->nodes = addNode((yyvsp[-1].name),NULL); else addOrUpdateNode((yyvsp[-1].name),graph->nodes);
                     }
-#line 1308 "src/parser/Parser.c"
+#line 1366 "src/parser/Parser.c"
     break;
 
   case 42: /* edge_stmt: node_id edgerhs  */
-#line 183 "src/parser/Parser.y"
+#line 187 "src/parser/Parser.y"
                                     { //printf("edge seen: (%s,%s)\n",$1,$2);
                                       graph->edges = addEdge((yyvsp[-1].name),(yyvsp[0].name),graph->edges,NULL);
                                       free((yyvsp[-1].name)); free((yyvsp[0].name));
                                     }
-#line 1317 "src/parser/Parser.c"
+#line 1375 "src/parser/Parser.c"
     break;
 
   case 43: /* edge_stmt: node_id edgerhs attr_list  */
-#line 187 "src/parser/Parser.y"
+#line 191 "src/parser/Parser.y"
                                     { //printf("edge seen: (%s,%s)\n",$1,$2);
                                       graph->edges = addEdge((yyvsp[-2].name),(yyvsp[-1].name),graph->edges,(yyvsp[0].parameterInfo).parameters);
                                       free((yyvsp[-2].name)); free((yyvsp[-1].name));
                                     }
-#line 1326 "src/parser/Parser.c"
+#line 1384 "src/parser/Parser.c"
     break;
 
-  case 46: /* edgerhs: edgeop node_id  */
+  case 44: /* edge_stmt: subgraph edgerhs  */
 #line 195 "src/parser/Parser.y"
+                                    { free((yyvsp[0].name)); }
+#line 1390 "src/parser/Parser.c"
+    break;
+
+  case 45: /* edge_stmt: subgraph edgerhs attr_list  */
+#line 196 "src/parser/Parser.y"
+                                    { free((yyvsp[-1].name)); parameter_list_delete((yyvsp[0].parameterInfo).parameters); }
+#line 1396 "src/parser/Parser.c"
+    break;
+
+  case 46: /* edgerhs: edgeop node_id  */
+#line 199 "src/parser/Parser.y"
                                 { //printf("edge end seen\n");
                                   (yyval.name) = (yyvsp[0].name);
                                 }
-#line 1334 "src/parser/Parser.c"
+#line 1404 "src/parser/Parser.c"
     break;
 
   case 47: /* edgerhs: edgeop node_id edgerhs  */
-#line 198 "src/parser/Parser.y"
+#line 202 "src/parser/Parser.y"
                                 {
                                   graph->edges = addEdge((yyvsp[-1].name),(yyvsp[0].name),graph->edges,NULL);
                                   free((yyvsp[0].name));
                                   (yyval.name) = (yyvsp[-1].name);
                                 }
-#line 1344 "src/parser/Parser.c"
+#line 1414 "src/parser/Parser.c"
     break;
 
 
-#line 1348 "src/parser/Parser.c"
+#line 1418 "src/parser/Parser.c"
 
       default: break;
     }
@@ -1537,7 +1607,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 214 "src/parser/Parser.y"
+#line 218 "src/parser/Parser.y"
 
 
 #include <stdio.h>
@@ -20,7 +20,7 @@
 
 int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
     /* Add error handling routine as needed */
-    printf("Erreur: %s\n",msg);
+    fprintf(stderr, "Erreur: %s\n", msg);
     return 0;
 }
  
@@ -83,6 +83,10 @@ int yyerror(GraphList *expression, yyscan_t scanner, const char *msg) {
 %type <parameterInfo> attr_list;
 %type <name> idrhs;
 
+/* Values discarded on a syntax error (the names of the tokens belong to the lexer). */
+%destructor { free($$); } node_id edgerhs idrhs
+%destructor { parameter_list_delete($$.parameters); } attr_assignment a_list attr_list
+
 
 
  
@@ -117,9 +121,9 @@ stmt1 : attr_stmt
     | attr_assignment
     ;
 
-attr_stmt : T_GRAPH attr_list
-    | T_NODE attr_list
-    | T_EDGE attr_list
+attr_stmt : T_GRAPH attr_list                  { parameter_list_delete($2.parameters); }
+    | T_NODE attr_list                          { parameter_list_delete($2.parameters); }
+    | T_EDGE attr_list                          { parameter_list_delete($2.parameters); }
     ;
 
 attr_list : T_LBRACKET a_list T_RBRACKET        { $$ = $2; }
@@ -188,8 +192,8 @@ edge_stmt : node_id edgerhs         { //printf("edge seen: (%s,%s)\n",$1,$2);
                                       graph->edges = addEdge($1,$2,graph->edges,$3.parameters);
                                       free($1); free($2);
                                     }
-    | subgraph edgerhs 
-    | subgraph edgerhs attr_list 
+    | subgraph edgerhs              { free($2); }
+    | subgraph edgerhs attr_list    { free($2); parameter_list_delete($3.parameters); }
     ;
 
 edgerhs : edgeop node_id        { //printf("edge end seen\n");
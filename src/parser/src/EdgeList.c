@@ -10,6 +10,7 @@
  */
 
 #include "EdgeList.h"
+#include "Memory.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,7 +22,7 @@
  */
 static SEdgeList *allocateEdgeList()
 {
-    SEdgeList *b = (SEdgeList *)malloc(sizeof(SEdgeList));
+    SEdgeList *b = (SEdgeList *)memory_malloc(sizeof(SEdgeList), MemoryParser);
 
     if (b == NULL)
         return NULL;
@@ -42,9 +43,9 @@ SEdgeList *addEdge(char *n1, char *n2, SEdgeList *list, parameterList *parameter
     if (b == NULL)
         return NULL;
 
-    b->node1 = (char *)malloc((strlen(n1) + 1) * sizeof(char));
+    b->node1 = (char *)memory_malloc((strlen(n1) + 1) * sizeof(char), MemoryParser);
     strcpy(b->node1, n1);
-    b->node2 = (char *)malloc((strlen(n2) + 1) * sizeof(char));
+    b->node2 = (char *)memory_malloc((strlen(n2) + 1) * sizeof(char), MemoryParser);
     strcpy(b->node2, n2);
 
     b->parameters = parameters;
@@ -72,10 +73,10 @@ void deleteExpression(SEdgeList *b)
 
     deleteExpression(b->next);
 
-    free(b->node1);
-    free(b->node2);
+    memory_free(b->node1);
+    memory_free(b->node2);
 
     parameter_list_delete(b->parameters);
 
-    free(b);
+    memory_free(b);
 }
@@ -1,6 +1,7 @@
 #include "GraphListToGraph.h"
 #include "EdgeList.h"
 #include "NodeList.h"
+#include "Memory.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -40,22 +41,22 @@ Graph createGraph(GraphList source)
 
 	// printf("nodes: %d\n",count);
 
-	res.edges = (bool *)malloc(res.numNodes * res.numNodes * sizeof(bool));
-	res.nodes = (char **)malloc(res.numNodes * sizeof(char *));
+	res.edges = (bool *)memory_malloc(res.numNodes * res.numNodes * sizeof(bool), MemoryGraph);
+	res.nodes = (char **)memory_malloc(res.numNodes * sizeof(char *), MemoryGraph);
 
 	count = 0;
 	explore = source.nodes;
 
 	// Paramètres
 
-	res.parameters = (parameterList **)malloc(res.numNodes * sizeof(parameterList *));
-	res.edge_parameters = (parameterList **)malloc(res.numNodes * res.numNodes * sizeof(parameterList *));
+	res.parameters = (parameterList **)memory_malloc(res.numNodes * sizeof(parameterList *), MemoryGraph);
+	res.edge_parameters = (parameterList **)memory_malloc(res.numNodes * res.numNodes * sizeof(parameterList *), MemoryGraph);
 	for (int i = 0; i < res.numNodes * res.numNodes; i++)
 		res.edge_parameters[i] = NULL;
 
 	while (explore != NULL)
 	{
-		res.nodes[count] = (char *)malloc((strlen(explore->node) + 1) * sizeof(char));
+		res.nodes[count] = (char *)memory_malloc((strlen(explore->node) + 1) * sizeof(char), MemoryGraph);
 		strcpy(res.nodes[count], explore->node);
 
 		// Paramètres
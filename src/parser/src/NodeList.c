@@ -11,6 +11,7 @@
  */
 
 #include "NodeList.h"
+#include "Memory.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,7 +23,7 @@
  */
 static SNodeList *allocateNodeList()
 {
-    SNodeList *b = (SNodeList *)malloc(sizeof(SNodeList));
+    SNodeList *b = (SNodeList *)memory_malloc(sizeof(SNodeList), MemoryParser);
 
     if (b == NULL)
         return NULL;
@@ -43,7 +44,7 @@ SNodeList *addNode(char *n1, SNodeList *list)
     if (b == NULL)
         return NULL;
 
-    b->node = (char *)malloc((strlen(n1) + 1) * sizeof(char));
+    b->node = (char *)memory_malloc((strlen(n1) + 1) * sizeof(char), MemoryParser);
     strcpy(b->node, n1);
 
     b->next = list;
@@ -99,11 +100,11 @@ void deleteNodeList(SNodeList *b)
 
     deleteNodeList(b->next);
 
-    free(b->node);
+    memory_free(b->node);
 
     parameter_list_delete(b->parameters);
 
-    free(b);
+    memory_free(b);
 }
 
 /* Testing main.
@@ -2,99 +2,122 @@
 #include "Parser.h"
 #include "Lexer.h"
 #include "GraphListToGraph.h"
+#include <unistd.h>
 
 int yyparse(GraphList *expression, yyscan_t scanner);
 
 /**
- * @brief Parses a string and return the GraphList described by it.
- * 
- * @param expr A string in graphviz format.
- * @return GraphList The parsed GraphList.
+ * @brief Frees the lists of @p expression, built by a parsing which failed.
+ *
+ * @param expression A partially built GraphList.
  */
-GraphList getGraphList(const char *expr)
+static void deleteGraphList(GraphList *expression)
 {
-    GraphList expression;
-    yyscan_t scanner;
-    YY_BUFFER_STATE state;
-
-    expression.nodes = NULL;
-    expression.edges = NULL;
+    deleteExpression(expression->edges);
+    deleteNodeList(expression->nodes);
+    free(expression->name);
+}
 
-    if (yylex_init(&scanner))
+/**
+ * @brief Parses the input of @p scanner into @p expression. On a syntax error, the diagnostics are written on stderr and the lists built so far are freed.
+ *
+ * @param scanner A scanner, with its input.
+ * @param expression The GraphList to fill.
+ * @return true if the input has been parsed.
+ * @return false otherwise.
+ */
+static bool parseGraphList(yyscan_t scanner, GraphList *expression)
+{
+    expression->name = NULL;
+    expression->nodes = NULL;
+    expression->edges = NULL;
+    if (yyparse(expression, scanner))
     {
-        /* could not initialize */
-        printf("Error initialization\n");
-        return expression;
+        deleteGraphList(expression);
+        return false;
     }
+    return true;
+}
 
-    state = yy_scan_string(expr, scanner);
-
-    if (yyparse(&expression, scanner))
+/**
+ * @brief Parses a string into a GraphList.
+ * 
+ * @param expr A string in graphviz format.
+ * @param expression The parsed GraphList.
+ * @return true if @p expr has been parsed.
+ * @return false otherwise (a message is written on stderr).
+ */
+bool getGraphList(const char *expr, GraphList *expression)
+{
+    yyscan_t scanner;
+    if (lexer_create(&scanner))
     {
-        /* error parsing */
-        printf("Error parsing\n");
-        return expression;
+        fprintf(stderr, "Error initialization\n");
+        return false;
     }
-
+    YY_BUFFER_STATE state = yy_scan_string(expr, scanner);
+    bool parsed = parseGraphList(scanner, expression);
+    if (!parsed)
+        fprintf(stderr, "Error parsing\n");
     yy_delete_buffer(state, scanner);
-
-    yylex_destroy(scanner);
-
-    return expression;
+    lexer_delete(scanner);
+    return parsed;
 }
 
 /**
- * @brief Parses a file and return the GraphList described by it.
+ * @brief Parses a file into a GraphList, and closes it.
  * 
  * @param toRead A file in graphviz format.
- * @return GraphList The parsed GraphList.
+ * @param expression The parsed GraphList.
+ * @return true if @p toRead has been parsed.
+ * @return false otherwise (a message is written on stderr).
  */
-GraphList getGraphListFromFile(FILE *toRead)
+bool getGraphListFromFile(FILE *toRead, GraphList *expression)
 {
-    GraphList expression;
     yyscan_t scanner;
-    YY_BUFFER_STATE state;
-
-    expression.nodes = NULL;
-    expression.edges = NULL;
-
-    if (yylex_init(&scanner))
+    if (lexer_create(&scanner))
     {
-        /* could not initialize */
-        printf("Error initialization\n");
-        return expression;
+        fprintf(stderr, "Error initialization\n");
+        fclose(toRead);
+        return false;
     }
-
-    state = yy_create_buffer(toRead, YY_BUF_SIZE, scanner);
+    YY_BUFFER_STATE state = yy_create_buffer(toRead, YY_BUF_SIZE, scanner);
     yy_switch_to_buffer(state, scanner);
-
-    if (yyparse(&expression, scanner))
-    {
-        /* error parsing */
-        printf("Error parsing\n");
-        return expression;
-    }
-
+    bool parsed = parseGraphList(scanner, expression);
+    if (!parsed)
+        fprintf(stderr, "Error parsing\n");
     yy_delete_buffer(state, scanner);
-
-    yylex_destroy(scanner);
-
+    lexer_delete(scanner);
     fclose(toRead);
-
-    return expression;
+    return parsed;
 }
 
-Graph get_graph_from_file(char *toRead)
+bool try_get_graph_from_file(char *toRead, Graph *graph)
 {
     FILE *file = fopen(toRead, "r");
     if (file == NULL)
+        return false;
+    GraphList e;
+    if (!getGraphListFromFile(file, &e))
+        return false;
+    *graph = createGraph(e);
+    deleteExpression(e.edges);
+    deleteNodeList(e.nodes);
+    return true;
+}
+
+Graph get_graph_from_file(char *toRead)
+{
+    if (access(toRead, R_OK) != 0)
     {
         printf("file %s does not exist. Exiting.\n", toRead);
         exit(-1);
     }
-    GraphList e = getGraphListFromFile(file);
-    Graph graph = createGraph(e);
-    deleteExpression(e.edges);
-    deleteNodeList(e.nodes);
+    Graph graph;
+    if (!try_get_graph_from_file(toRead, &graph))
+    {
+        printf("file %s is not a valid graphviz file. Exiting.\n", toRead);
+        exit(-1);
+    }
     return graph;
 }
@@ -0,0 +1,1005 @@
+/**
+ * @file bench.c
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Benchmark harness: runs every instance of a manifest through every engine of its problem, several times, and reports median and p95
+ *         wall-clock time, peak resident memory, size of the formula (for SAT engines) and whether the engines agree on the answer.
+ *         Results are written as CSV and/or JSON lines, and can be compared against a previous CSV (the baseline) to flag regressions.
+ *
+ *         Each run is done in a forked process, so that its peak memory is measured alone and a crash or a timeout only loses that run.
+ *
+ *         The manifest has one instance per line: "PROBLEM FILE PARAMETER", where PROBLEM is Tunnel or Colouring and PARAMETER is the bound
+ *         on the length of the path or the number of colours. Empty lines and lines starting with # are ignored.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Graph.h"
+#include "Parsing.h"
+#include "Z3Tools.h"
+#include "Metrics.h"
+#include "ColouredGraph.h"
+#include "ColouringResolution.h"
+#include "ColouringReduction.h"
+#include "ColouringCore.h"
+#include "ColouringChromatic.h"
+#include "ColouringTabu.h"
+#include "ColouringDecomposition.h"
+#include "TunnelNetwork.h"
+#include "TunnelBF.h"
+#include "TunnelReduction.h"
+#include "TunnelQuery.h"
+#include "TunnelOptimize.h"
+#include "TunnelUnrolling.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+void usage()
+{
+    printf("Use: bench [options] manifest\n");
+    printf(" Runs every instance of the manifest through every engine of its problem and reports times, memory and formula sizes.\n");
+    printf(" Each line of the manifest is \"PROBLEM FILE PARAMETER\" with PROBLEM being Tunnel or Colouring (# starts a comment).\n");
+    printf("Options: \n");
+    printf(" -h         Displays this help\n");
+    printf(" -n RUNS    Number of runs of each engine on each instance (default 5).\n");
+    printf(" -t SECONDS Time limit of a single run (default 60). A run exceeding it is reported as a timeout.\n");
+    printf("            Runs which time out or crash are counted in the column failed, and left out of the median and p95.\n");
+    printf(" -e ENGINE  Only runs engines named ENGINE (can be repeated). Engines are:");
+    printf(" Tunnel: sat, query, guarded, opt, upto, bmc, bf. Colouring: sat, nosym, prec, order, log, bitvector, core, chromatic, bf, dsatur, components, blocks, tabu, race, clique.\n");
+    printf(" -o FILE    Writes the results in FILE as CSV (one line per instance and engine).\n");
+    printf(" -j FILE    Writes the results in FILE as JSON (one object per line).\n");
+    printf(" -b FILE    Compares the results against FILE, a CSV written by a previous run with -o, and reports regressions.\n");
+    printf(" -r RATIO   Relative tolerance of the comparison (default 0.25): a median time or a peak memory more than RATIO above the baseline is a regression.\n");
+    printf(" The exit status is 1 if a regression or a disagreement between engines is found.\n");
+}
+
+/**
+ * @brief Times below this difference (in seconds) are considered noise and never reported as regressions.
+ *
+ */
+#define NoiseFloor 0.005
+
+/**
+ * @brief Maximal number of engines selected with -e.
+ *
+ */
+#define MaxSelected 32
+
+/**
+ * @brief Answer of a run which exceeded its time limit.
+ *
+ */
+#define AnswerTimeout -2
+
+/**
+ * @brief Answer of a run which could not decide.
+ *
+ */
+#define AnswerUnknown -1
+
+/**
+ * @brief Answer of a run which crashed (or was killed by anything but its time limit).
+ *
+ */
+#define AnswerCrash -3
+
+/**
+ * @brief What a single run reports to the harness.
+ *
+ */
+typedef struct
+{
+    int answer;       ///< 1 if SAT (a path or a colouring exists), 0 if UNSAT, AnswerUnknown, AnswerTimeout or AnswerCrash otherwise.
+    int value;        ///< Length of the path found (Tunnel), 0 otherwise.
+    double wall;      ///< Wall-clock time of the engine (parsing and the measure of the formula excluded).
+    double uncounted; ///< Time spent by the engine measuring its formula, removed from wall.
+    int variables; ///< Number of variables of the last formula solved (SAT engines only).
+    int clauses;   ///< Number of clauses of the last formula solved (SAT engines only).
+    long max_rss;  ///< Peak resident memory of the run, in KiB (parsing included).
+} bench_outcome;
+
+/**
+ * @brief An engine: a way to solve a problem, given the graph and the parameter of the instance.
+ *
+ */
+typedef struct
+{
+    char *problem;                                                 ///< The problem solved (as in the manifest).
+    char *name;                                                    ///< The name of the engine.
+    void (*run)(Graph graph, int parameter, bench_outcome *outcome); ///< Solves the instance and fills answer, value, variables and clauses.
+} bench_engine;
+
+/**
+ * @brief The results of an engine on an instance.
+ *
+ */
+typedef struct
+{
+    char problem[32];   ///< The problem.
+    char file[512];     ///< The file of the instance.
+    int parameter;      ///< The parameter of the instance.
+    char engine[32];    ///< The engine.
+    int runs;           ///< Number of runs which completed (the times are theirs).
+    int failed;         ///< Number of runs which timed out or crashed.
+    int answer;         ///< Answer (of the first completed run, all runs are deterministic), AnswerTimeout or AnswerCrash if none completed.
+    int value;          ///< Value (of the first completed run).
+    double median;      ///< Median wall-clock time of the completed runs (0 if none).
+    double p95;         ///< 95th percentile of the wall-clock time of the completed runs (0 if none).
+    long max_rss;       ///< Largest peak resident memory among the runs.
+    int variables;      ///< Size of the formula (variables).
+    int clauses;        ///< Size of the formula (clauses).
+    char agreement[16]; ///< "yes" if all engines agree on the instance, "NO" if not, "-" if less than two engines answered.
+} bench_result;
+
+/**
+ * @brief Measures the size of @p formula into @p outcome. The time it takes is not counted in the time of the engine.
+ *
+ */
+void bench_formula_size(Z3_context ctx, Z3_ast formula, bench_outcome *outcome)
+{
+    time_point start = time_now();
+    formula_size(ctx, formula, &outcome->variables, &outcome->clauses);
+    outcome->uncounted += time_elapsed(start);
+}
+
+/**
+ * @brief Engine "sat" for Tunnel: solves the reduction for each length from 1 to @p bound in one session, as graphProblemSolver does.
+ *
+ */
+void run_tunnel_sat(Graph graph, int bound, bench_outcome *outcome)
+{
+    TunnelNetwork network = tn_initialize(graph);
+    Z3_context ctx = make_context();
+    Z3Session session = session_create(ctx);
+    outcome->answer = 0;
+    Z3_ast formula = NULL;
+    for (int l = 1; l <= bound; l++)
+    {
+        formula = tn_reduction(ctx, network, l);
+        session_push(session);
+        session_assert(session, formula);
+        Z3_lbool result = session_check(session);
+        session_pop(session, 1);
+        if (result == Z3_L_UNDEF)
+        {
+            outcome->answer = AnswerUnknown;
+            break;
+        }
+        if (result == Z3_L_TRUE)
+        {
+            outcome->answer = 1;
+            outcome->value = l;
+            break;
+        }
+    }
+    if (formula != NULL)
+        bench_formula_size(ctx, formula, outcome);
+    session_delete(session);
+    Z3_del_context(ctx);
+    tn_delete(network);
+}
+
+/**
+ * @brief Solves the instance with a TunnelQuery made by @p create.
+ *
+ */
+void run_tunnel_query_with(Graph graph, int bound, bench_outcome *outcome, TunnelQuery (*create)(Z3_context, TunnelNetwork))
+{
+    TunnelNetwork network = tn_initialize(graph);
+    Z3_context ctx = make_context();
+    TunnelQuery query = create(ctx, network);
+    tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+    outcome->value = tn_query_solve(query, tn_get_initial(network), tn_get_final(network), bound, path);
+    outcome->answer = outcome->value < 0 ? AnswerUnknown : outcome->value > 0;
+    if (outcome->value < 0)
+        outcome->value = 0;
+    free(path);
+    tn_query_delete(query);
+    Z3_del_context(ctx);
+    tn_delete(network);
+}
+
+/**
+ * @brief Engine "query" for Tunnel: TunnelQuery, the endpoints being passed as assumptions (as with option -q of graphProblemSolver).
+ *
+ */
+void run_tunnel_query(Graph graph, int bound, bench_outcome *outcome)
+{
+    run_tunnel_query_with(graph, bound, outcome, tn_query_create);
+}
+
+/**
+ * @brief Engine "guarded" for Tunnel: TunnelQuery in mutable mode, the edges and actions being passed as assumptions too (as in tn_daemon).
+ *
+ */
+void run_tunnel_guarded(Graph graph, int bound, bench_outcome *outcome)
+{
+    run_tunnel_query_with(graph, bound, outcome, tn_query_create_mutable);
+}
+
+/**
+ * @brief Engine "opt" for Tunnel: tn_optimize minimising the number of steps, over all the sizes up to the bound at once (as with option -O hops of graphProblemSolver).
+ *
+ */
+void run_tunnel_opt(Graph graph, int bound, bench_outcome *outcome)
+{
+    TunnelNetwork network = tn_initialize(graph);
+    Z3_context ctx = make_context();
+    tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+    tn_objective objective = {1, 0, 0};
+    int length = 0;
+    Z3_lbool result = tn_optimize(ctx, network, tn_get_initial(network), tn_get_final(network), bound, objective, path, &length);
+    outcome->answer = result == Z3_L_TRUE ? 1 : (result == Z3_L_FALSE ? 0 : AnswerUnknown);
+    outcome->value = result == Z3_L_TRUE ? length : 0;
+    free(path);
+    Z3_del_context(ctx);
+    tn_delete(network);
+}
+
+/**
+ * @brief Engine "upto" for Tunnel: tn_shortest_up_to, one formula for all the sizes up to the bound (as with option -S of graphProblemSolver).
+ *
+ */
+void run_tunnel_up_to(Graph graph, int bound, bench_outcome *outcome)
+{
+    TunnelNetwork network = tn_initialize(graph);
+    Z3_context ctx = make_context();
+    tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+    outcome->value = tn_shortest_up_to(ctx, network, tn_get_initial(network), tn_get_final(network), bound, path);
+    outcome->answer = outcome->value < 0 ? AnswerUnknown : outcome->value > 0;
+    if (outcome->value < 0)
+        outcome->value = 0;
+    free(path);
+    Z3_del_context(ctx);
+    tn_delete(network);
+}
+
+/**
+ * @brief Engine "bmc" for Tunnel: TunnelUnrolling, one session unrolled frame by frame (as with option -I of graphProblemSolver).
+ *
+ */
+void run_tunnel_bmc(Graph graph, int bound, bench_outcome *outcome)
+{
+    TunnelNetwork network = tn_initialize(graph);
+    Z3_context ctx = make_context();
+    TunnelUnrolling unrolling = tn_unrolling_create(ctx, network, bound);
+    tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+    outcome->value = tn_unrolling_solve(unrolling, tn_get_initial(network), tn_get_final(network), bound, path);
+    outcome->answer = outcome->value < 0 ? AnswerUnknown : outcome->value > 0;
+    if (outcome->value < 0)
+        outcome->value = 0;
+    free(path);
+    tn_unrolling_delete(unrolling);
+    Z3_del_context(ctx);
+    tn_delete(network);
+}
+
+/**
+ * @brief Engine "bf" for Tunnel: tn_brute_force.
+ *
+ */
+void run_tunnel_bf(Graph graph, int bound, bench_outcome *outcome)
+{
+    TunnelNetwork network = tn_initialize(graph);
+    tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+    outcome->value = tn_brute_force(network, bound, path);
+    outcome->answer = outcome->value > 0;
+    free(path);
+    tn_delete(network);
+}
+
+/**
+ * @brief Runs the colouring reduction with symmetry breaking @p symmetry and the colours written in the encoding @p encoding.
+ *
+ */
+void run_colouring_encoded(Graph graph, int num_colours, colouring_symmetry symmetry, colouring_encoding encoding, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    Z3_context ctx = make_context();
+    Z3_ast formula = colouring_reduction_encoded(ctx, coloured, num_colours, symmetry, encoding);
+    Z3Session session = session_create(ctx);
+    session_assert(session, formula);
+    Z3_lbool result = session_check(session);
+    outcome->answer = result == Z3_L_TRUE ? 1 : (result == Z3_L_FALSE ? 0 : AnswerUnknown);
+    bench_formula_size(ctx, formula, outcome);
+    session_delete(session);
+    Z3_del_context(ctx);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Runs the colouring reduction with symmetry breaking @p symmetry (direct encoding).
+ *
+ */
+void run_colouring_reduction(Graph graph, int num_colours, colouring_symmetry symmetry, bench_outcome *outcome)
+{
+    run_colouring_encoded(graph, num_colours, symmetry, colouring_encoding_direct, outcome);
+}
+
+/**
+ * @brief Engine "sat" for Colouring: colouring_reduction (the nodes of a clique get fixed colours).
+ *
+ */
+void run_colouring_sat(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    run_colouring_reduction(graph, num_colours, colouring_symmetry_clique, outcome);
+}
+
+/**
+ * @brief Engine "nosym" for Colouring: colouring_reduction without symmetry breaking.
+ *
+ */
+void run_colouring_no_symmetry(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    run_colouring_reduction(graph, num_colours, colouring_symmetry_none, outcome);
+}
+
+/**
+ * @brief Engine "prec" for Colouring: colouring_reduction with the clique and the precedence of the colours.
+ *
+ */
+void run_colouring_precedence(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    run_colouring_reduction(graph, num_colours, colouring_symmetry_precedence, outcome);
+}
+
+/**
+ * @brief Engine "order" for Colouring: colouring_reduction (with the clique) in the order encoding.
+ *
+ */
+void run_colouring_order(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    run_colouring_encoded(graph, num_colours, colouring_symmetry_clique, colouring_encoding_order, outcome);
+}
+
+/**
+ * @brief Engine "log" for Colouring: colouring_reduction (with the clique) in the log encoding.
+ *
+ */
+void run_colouring_log(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    run_colouring_encoded(graph, num_colours, colouring_symmetry_clique, colouring_encoding_log, outcome);
+}
+
+/**
+ * @brief Engine "bitvector" for Colouring: colouring_reduction (with the clique) in the bit-vector encoding.
+ *
+ */
+void run_colouring_bitvector(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    run_colouring_encoded(graph, num_colours, colouring_symmetry_clique, colouring_encoding_bitvector, outcome);
+}
+
+/**
+ * @brief Engine "core" for Colouring: colouring_reduction (with the clique) on the k-core of the graph only.
+ *
+ */
+void run_colouring_core(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    ColouringCore core = colouring_core_create(coloured, num_colours);
+    run_colouring_reduction(cg_get_graph(colouring_core_get_graph(core)), num_colours, colouring_symmetry_clique, outcome);
+    colouring_core_delete(core);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Engine "chromatic" for Colouring: colouring_chromatic_number (walking k down), the answer being whether it is at most the number of colours.
+ *
+ */
+void run_colouring_chromatic(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    Z3_context ctx = make_context();
+    int chromatic = colouring_chromatic_number(ctx, coloured, colouring_symmetry_clique, colouring_encoding_direct, false, NULL);
+    outcome->answer = chromatic < 0 ? AnswerUnknown : chromatic <= num_colours;
+    Z3_del_context(ctx);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Engine "bf" for Colouring: colouring_brute_force.
+ *
+ */
+void run_colouring_bf(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    outcome->answer = colouring_brute_force(coloured, num_colours);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Engine "dsatur" for Colouring: colouring_dsatur, on as many threads as processors.
+ *
+ */
+void run_colouring_dsatur(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    outcome->answer = colouring_dsatur(coloured, num_colours, 0);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief colouring_engine of the engines "components" and "blocks": a sequential DSATUR.
+ *
+ */
+int bench_engine_dsatur(ColouredGraph graph, int num_colours, void *data)
+{
+    return colouring_dsatur(graph, num_colours, 1) ? 1 : 0;
+}
+
+/**
+ * @brief Engine "components" for Colouring: colouring_by_components, a sequential DSATUR on each connected component, as many at once as processors.
+ *
+ */
+void run_colouring_components(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    outcome->answer = colouring_by_components(coloured, num_colours, bench_engine_dsatur, NULL, 0, NULL);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Engine "blocks" for Colouring: colouring_by_blocks, a sequential DSATUR on each biconnected block, as many at once as processors.
+ *
+ */
+void run_colouring_blocks(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    outcome->answer = colouring_by_blocks(coloured, num_colours, bench_engine_dsatur, NULL, 0, NULL);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Time budget of TabuCol in the engines "tabu" and "race", and of the search of a clique in "clique" (the run is killed by its timeout anyway).
+ *
+ */
+#define BenchTabuSeconds 3600.0
+
+/**
+ * @brief Engine "tabu" for Colouring: colouring_tabu (seed 1), which answers only when it finds a colouring.
+ *
+ */
+void run_colouring_tabu(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    outcome->answer = colouring_tabu(coloured, num_colours, BenchTabuSeconds, 1) ? 1 : AnswerUnknown;
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Engine "race" for Colouring: colouring_race, TabuCol against a sequential DSATUR.
+ *
+ */
+void run_colouring_race(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    outcome->answer = colouring_race(coloured, num_colours, 1, BenchTabuSeconds, 1, NULL);
+    cg_delete(coloured);
+}
+
+/**
+ * @brief Engine "clique" for Colouring: colouring_max_clique, which answers only when it finds a clique of more than the number of colours.
+ *
+ */
+void run_colouring_clique(Graph graph, int num_colours, bench_outcome *outcome)
+{
+    ColouredGraph coloured = cg_initialize(graph);
+    int clique[graph_num_nodes(graph) + 1];
+    outcome->answer = colouring_max_clique(coloured, clique, num_colours + 1, BenchTabuSeconds, NULL) > num_colours ? 0 : AnswerUnknown;
+    cg_delete(coloured);
+}
+
+/**
+ * @brief All the engines known to the harness. New engines only need to be added here.
+ *
+ */
+bench_engine engines[] = {
+    {"Tunnel", "sat", run_tunnel_sat},
+    {"Tunnel", "query", run_tunnel_query},
+    {"Tunnel", "guarded", run_tunnel_guarded},
+    {"Tunnel", "opt", run_tunnel_opt},
+    {"Tunnel", "upto", run_tunnel_up_to},
+    {"Tunnel", "bmc", run_tunnel_bmc},
+    {"Tunnel", "bf", run_tunnel_bf},
+    {"Colouring", "sat", run_colouring_sat},
+    {"Colouring", "nosym", run_colouring_no_symmetry},
+    {"Colouring", "prec", run_colouring_precedence},
+    {"Colouring", "order", run_colouring_order},
+    {"Colouring", "log", run_colouring_log},
+    {"Colouring", "bitvector", run_colouring_bitvector},
+    {"Colouring", "core", run_colouring_core},
+    {"Colouring", "chromatic", run_colouring_chromatic},
+    {"Colouring", "bf", run_colouring_bf},
+    {"Colouring", "dsatur", run_colouring_dsatur},
+    {"Colouring", "components", run_colouring_components},
+    {"Colouring", "blocks", run_colouring_blocks},
+    {"Colouring", "tabu", run_colouring_tabu},
+    {"Colouring", "race", run_colouring_race},
+    {"Colouring", "clique", run_colouring_clique},
+};
+
+#define NumEngines ((int)(sizeof(engines) / sizeof(engines[0])))
+
+/**
+ * @brief Runs @p engine once on the instance in a child process, killed after @p time_limit seconds.
+ *
+ * @param engine The engine.
+ * @param file The file of the instance.
+ * @param parameter The parameter of the instance.
+ * @param time_limit The time limit, in seconds.
+ * @return bench_outcome What the run reported.
+ */
+bench_outcome run_once(bench_engine *engine, char *file, int parameter, int time_limit)
+{
+    bench_outcome outcome = {AnswerUnknown, 0, 0, 0, 0, 0, 0};
+    int channel[2];
+    if (pipe(channel) != 0)
+    {
+        perror("pipe");
+        exit(EXIT_FAILURE);
+    }
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0)
+    {
+        perror("fork");
+        exit(EXIT_FAILURE);
+    }
+    if (child == 0)
+    {
+        close(channel[0]);
+        alarm(time_limit);
+        Graph graph = get_graph_from_file(file);
+        time_point start = time_now();
+        engine->run(graph, parameter, &outcome);
+        outcome.wall = time_elapsed(start) - outcome.uncounted;
+        graph_delete(graph);
+        if (write(channel[1], &outcome, sizeof(outcome)) != sizeof(outcome))
+            _exit(EXIT_FAILURE);
+        close(channel[1]);
+        _exit(EXIT_SUCCESS);
+    }
+    close(channel[1]);
+    bench_outcome received;
+    bool complete = read(channel[0], &received, sizeof(received)) == sizeof(received);
+    close(channel[0]);
+    int status;
+    struct rusage usage;
+    wait4(child, &status, 0, &usage);
+    if (complete)
+        outcome = received;
+    else if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+        outcome.answer = AnswerTimeout;
+    else
+        outcome.answer = AnswerCrash;
+    outcome.max_rss = usage.ru_maxrss;
+    return outcome;
+}
+
+int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Runs @p engine @p runs times on the instance and summarises the runs. The times are those of the runs which completed: a run which
+ *        timed out or crashed is only counted as failed.
+ *
+ * @param engine The engine.
+ * @param file The file of the instance.
+ * @param parameter The parameter of the instance.
+ * @param runs The number of runs.
+ * @param time_limit The time limit of a run.
+ * @return bench_result The summary.
+ */
+bench_result run_engine(bench_engine *engine, char *file, int parameter, int runs, int time_limit)
+{
+    bench_result result;
+    memset(&result, 0, sizeof(result));
+    snprintf(result.problem, sizeof(result.problem), "%s", engine->problem);
+    snprintf(result.file, sizeof(result.file), "%s", file);
+    snprintf(result.engine, sizeof(result.engine), "%s", engine->name);
+    result.parameter = parameter;
+    strcpy(result.agreement, "-");
+    double walls[runs];
+    for (int i = 0; i < runs; i++)
+    {
+        bench_outcome outcome = run_once(engine, file, parameter, time_limit);
+        if (outcome.max_rss > result.max_rss)
+            result.max_rss = outcome.max_rss;
+        if (outcome.answer == AnswerTimeout || outcome.answer == AnswerCrash)
+        {
+            result.failed++;
+            if (result.runs == 0)
+                result.answer = outcome.answer;
+            // Runs are deterministic: a timeout makes the next ones useless.
+            if (outcome.answer == AnswerTimeout)
+                break;
+            continue;
+        }
+        if (result.runs == 0)
+        {
+            result.answer = outcome.answer;
+            result.value = outcome.value;
+            result.variables = outcome.variables;
+            result.clauses = outcome.clauses;
+        }
+        walls[result.runs++] = outcome.wall;
+    }
+    if (result.runs == 0)
+        return result;
+    qsort(walls, result.runs, sizeof(double), compare_doubles);
+    result.median = result.runs % 2 == 1 ? walls[result.runs / 2] : (walls[result.runs / 2 - 1] + walls[result.runs / 2]) / 2;
+    int rank = (95 * result.runs + 99) / 100;
+    result.p95 = walls[rank - 1];
+    return result;
+}
+
+/**
+ * @brief Fills the agreement field of the @p num_results results of a same instance.
+ *
+ * @param results The results of the engines on the instance.
+ * @param num_results Their number.
+ * @return true if the engines agree (or less than two answered).
+ * @return false otherwise.
+ */
+bool set_agreement(bench_result *results, int num_results)
+{
+    int reference = -1, num_answers = 0;
+    bool agree = true;
+    for (int i = 0; i < num_results; i++)
+    {
+        if (results[i].answer < 0)
+            continue;
+        num_answers++;
+        if (reference < 0)
+            reference = i;
+        else if (results[i].answer != results[reference].answer || results[i].value != results[reference].value)
+            agree = false;
+    }
+    for (int i = 0; i < num_results; i++)
+        strcpy(results[i].agreement, num_answers < 2 ? "-" : (agree ? "yes" : "NO"));
+    return agree;
+}
+
+/**
+ * @brief Returns the textual form of an answer.
+ *
+ * @param answer An answer.
+ * @return char* Its name.
+ */
+char *answer_name(int answer)
+{
+    switch (answer)
+    {
+    case 1:
+        return "sat";
+    case 0:
+        return "unsat";
+    case AnswerTimeout:
+        return "timeout";
+    case AnswerCrash:
+        return "crash";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * @brief Reads the textual form of an answer.
+ *
+ * @param name The name of an answer.
+ * @return int The answer.
+ */
+int answer_of_name(const char *name)
+{
+    if (strcmp(name, "sat") == 0)
+        return 1;
+    if (strcmp(name, "unsat") == 0)
+        return 0;
+    if (strcmp(name, "timeout") == 0)
+        return AnswerTimeout;
+    if (strcmp(name, "crash") == 0)
+        return AnswerCrash;
+    return AnswerUnknown;
+}
+
+#define CsvHeader "problem,file,parameter,engine,runs,answer,value,median,p95,max_rss_kb,variables,clauses,agreement,failed"
+
+/**
+ * @brief Writes @p result as a line of CSV (columns of CsvHeader).
+ *
+ */
+void print_csv(FILE *file, bench_result *result)
+{
+    fprintf(file, "%s,%s,%d,%s,%d,%s,%d,%.6f,%.6f,%ld,%d,%d,%s,%d\n", result->problem, result->file, result->parameter, result->engine, result->runs,
+            answer_name(result->answer), result->value, result->median, result->p95, result->max_rss, result->variables, result->clauses, result->agreement,
+            result->failed);
+}
+
+/**
+ * @brief Writes @p result as a JSON object on one line. The times of a row whose runs all failed are null.
+ *
+ */
+void print_json(FILE *file, bench_result *result)
+{
+    fprintf(file, "{\"problem\":");
+    print_json_string(file, result->problem);
+    fprintf(file, ",\"file\":");
+    print_json_string(file, result->file);
+    fprintf(file, ",\"parameter\":%d,\"engine\":", result->parameter);
+    print_json_string(file, result->engine);
+    fprintf(file, ",\"runs\":%d,\"failed\":%d,\"answer\":\"%s\",\"value\":%d", result->runs, result->failed, answer_name(result->answer), result->value);
+    if (result->runs > 0)
+        fprintf(file, ",\"median\":%.6f,\"p95\":%.6f", result->median, result->p95);
+    else
+        fprintf(file, ",\"median\":null,\"p95\":null");
+    fprintf(file, ",\"max_rss_kb\":%ld,\"variables\":%d,\"clauses\":%d,\"agreement\":\"%s\"}\n", result->max_rss, result->variables, result->clauses,
+            result->agreement);
+}
+
+/**
+ * @brief Reads a CSV written by print_csv.
+ *
+ * @param name The name of the file.
+ * @param num_results Will contain the number of results read.
+ * @return bench_result* The results (to be freed).
+ */
+bench_result *read_baseline(char *name, int *num_results)
+{
+    FILE *file = fopen(name, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Could not open baseline %s.\n", name);
+        exit(EXIT_FAILURE);
+    }
+    int capacity = 64;
+    bench_result *results = (bench_result *)malloc(capacity * sizeof(bench_result));
+    *num_results = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (strncmp(line, "problem,", 8) == 0)
+            continue;
+        bench_result result;
+        char answer[16];
+        result.failed = 0;
+        // Baselines written before the column failed have only 13 columns.
+        if (sscanf(line, "%31[^,],%511[^,],%d,%31[^,],%d,%15[^,],%d,%lf,%lf,%ld,%d,%d,%15[^,\n],%d", result.problem, result.file, &result.parameter,
+                   result.engine, &result.runs, answer, &result.value, &result.median, &result.p95, &result.max_rss, &result.variables,
+                   &result.clauses, result.agreement, &result.failed) < 13)
+            continue;
+        result.answer = answer_of_name(answer);
+        if (*num_results == capacity)
+        {
+            capacity *= 2;
+            results = (bench_result *)realloc(results, capacity * sizeof(bench_result));
+        }
+        results[(*num_results)++] = result;
+    }
+    fclose(file);
+    return results;
+}
+
+/**
+ * @brief Compares @p result to the matching entry of the baseline (same file, parameter and engine), and reports on stderr what got worse.
+ *
+ * @param result A result.
+ * @param baseline The baseline.
+ * @param num_baseline The size of the baseline.
+ * @param tolerance The relative tolerance.
+ * @return int The number of regressions found.
+ */
+int compare_to_baseline(bench_result *result, bench_result *baseline, int num_baseline, double tolerance)
+{
+    for (int i = 0; i < num_baseline; i++)
+    {
+        bench_result *base = &baseline[i];
+        if (strcmp(base->file, result->file) != 0 || strcmp(base->engine, result->engine) != 0 || strcmp(base->problem, result->problem) != 0 ||
+            base->parameter != result->parameter)
+            continue;
+        int regressions = 0;
+        if (base->answer >= 0 && (result->answer != base->answer || result->value != base->value))
+        {
+            fprintf(stderr, "REGRESSION %s %s %d %s: answer %s(%d), baseline %s(%d)\n", result->problem, result->file, result->parameter, result->engine,
+                    answer_name(result->answer), result->value, answer_name(base->answer), base->value);
+            regressions++;
+        }
+        // Rows without a completed run have no time to compare (a failure is reported as a change of answer).
+        if (result->runs > 0 && base->runs > 0 && result->median > base->median * (1 + tolerance) && result->median - base->median > NoiseFloor)
+        {
+            fprintf(stderr, "REGRESSION %s %s %d %s: median %.6fs, baseline %.6fs (+%.0f%%)\n", result->problem, result->file, result->parameter,
+                    result->engine, result->median, base->median, 100 * (result->median / base->median - 1));
+            regressions++;
+        }
+        if (result->max_rss > base->max_rss * (1 + tolerance))
+        {
+            fprintf(stderr, "REGRESSION %s %s %d %s: peak memory %ldKiB, baseline %ldKiB\n", result->problem, result->file, result->parameter,
+                    result->engine, result->max_rss, base->max_rss);
+            regressions++;
+        }
+        return regressions;
+    }
+    return 0;
+}
+
+/**
+ * @brief Tells if @p engine has been selected by the options.
+ *
+ * @param engine An engine.
+ * @param selected The names given with -e.
+ * @param num_selected Their number (0 selects every engine).
+ * @return true if @p engine must be run.
+ * @return false otherwise.
+ */
+bool is_selected(bench_engine *engine, char **selected, int num_selected)
+{
+    if (num_selected == 0)
+        return true;
+    for (int i = 0; i < num_selected; i++)
+        if (strcmp(engine->name, selected[i]) == 0)
+            return true;
+    return false;
+}
+
+int main(int argc, char *argv[])
+{
+    int runs = 5;
+    int time_limit = 60;
+    char *selected[MaxSelected];
+    int num_selected = 0;
+    char *csvName = NULL;
+    char *jsonName = NULL;
+    char *baselineName = NULL;
+    double tolerance = 0.25;
+
+    int option;
+    while ((option = getopt(argc, argv, ":hn:t:e:o:j:b:r:")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 'n':
+            runs = atoi(optarg);
+            break;
+        case 't':
+            time_limit = atoi(optarg);
+            break;
+        case 'e':
+            if (num_selected == MaxSelected)
+            {
+                fprintf(stderr, "Too many engines selected with -e (at most %d).\n", MaxSelected);
+                return EXIT_FAILURE;
+            }
+            selected[num_selected++] = optarg;
+            break;
+        case 'o':
+            csvName = optarg;
+            break;
+        case 'j':
+            jsonName = optarg;
+            break;
+        case 'b':
+            baselineName = optarg;
+            break;
+        case 'r':
+            tolerance = atof(optarg);
+            break;
+        case '?':
+            fprintf(stderr, "Unknown option: -%c\n", optopt);
+            usage();
+            return EXIT_FAILURE;
+        case ':':
+            fprintf(stderr, "Option -%c requires an argument\n", optopt);
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || runs < 1 || time_limit < 1)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    FILE *manifest = fopen(argv[optind], "r");
+    if (manifest == NULL)
+    {
+        fprintf(stderr, "Could not open manifest %s.\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    FILE *csv = NULL, *json = NULL;
+    if (csvName != NULL)
+    {
+        csv = fopen(csvName, "w");
+        if (csv == NULL)
+        {
+            fprintf(stderr, "Could not open %s.\n", csvName);
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, CsvHeader "\n");
+    }
+    if (jsonName != NULL && (json = fopen(jsonName, "w")) == NULL)
+    {
+        fprintf(stderr, "Could not open %s.\n", jsonName);
+        return EXIT_FAILURE;
+    }
+    int num_baseline = 0;
+    bench_result *baseline = NULL;
+    if (baselineName != NULL)
+        baseline = read_baseline(baselineName, &num_baseline);
+
+    printf("%-10s %-45s %5s %-6s %-8s %6s %10s %10s %10s %9s %-5s %s\n", "problem", "file", "param", "engine", "answer", "value", "median(s)", "p95(s)",
+           "rss(KiB)", "clauses", "agree", "failed");
+    int regressions = 0, disagreements = 0;
+    char line[1024];
+    int line_number = 0;
+    while (fgets(line, sizeof(line), manifest) != NULL)
+    {
+        line_number++;
+        char problem[32], file[512];
+        int parameter;
+        char *start = line + strspn(line, " \t");
+        if (*start == '#' || *start == '\n' || *start == '\0')
+            continue;
+        if (sscanf(start, "%31s %511s %d", problem, file, &parameter) != 3)
+        {
+            fprintf(stderr, "%s:%d: expected \"PROBLEM FILE PARAMETER\", line ignored.\n", argv[optind], line_number);
+            continue;
+        }
+        if (access(file, R_OK) != 0)
+        {
+            fprintf(stderr, "%s:%d: cannot read %s, instance skipped.\n", argv[optind], line_number, file);
+            continue;
+        }
+        bench_result results[NumEngines];
+        int num_results = 0;
+        for (int e = 0; e < NumEngines; e++)
+            if (strcmp(engines[e].problem, problem) == 0 && is_selected(&engines[e], selected, num_selected))
+                results[num_results++] = run_engine(&engines[e], file, parameter, runs, time_limit);
+        if (num_results == 0)
+        {
+            fprintf(stderr, "%s:%d: no engine for problem %s.\n", argv[optind], line_number, problem);
+            continue;
+        }
+        if (!set_agreement(results, num_results))
+        {
+            fprintf(stderr, "DISAGREEMENT %s %s %d: engines do not give the same answer.\n", problem, file, parameter);
+            disagreements++;
+        }
+        for (int i = 0; i < num_results; i++)
+        {
+            bench_result *result = &results[i];
+            printf("%-10s %-45s %5d %-6s %-8s %6d %10.4f %10.4f %10ld %9d %-5s %d\n", result->problem, result->file, result->parameter, result->engine,
+                   answer_name(result->answer), result->value, result->median, result->p95, result->max_rss, result->clauses, result->agreement,
+                   result->failed);
+            if (csv != NULL)
+                print_csv(csv, result);
+            if (json != NULL)
+                print_json(json, result);
+            if (baseline != NULL)
+                regressions += compare_to_baseline(result, baseline, num_baseline, tolerance);
+        }
+    }
+    fclose(manifest);
+    if (csv != NULL)
+        fclose(csv);
+    if (json != NULL)
+        fclose(json);
+    if (baseline != NULL)
+        printf("%d regression(s) against %s.\n", regressions, baselineName);
+    free(baseline);
+    if (disagreements > 0)
+        printf("%d instance(s) where engines disagree.\n", disagreements);
+    return regressions > 0 || disagreements > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,398 @@
+/**
+ * @file col_generator.c
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Generator of colouring instances, to measure how the engines scale. Writes an undirected graph in dot format readable by get_graph_from_file.
+ *         Four families are available: random graphs G(n,p), random geometric graphs (points in the unit square, joined when they are close), planted
+ *         k-colourable graphs (nodes split into k classes, edges only between classes), whose hardness is controlled by their average degree and peaks
+ *         near the colourability threshold (about 4.69 for 3 colours), and Mycielski graphs (triangle-free, of chromatic number k, so cliques give no
+ *         useful bound).
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Graph.h"
+#include "Parsing.h"
+#include "Random.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+void usage()
+{
+    printf("Use: col_generator [options]\n");
+    printf(" Writes a random colouring instance (an undirected graph) in dot format.\n");
+    printf("Options: \n");
+    printf(" -h         Displays this help\n");
+    printf(" -t FAMILY  Family of the graph: \"gnp\" (each edge with probability P, default), \"geometric\" (random points of the unit square joined when closer than R),");
+    printf(" \"planted\" (nodes split into K balanced classes, each edge between two classes with the same probability, so that there is a K-colouring) or");
+    printf(" \"mycielski\" (the Mycielski graph of chromatic number K, triangle-free).\n");
+    printf(" -n NODES   Number of nodes (default 50). Ignored by mycielski, which has 3*2^(K-2)-1 nodes.\n");
+    printf(" -p P       Probability of each edge of gnp and planted (default 0.1).\n");
+    printf(" -r R       Radius of geometric (default 0.2).\n");
+    printf(" -d DEGREE  Average degree of gnp, geometric and planted, instead of -p or -r. Planted graphs are hardest near the colourability threshold (about 4.69 for K = 3).\n");
+    printf(" -k K       Number of classes of planted, chromatic number of mycielski (default 3).\n");
+    printf(" -s SEED    Seed of the generator (default 0). The same options and seed always produce the same graph.\n");
+    printf(" -N NAME    Name of the graph in the dot file (default \"Generated\").\n");
+    printf(" -o FILE    Writes the graph in FILE instead of the standard output.\n");
+    printf(" -m FILE    Appends the line \"Colouring FILE COLOURS\" of the instance to the manifest FILE of bench (needs -o).\n");
+    printf(" -c COLOURS Number of colours of the manifest line (default K for planted, K-1 for mycielski, which makes it unsatisfiable, 3 otherwise).\n");
+    printf(" -C         Checks the written file: parses it back and verifies that get_graph_from_file finds the same nodes and edges (only for files, not too big).\n");
+}
+
+/**
+ * @brief The families of graphs.
+ *
+ */
+typedef enum
+{
+    family_gnp,       ///< Random graph G(n,p).
+    family_geometric, ///< Random geometric graph.
+    family_planted,   ///< Planted k-colourable graph.
+    family_mycielski  ///< Mycielski graph.
+} graph_family;
+
+/**
+ * @brief The parameters of the generation.
+ *
+ */
+typedef struct
+{
+    graph_family family; ///< The family.
+    int num_nodes;       ///< Number of nodes.
+    double probability;  ///< Probability of an edge (gnp, planted).
+    double radius;       ///< Radius (geometric).
+    double degree;       ///< Average degree, replacing probability and radius if positive.
+    int num_colours;     ///< Number of classes (planted), chromatic number (mycielski).
+    char *name;          ///< Name of the graph.
+} generator_parameters;
+
+/**
+ * @brief The generated graph, as a list of edges.
+ *
+ */
+typedef struct
+{
+    int num_nodes; ///< Number of nodes.
+    int num_edges; ///< Number of edges.
+    int capacity;  ///< Allocated number of edges.
+    int *ends;     ///< The ends of edge e are ends[2 * e] and ends[2 * e + 1].
+} generated_graph;
+
+/**
+ * @brief Adds the edge {@p node1,@p node2} to @p graph (the families never produce the same edge twice).
+ *
+ * @param graph A generated graph.
+ * @param node1 A node.
+ * @param node2 Another node.
+ */
+void add_edge(generated_graph *graph, int node1, int node2)
+{
+    if (graph->num_edges == graph->capacity)
+    {
+        graph->capacity = graph->capacity == 0 ? 64 : 2 * graph->capacity;
+        graph->ends = (int *)realloc(graph->ends, 2 * graph->capacity * sizeof(int));
+    }
+    graph->ends[2 * graph->num_edges] = node1;
+    graph->ends[2 * graph->num_edges + 1] = node2;
+    graph->num_edges++;
+}
+
+/**
+ * @brief Generates G(n,p): each pair of nodes is an edge with probability p, or average degree / (n - 1).
+ *
+ * @param parameters The parameters of the generation.
+ * @param generator A random generator.
+ * @param graph The graph to fill.
+ */
+void generate_gnp(generator_parameters *parameters, random_generator *generator, generated_graph *graph)
+{
+    int n = parameters->num_nodes;
+    double p = parameters->degree > 0 && n > 1 ? parameters->degree / (n - 1) : parameters->probability;
+    for (int node1 = 0; node1 < n; node1++)
+        for (int node2 = node1 + 1; node2 < n; node2++)
+            if (random_double(generator) < p)
+                add_edge(graph, node1, node2);
+}
+
+/**
+ * @brief Generates a random geometric graph: the nodes are random points of the unit square, joined when closer than the radius, or than
+ *        sqrt(degree / (pi * n)) (the average degree, the border of the square aside).
+ *
+ * @param parameters The parameters of the generation.
+ * @param generator A random generator.
+ * @param graph The graph to fill.
+ */
+void generate_geometric(generator_parameters *parameters, random_generator *generator, generated_graph *graph)
+{
+    int n = parameters->num_nodes;
+    double radius = parameters->degree > 0 && n > 0 ? sqrt(parameters->degree / (M_PI * n)) : parameters->radius;
+    double *x = (double *)malloc((n + 1) * sizeof(double));
+    double *y = (double *)malloc((n + 1) * sizeof(double));
+    for (int node = 0; node < n; node++)
+    {
+        x[node] = random_double(generator);
+        y[node] = random_double(generator);
+    }
+    for (int node1 = 0; node1 < n; node1++)
+        for (int node2 = node1 + 1; node2 < n; node2++)
+        {
+            double dx = x[node1] - x[node2], dy = y[node1] - y[node2];
+            if (dx * dx + dy * dy < radius * radius)
+                add_edge(graph, node1, node2);
+        }
+    free(x);
+    free(y);
+}
+
+/**
+ * @brief Generates a planted k-colourable graph: the nodes are shuffled into k classes of (almost) equal sizes, and each pair of nodes of different
+ *        classes is an edge with probability p, or degree * k / ((k - 1) * n) so that the average degree is the one requested.
+ *
+ * @param parameters The parameters of the generation.
+ * @param generator A random generator.
+ * @param graph The graph to fill.
+ */
+void generate_planted(generator_parameters *parameters, random_generator *generator, generated_graph *graph)
+{
+    int n = parameters->num_nodes;
+    int k = parameters->num_colours;
+    double p = parameters->degree > 0 && n > 0 && k > 1 ? parameters->degree * k / ((double)(k - 1) * n) : parameters->probability;
+    int *class = (int *)malloc((n + 1) * sizeof(int));
+    for (int node = 0; node < n; node++)
+        class[node] = node % k;
+    for (int node = n - 1; node > 0; node--)
+    {
+        int other = random_int(generator, node + 1);
+        int swap = class[node];
+        class[node] = class[other];
+        class[other] = swap;
+    }
+    for (int node1 = 0; node1 < n; node1++)
+        for (int node2 = node1 + 1; node2 < n; node2++)
+            if (class[node1] != class[node2] && random_double(generator) < p)
+                add_edge(graph, node1, node2);
+    free(class);
+}
+
+/**
+ * @brief Generates the Mycielski graph of chromatic number k: M_1 is a node, M_2 an edge, and M_{i+1} adds to M_i a shadow u' of each node u,
+ *        joined to the neighbours of u, and a node joined to all the shadows.
+ *
+ * @param parameters The parameters of the generation (only the chromatic number is used).
+ * @param graph The graph to fill.
+ */
+void generate_mycielski(generator_parameters *parameters, generated_graph *graph)
+{
+    graph->num_nodes = 1;
+    if (parameters->num_colours >= 2)
+    {
+        graph->num_nodes = 2;
+        add_edge(graph, 0, 1);
+    }
+    for (int order = 3; order <= parameters->num_colours; order++)
+    {
+        int n = graph->num_nodes;
+        int m = graph->num_edges;
+        for (int e = 0; e < m; e++)
+        {
+            int node1 = graph->ends[2 * e], node2 = graph->ends[2 * e + 1];
+            add_edge(graph, node1, n + node2);
+            add_edge(graph, node2, n + node1);
+        }
+        for (int node = 0; node < n; node++)
+            add_edge(graph, n + node, 2 * n);
+        graph->num_nodes = 2 * n + 1;
+    }
+}
+
+/**
+ * @brief Writes @p graph in @p file in dot format, nodes being named n0, n1...
+ *
+ * @param graph A generated graph.
+ * @param name The name of the graph.
+ * @param file A file.
+ */
+void write_dot(generated_graph *graph, char *name, FILE *file)
+{
+    fprintf(file, "graph %s{\n", name);
+    for (int node = 0; node < graph->num_nodes; node++)
+        fprintf(file, "n%d;\n", node);
+    for (int e = 0; e < graph->num_edges; e++)
+        fprintf(file, "n%d -- n%d;\n", graph->ends[2 * e], graph->ends[2 * e + 1]);
+    fprintf(file, "}\n");
+}
+
+/**
+ * @brief Parses @p file_name back and checks that get_graph_from_file finds the nodes and edges of @p graph.
+ *
+ * @param graph A generated graph.
+ * @param file_name The file @p graph was written to.
+ * @return true if the file describes @p graph.
+ * @return false otherwise (a message explains the difference).
+ */
+bool check_file(generated_graph *graph, char *file_name)
+{
+    Graph parsed = get_graph_from_file(file_name);
+    bool ok = true;
+    if (graph_num_nodes(parsed) != graph->num_nodes || graph_num_edges(parsed) != graph->num_edges)
+    {
+        fprintf(stderr, "Check failed: %d nodes and %d edges parsed, %d and %d expected.\n", graph_num_nodes(parsed), graph_num_edges(parsed), graph->num_nodes, graph->num_edges);
+        ok = false;
+    }
+    // The parser numbers the nodes in order of appearance, which is the order of their names.
+    for (int node = 0; ok && node < graph->num_nodes; node++)
+        if (atoi(graph_get_node_name(parsed, node) + 1) != node)
+        {
+            fprintf(stderr, "Check failed: node %d is named %s.\n", node, graph_get_node_name(parsed, node));
+            ok = false;
+        }
+    for (int e = 0; ok && e < graph->num_edges; e++)
+    {
+        int node1 = graph->ends[2 * e], node2 = graph->ends[2 * e + 1];
+        if (!graph_is_edge(parsed, node1, node2) || !graph_is_edge(parsed, node2, node1))
+        {
+            fprintf(stderr, "Check failed: edge n%d -- n%d is missing.\n", node1, node2);
+            ok = false;
+        }
+    }
+    graph_delete(parsed);
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    generator_parameters parameters = {family_gnp, 50, 0.1, 0.2, 0, 3, "Generated"};
+    unsigned long long seed = 0;
+    char *output = NULL;
+    char *manifest = NULL;
+    int manifest_colours = -1;
+    bool check = false;
+
+    int option;
+    while ((option = getopt(argc, argv, ":ht:n:p:r:d:k:s:N:o:m:c:C")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return EXIT_SUCCESS;
+        case 't':
+            if (strcmp(optarg, "gnp") == 0)
+                parameters.family = family_gnp;
+            else if (strcmp(optarg, "geometric") == 0)
+                parameters.family = family_geometric;
+            else if (strcmp(optarg, "planted") == 0)
+                parameters.family = family_planted;
+            else if (strcmp(optarg, "mycielski") == 0)
+                parameters.family = family_mycielski;
+            else
+            {
+                printf("Invalid family %s (expected gnp, geometric, planted or mycielski). Exiting.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'n':
+            parameters.num_nodes = atoi(optarg);
+            break;
+        case 'p':
+            parameters.probability = atof(optarg);
+            break;
+        case 'r':
+            parameters.radius = atof(optarg);
+            break;
+        case 'd':
+            parameters.degree = atof(optarg);
+            break;
+        case 'k':
+            parameters.num_colours = atoi(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'N':
+            parameters.name = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'm':
+            manifest = optarg;
+            break;
+        case 'c':
+            manifest_colours = atoi(optarg);
+            break;
+        case 'C':
+            check = true;
+            break;
+        case '?':
+            printf("unknown option: %c\n", optopt);
+            break;
+        }
+    }
+
+    if (parameters.num_nodes < 0 || parameters.num_colours < 1 || (parameters.family == family_mycielski && parameters.num_colours > 20))
+    {
+        printf("Invalid number of nodes or colours (mycielski is limited to K <= 20). Exiting.\n");
+        return EXIT_FAILURE;
+    }
+    if (manifest != NULL && output == NULL)
+    {
+        printf("A manifest line needs a file (-o). Exiting.\n");
+        return EXIT_FAILURE;
+    }
+
+    random_generator generator;
+    random_seed(&generator, seed);
+    generated_graph graph = {parameters.num_nodes, 0, 0, NULL};
+    switch (parameters.family)
+    {
+    case family_gnp:
+        generate_gnp(&parameters, &generator, &graph);
+        break;
+    case family_geometric:
+        generate_geometric(&parameters, &generator, &graph);
+        break;
+    case family_planted:
+        generate_planted(&parameters, &generator, &graph);
+        break;
+    case family_mycielski:
+        generate_mycielski(&parameters, &graph);
+        break;
+    }
+
+    FILE *file = output == NULL ? stdout : fopen(output, "w");
+    if (file == NULL)
+    {
+        printf("Cannot open %s. Exiting.\n", output);
+        return EXIT_FAILURE;
+    }
+    write_dot(&graph, parameters.name, file);
+    if (file != stdout)
+        fclose(file);
+
+    int result = EXIT_SUCCESS;
+    if (check && output != NULL && !check_file(&graph, output))
+        result = EXIT_FAILURE;
+
+    if (manifest != NULL)
+    {
+        if (manifest_colours < 0)
+            manifest_colours = parameters.family == family_planted ? parameters.num_colours : (parameters.family == family_mycielski ? parameters.num_colours - 1 : 3);
+        FILE *lines = fopen(manifest, "a");
+        if (lines == NULL)
+        {
+            printf("Cannot open %s. Exiting.\n", manifest);
+            return EXIT_FAILURE;
+        }
+        fprintf(lines, "Colouring %s %d\n", output, manifest_colours);
+        fclose(lines);
+    }
+
+    free(graph.ends);
+    return result;
+}
@@ -0,0 +1,520 @@
+/**
+ * @file tn_daemon.c
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Long-running solver for the tunnel problem. Networks are loaded once and stay parsed and initialised, each with its own solver context and
+ *         TunnelQuery (whose formulae, one per length, are reused by every query), so that a query only costs the solving.
+ *
+ *         It reads requests on the standard input, or on a UNIX domain socket where each client is served by its own thread.
+ *         Each request is one line, each answer is one line starting with "OK" or "ERROR":
+ *         - LOAD NAME FILE               Parses FILE and keeps it under NAME. Answers "OK NAME NODES EDGES SECONDS".
+ *         - ENDPOINTS NAME SOURCE TARGET Selects the network NAME and the endpoints (node names) for the next SOLVE of this client.
+ *         - SOLVE BOUND                  Searches the shortest path of size at most BOUND between the endpoints.
+ *                                        Answers "OK sat LENGTH SECONDS PATH", "OK unsat 0 SECONDS" or "OK unknown 0 SECONDS".
+ *         - UNLOAD NAME                  Forgets NAME. Clients which selected it can still use it until they select another network.
+ *         - ADD_EDGE NAME SOURCE TARGET  Adds an edge to NAME (node names).
+ *         - REMOVE_EDGE NAME SOURCE TARGET Removes an edge from NAME.
+ *         - SET_ACTIONS NAME NODE ACTIONS Replaces the actions of NODE by ACTIONS, separated by commas ("4→4,4↑46"), or "-" for none.
+ *         Changes answer "OK EDGES SECONDS", EDGES being the number of edges of the network after the change.
+ *         The formulae of a network are the ones of tn_query_create_mutable, which only encode the edges of the network when it was loaded, and
+ *         take them and the actions as assumptions: changes and queries reuse them (and what the solver learnt from them) instead of rebuilding them,
+ *         unless an edge is added that the network did not have when it was loaded.
+ *         - QUIT                         Ends the connection (or the daemon, on the standard input).
+ *         Queries on different networks are solved concurrently, queries on the same network one at a time (they share its solver context).
+ *         With a cache directory (-C), answers are also kept on disk and reused across restarts.
+ * @version 1
+ * @date 2026-10-17
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Graph.h"
+#include "Parsing.h"
+#include "Z3Tools.h"
+#include "Metrics.h"
+#include "TunnelNetwork.h"
+#include "TunnelQuery.h"
+#include "TunnelCache.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+void usage()
+{
+    printf("Use: tn_daemon [options]\n");
+    printf(" Answers tunnel path requests over networks kept in memory. Requests are read on the standard input, one per line:\n");
+    printf("  LOAD NAME FILE, ENDPOINTS NAME SOURCE TARGET, SOLVE BOUND, UNLOAD NAME, QUIT,\n");
+    printf("  ADD_EDGE NAME SOURCE TARGET, REMOVE_EDGE NAME SOURCE TARGET, SET_ACTIONS NAME NODE ACTION,ACTION...\n");
+    printf("Options: \n");
+    printf(" -h         Displays this help\n");
+    printf(" -s PATH    Listens on the UNIX domain socket PATH instead of the standard input, with one thread per client.\n");
+    printf(" -C DIR     Keeps the answers in the directory DIR and reuses them, also after a restart (see option -C of graphProblemSolver).\n");
+}
+
+/**
+ * @brief A loaded network.
+ *
+ */
+typedef struct daemon_network_s
+{
+    char *name;                     ///< The name given by LOAD.
+    Graph graph;                    ///< The parsed graph.
+    TunnelNetwork network;          ///< The network.
+    Z3_context ctx;                 ///< The solver context of the network.
+    TunnelQuery query;              ///< The formulae of the network, one per length (in mutable mode).
+    unsigned long long fingerprint; ///< tn_fingerprint of the network, for the cache.
+    pthread_mutex_t lock;           ///< Held while solving or changing the network, ctx cannot be used by two threads at once.
+    int references;                 ///< Number of clients which selected it, plus one while it is loaded (protected by table_lock).
+    struct daemon_network_s *next;  ///< Next loaded network.
+} daemon_network;
+
+/**
+ * @brief The loaded networks.
+ *
+ */
+static daemon_network *networks = NULL;
+
+/**
+ * @brief Protects networks and the references of each network.
+ *
+ */
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief The cache of answers (NULL if none).
+ *
+ */
+static TunnelCache cache = NULL;
+
+/**
+ * @brief What a client has selected with ENDPOINTS.
+ *
+ */
+typedef struct
+{
+    daemon_network *network; ///< The network (NULL if none yet). The client holds a reference on it.
+    int source;              ///< The first node of the paths.
+    int target;              ///< The last node of the paths.
+} daemon_client;
+
+/**
+ * @brief Returns the loaded network named @p name. table_lock must be held.
+ *
+ * @param name A name.
+ * @return daemon_network* The network, or NULL if there is none.
+ */
+daemon_network *daemon_find(const char *name)
+{
+    for (daemon_network *current = networks; current != NULL; current = current->next)
+        if (strcmp(current->name, name) == 0)
+            return current;
+    return NULL;
+}
+
+/**
+ * @brief Drops a reference on @p network, and frees it if it was the last one.
+ *
+ * @param network A network (can be NULL).
+ */
+void daemon_release(daemon_network *network)
+{
+    if (network == NULL)
+        return;
+    pthread_mutex_lock(&table_lock);
+    bool last = --network->references == 0;
+    pthread_mutex_unlock(&table_lock);
+    if (!last)
+        return;
+    tn_query_delete(network->query);
+    Z3_del_context(network->ctx);
+    tn_delete(network->network);
+    graph_delete(network->graph);
+    pthread_mutex_destroy(&network->lock);
+    free(network->name);
+    free(network);
+}
+
+/**
+ * @brief Request LOAD NAME FILE.
+ *
+ * @param out Where to answer.
+ * @param name The name of the network.
+ * @param fileName The dot file.
+ */
+void daemon_load(FILE *out, const char *name, char *fileName)
+{
+    pthread_mutex_lock(&table_lock);
+    bool exists = daemon_find(name) != NULL;
+    pthread_mutex_unlock(&table_lock);
+    if (exists)
+    {
+        fprintf(out, "ERROR %s is already loaded\n", name);
+        return;
+    }
+    if (access(fileName, R_OK) != 0)
+    {
+        fprintf(out, "ERROR cannot read %s\n", fileName);
+        return;
+    }
+
+    time_point start = time_now();
+    Graph graph;
+    if (!try_get_graph_from_file(fileName, &graph))
+    {
+        fprintf(out, "ERROR cannot parse %s\n", fileName);
+        return;
+    }
+    daemon_network *loaded = (daemon_network *)malloc(sizeof(daemon_network));
+    loaded->name = strdup(name);
+    loaded->graph = graph;
+    loaded->network = tn_initialize(loaded->graph);
+    loaded->ctx = make_context();
+    loaded->query = tn_query_create_mutable(loaded->ctx, loaded->network);
+    loaded->fingerprint = cache != NULL ? tn_fingerprint(loaded->network) : 0;
+    pthread_mutex_init(&loaded->lock, NULL);
+    loaded->references = 1;
+
+    pthread_mutex_lock(&table_lock);
+    exists = daemon_find(name) != NULL;
+    if (!exists)
+    {
+        loaded->next = networks;
+        networks = loaded;
+    }
+    pthread_mutex_unlock(&table_lock);
+    if (exists)
+    {
+        fprintf(out, "ERROR %s is already loaded\n", name);
+        daemon_release(loaded);
+        return;
+    }
+    fprintf(out, "OK %s %d %d %g\n", name, tn_get_num_nodes(loaded->network), tn_get_num_edges(loaded->network), time_elapsed(start));
+}
+
+/**
+ * @brief Request UNLOAD NAME.
+ *
+ * @param out Where to answer.
+ * @param name The name of the network.
+ */
+void daemon_unload(FILE *out, const char *name)
+{
+    pthread_mutex_lock(&table_lock);
+    daemon_network **previous = &networks;
+    while (*previous != NULL && strcmp((*previous)->name, name) != 0)
+        previous = &(*previous)->next;
+    daemon_network *removed = *previous;
+    if (removed != NULL)
+        *previous = removed->next;
+    pthread_mutex_unlock(&table_lock);
+    if (removed == NULL)
+    {
+        fprintf(out, "ERROR %s is not loaded\n", name);
+        return;
+    }
+    daemon_release(removed);
+    fprintf(out, "OK\n");
+}
+
+/**
+ * @brief Request ENDPOINTS NAME SOURCE TARGET.
+ *
+ * @param out Where to answer.
+ * @param client The client.
+ * @param name The name of the network.
+ * @param source_name The name of the first node.
+ * @param target_name The name of the last node.
+ */
+void daemon_endpoints(FILE *out, daemon_client *client, const char *name, const char *source_name, const char *target_name)
+{
+    pthread_mutex_lock(&table_lock);
+    daemon_network *selected = daemon_find(name);
+    if (selected != NULL)
+        selected->references++;
+    pthread_mutex_unlock(&table_lock);
+    if (selected == NULL)
+    {
+        fprintf(out, "ERROR %s is not loaded\n", name);
+        return;
+    }
+    int source = tn_get_node_from_name(selected->network, source_name);
+    int target = tn_get_node_from_name(selected->network, target_name);
+    if (source < 0 || target < 0)
+    {
+        fprintf(out, "ERROR unknown node %s\n", source < 0 ? source_name : target_name);
+        daemon_release(selected);
+        return;
+    }
+    daemon_release(client->network);
+    client->network = selected;
+    client->source = source;
+    client->target = target;
+    fprintf(out, "OK\n");
+}
+
+/**
+ * @brief Requests ADD_EDGE NAME SOURCE TARGET, REMOVE_EDGE NAME SOURCE TARGET and SET_ACTIONS NAME NODE ACTIONS.
+ *
+ * @param out Where to answer.
+ * @param command The request.
+ * @param name The name of the network.
+ * @param node_name The name of the source of the edge, or of the node.
+ * @param argument The name of the target of the edge, or the actions.
+ */
+void daemon_modify(FILE *out, const char *command, const char *name, const char *node_name, char *argument)
+{
+    pthread_mutex_lock(&table_lock);
+    daemon_network *selected = daemon_find(name);
+    if (selected != NULL)
+        selected->references++;
+    pthread_mutex_unlock(&table_lock);
+    if (selected == NULL)
+    {
+        fprintf(out, "ERROR %s is not loaded\n", name);
+        return;
+    }
+    int node = tn_get_node_from_name(selected->network, node_name);
+    bool actions = strcmp(command, "SET_ACTIONS") == 0;
+    int value = 0; // The target of the edge, or the mask of the actions.
+    char *error = node < 0 ? (char *)node_name : NULL;
+    if (error == NULL && !actions)
+    {
+        value = tn_get_node_from_name(selected->network, argument);
+        error = value < 0 ? argument : NULL;
+    }
+    char *save;
+    for (char *token = actions && strcmp(argument, "-") != 0 ? strtok_r(argument, ",", &save) : NULL; error == NULL && token != NULL; token = strtok_r(NULL, ",", &save))
+    {
+        int action = tn_stack_action_of_string(token);
+        if (action < 0)
+            error = token;
+        else
+            value |= 1 << action;
+    }
+    if (error != NULL)
+    {
+        fprintf(out, "ERROR unknown %s %s\n", node < 0 || !actions ? "node" : "action", error);
+        daemon_release(selected);
+        return;
+    }
+
+    time_point start = time_now();
+    pthread_mutex_lock(&selected->lock);
+    if (actions)
+        tn_set_node_actions(selected->network, node, value);
+    else if (strcmp(command, "ADD_EDGE") == 0)
+        tn_add_edge(selected->network, node, value);
+    else
+        tn_remove_edge(selected->network, node, value);
+    if (cache != NULL)
+        selected->fingerprint = tn_fingerprint(selected->network);
+    int num_edges = tn_get_num_edges(selected->network);
+    pthread_mutex_unlock(&selected->lock);
+    fprintf(out, "OK %d %g\n", num_edges, time_elapsed(start));
+    daemon_release(selected);
+}
+
+/**
+ * @brief Request SOLVE BOUND.
+ *
+ * @param out Where to answer.
+ * @param client The client.
+ * @param bound The max size of the path.
+ */
+void daemon_solve(FILE *out, daemon_client *client, int bound)
+{
+    if (client->network == NULL)
+    {
+        fprintf(out, "ERROR no ENDPOINTS given\n");
+        return;
+    }
+    if (bound < 1)
+    {
+        fprintf(out, "ERROR the bound must be positive\n");
+        return;
+    }
+    tn_step *path = (tn_step *)malloc(bound * sizeof(tn_step));
+    time_point start = time_now();
+    // The network may be changed by another client between two requests, but not during this one.
+    pthread_mutex_lock(&client->network->lock);
+    tn_cache_key key = {client->network->fingerprint, client->source, client->target, bound, "sat"};
+    int length, num_unsat = 0;
+    if (cache == NULL || !tn_cache_lookup(cache, client->network->network, &key, &length, path, &num_unsat))
+    {
+        length = tn_query_solve_from(client->network->query, client->source, client->target, num_unsat + 1, bound, path);
+        if (cache != NULL && length >= 0)
+            tn_cache_store(cache, client->network->network, &key, length, path);
+    }
+    pthread_mutex_unlock(&client->network->lock);
+    double wall = time_elapsed(start);
+    if (length > 0)
+    {
+        fprintf(out, "OK sat %d %g ", length, wall);
+        tn_fprint_path(out, client->network->network, path, length);
+    }
+    else
+        fprintf(out, "OK %s 0 %g\n", length == 0 ? "unsat" : "unknown", wall);
+    free(path);
+}
+
+/**
+ * @brief Answers the requests read on @p in until QUIT or the end of @p in.
+ *
+ * @param in Where requests are read.
+ * @param out Where answers are written.
+ */
+void daemon_serve(FILE *in, FILE *out)
+{
+    daemon_client client = {NULL, -1, -1};
+    char *line = NULL;
+    size_t capacity = 0;
+    while (getline(&line, &capacity, in) != -1)
+    {
+        char *save;
+        char *command = strtok_r(line, " \t\r\n", &save);
+        if (command == NULL)
+            continue;
+        char *arguments[3];
+        int num_arguments = 0;
+        char *argument;
+        while (num_arguments < 3 && (argument = strtok_r(NULL, " \t\r\n", &save)) != NULL)
+            arguments[num_arguments++] = argument;
+
+        if (strcmp(command, "QUIT") == 0)
+        {
+            fprintf(out, "OK\n");
+            fflush(out);
+            break;
+        }
+        else if (strcmp(command, "LOAD") == 0 && num_arguments == 2)
+            daemon_load(out, arguments[0], arguments[1]);
+        else if (strcmp(command, "ENDPOINTS") == 0 && num_arguments == 3)
+            daemon_endpoints(out, &client, arguments[0], arguments[1], arguments[2]);
+        else if (strcmp(command, "SOLVE") == 0 && num_arguments == 1)
+            daemon_solve(out, &client, atoi(arguments[0]));
+        else if (strcmp(command, "UNLOAD") == 0 && num_arguments == 1)
+            daemon_unload(out, arguments[0]);
+        else if ((strcmp(command, "ADD_EDGE") == 0 || strcmp(command, "REMOVE_EDGE") == 0 || strcmp(command, "SET_ACTIONS") == 0) && num_arguments == 3)
+            daemon_modify(out, command, arguments[0], arguments[1], arguments[2]);
+        else
+            fprintf(out, "ERROR unknown request %s (or wrong number of arguments)\n", command);
+        fflush(out);
+    }
+    daemon_release(client.network);
+    free(line);
+}
+
+/**
+ * @brief Thread serving the client connected on a socket.
+ *
+ * @param argument The file descriptor of the connection (cast to a pointer).
+ * @return void* NULL.
+ */
+void *daemon_connection(void *argument)
+{
+    int connection = (int)(long)argument;
+    FILE *in = fdopen(connection, "r");
+    FILE *out = fdopen(dup(connection), "w");
+    if (in != NULL && out != NULL)
+        daemon_serve(in, out);
+    if (out != NULL)
+        fclose(out);
+    if (in != NULL)
+        fclose(in);
+    else
+        close(connection);
+    return NULL;
+}
+
+/**
+ * @brief Listens on the UNIX domain socket @p path and serves each client in its own thread. Never returns, unless the socket cannot be opened.
+ *
+ * @param path The path of the socket (replaced if it exists).
+ */
+void daemon_listen(const char *path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Socket path %s is too long. Exiting.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    strcpy(address.sun_path, path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (listener < 0 || bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+    {
+        perror("Cannot listen on the socket");
+        exit(EXIT_FAILURE);
+    }
+    signal(SIGPIPE, SIG_IGN);
+    while (true)
+    {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0)
+            continue;
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, daemon_connection, (void *)(long)connection) != 0)
+        {
+            close(connection);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char *socketName = NULL;
+    char *cacheName = NULL;
+
+    int option;
+    while ((option = getopt(argc, argv, ":hs:C:")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return 0;
+        case 's':
+            socketName = optarg;
+            break;
+        case 'C':
+            cacheName = optarg;
+            break;
+        case '?':
+            printf("unknown option: %c\n", optopt);
+            break;
+        }
+    }
+
+    // Clients are served by their own threads: the peaks of memory are never reset for a single request.
+    memory_concurrency_begin();
+
+    if (cacheName != NULL && (cache = tn_cache_open(cacheName, TN_CACHE_DEFAULT_SIZE)) == NULL)
+    {
+        fprintf(stderr, "Cannot open the cache directory %s. Exiting.\n", cacheName);
+        return EXIT_FAILURE;
+    }
+
+    if (socketName != NULL)
+        daemon_listen(socketName);
+
+    daemon_serve(stdin, stdout);
+    while (networks != NULL)
+    {
+        daemon_network *removed = networks;
+        networks = removed->next;
+        daemon_release(removed);
+    }
+    if (cache != NULL)
+        tn_cache_close(cache);
+    return 0;
+}
@@ -0,0 +1,445 @@
+/**
+ * @file tn_generator.c
+ * @author Vincent Penelle (vincent.penelle@u-bordeaux.fr)
+ * @brief  Generator of synthetic tunnel networks, to measure how the engines scale. Writes a dot file readable by tn_initialize.
+ *         The network is made of a corridor s = v_0 -> v_1 -> ... -> t, which is the only way from s to t and whose actions force a path nesting
+ *         the stack @p depth times, and of a random part (with the requested size, degree distribution and mix of actions) that the corridor can
+ *         escape to but never come back from. The optimal path is thus known: it has length 2*depth+1 (or there is none in the UNSAT variant).
+ *         Optionally, the random part is joined back to the corridor and to t, so that the network has competing routes through its cycles, whose
+ *         optimum is not known but on which the engines must agree.
+ * @version 1
+ * @date 2026-10-16
+ *
+ * @copyright Creative Commons.
+ *
+ */
+
+#include "Graph.h"
+#include "Parsing.h"
+#include "TunnelNetwork.h"
+#include "Random.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+void usage()
+{
+    printf("Use: tn_generator [options]\n");
+    printf(" Writes a random tunnel network in dot format.\n");
+    printf("Options: \n");
+    printf(" -h         Displays this help\n");
+    printf(" -n NODES   Number of nodes (default 100). Must be at least 2*DEPTH+2.\n");
+    printf(" -d DEGREE  Average out-degree of the nodes of the random part (default 3).\n");
+    printf(" -D DISTRIB Distribution of out-degrees: \"uniform\" (between 0 and 2*DEGREE, default) or \"powerlaw\" (heavy-tailed, same average).\n");
+    printf(" -a T:P:Q   Relative weights of transmit, push and pop actions for the nodes of the random part (default 2:1:1).\n");
+    printf(" -k DEPTH   Nesting depth of the stack needed by the optimal path (default 1). The optimal path has length 2*DEPTH+1.\n");
+    printf(" -u         Generates the UNSAT variant: same network, but the last node of the corridor cannot bring the stack back to [4].\n");
+    printf(" -j P       Joins the random part back: each of its nodes has, with probability P, an edge to a random node of the corridor or to t (default 0).\n");
+    printf("            The corridor is then no longer the only route from s to t, and the optimal length (and the answer of the UNSAT variant) is not known.\n");
+    printf(" -s SEED    Seed of the generator (default 0). The same options and seed always produce the same network.\n");
+    printf(" -N NAME    Name of the graph in the dot file (default \"Generated\").\n");
+    printf(" -o FILE    Writes the network in FILE instead of the standard output.\n");
+    printf(" -c         Checks the written file: parses it back and verifies that tn_initialize finds the expected network (only for files, not too big).\n");
+}
+
+/**
+ * @brief The parameters of the generation.
+ *
+ */
+typedef struct
+{
+    int num_nodes;      ///< Number of nodes.
+    double degree;      ///< Average out-degree of the random part.
+    bool power_law;     ///< Heavy-tailed out-degrees if true, uniform otherwise.
+    double weights[3];  ///< Weights of transmit, push and pop actions.
+    int depth;          ///< Nesting depth of the optimal path.
+    bool unsat;         ///< Generates the UNSAT variant.
+    double join;        ///< Probability of an edge from a node of the random part back to the corridor or to t.
+    char *name;         ///< Name of the graph.
+} generator_parameters;
+
+/**
+ * @brief The generated network: actions (mask encoding, as in TunnelNetwork) and successors of each node.
+ *
+ */
+typedef struct
+{
+    int num_nodes;    ///< Number of nodes.
+    int *actions;     ///< Action mask of each node.
+    int **successors; ///< Successors of each node.
+    int *num_succ;    ///< Number of successors of each node.
+    int *capacity;    ///< Allocated size of successors[node].
+} generated_network;
+
+/**
+ * @brief Returns the symbol (4 or 6) at height @p height of the stack of the corridor: 4 at the bottom, then alternately 6 and 4.
+ *
+ * @param height A height.
+ * @return int 4 or 6.
+ */
+int corridor_symbol(int height)
+{
+    return height % 2 == 0 ? 4 : 6;
+}
+
+/**
+ * @brief Returns the push action putting @p pushed over @p top.
+ *
+ * @param top The top of the stack (4 or 6).
+ * @param pushed The pushed symbol (4 or 6).
+ * @return stack_action The action.
+ */
+stack_action push_action(int top, int pushed)
+{
+    return push_4_4 + 2 * (top == 6) + (pushed == 6);
+}
+
+/**
+ * @brief Returns the pop action removing @p top over @p below.
+ *
+ * @param below The cell under the top of the stack (4 or 6).
+ * @param top The top of the stack (4 or 6).
+ * @return stack_action The action.
+ */
+stack_action pop_action(int below, int top)
+{
+    return pop_4_4 + 2 * (below == 6) + (top == 6);
+}
+
+/**
+ * @brief Adds the edge (@p source,@p target) to @p network if not already present.
+ *
+ * @param network A generated network.
+ * @param source A node.
+ * @param target A node.
+ */
+void add_edge(generated_network *network, int source, int target)
+{
+    for (int i = 0; i < network->num_succ[source]; i++)
+        if (network->successors[source][i] == target)
+            return;
+    if (network->num_succ[source] == network->capacity[source])
+    {
+        network->capacity[source] = network->capacity[source] == 0 ? 4 : 2 * network->capacity[source];
+        network->successors[source] = (int *)realloc(network->successors[source], network->capacity[source] * sizeof(int));
+    }
+    network->successors[source][network->num_succ[source]++] = target;
+}
+
+/**
+ * @brief Draws a random action whose category (transmit, push, pop) follows the weights of @p parameters.
+ *
+ * @param parameters The parameters of the generation.
+ * @param generator A random generator.
+ * @return stack_action The action.
+ */
+stack_action random_action(generator_parameters *parameters, random_generator *generator)
+{
+    double total = parameters->weights[0] + parameters->weights[1] + parameters->weights[2];
+    double r = random_double(generator) * total;
+    if (r < parameters->weights[0])
+        return transmit_4 + random_int(generator, 2);
+    if (r < parameters->weights[0] + parameters->weights[1])
+        return push_4_4 + random_int(generator, 4);
+    return pop_4_4 + random_int(generator, 4);
+}
+
+/**
+ * @brief Draws the out-degree of a node of the random part.
+ *
+ * @param parameters The parameters of the generation.
+ * @param generator A random generator.
+ * @param max The maximal degree.
+ * @return int The degree.
+ */
+int random_degree(generator_parameters *parameters, random_generator *generator, int max)
+{
+    int degree;
+    if (parameters->power_law)
+    {
+        // Pareto law of index 2.5, scaled to have mean parameters->degree.
+        double scale = parameters->degree * 1.5 / 2.5;
+        degree = (int)(scale / pow(1.0 - random_double(generator), 1 / 2.5));
+    }
+    else
+        degree = random_int(generator, (int)(2 * parameters->degree) + 1);
+    return degree > max ? max : degree;
+}
+
+/**
+ * @brief Generates a network according to @p parameters.
+ *
+ * @param parameters The parameters of the generation.
+ * @param generator A random generator.
+ * @return generated_network The network. Node 0 is the initial node, node 2*depth+1 the final one, nodes in between the corridor.
+ */
+generated_network generate(generator_parameters *parameters, random_generator *generator)
+{
+    generated_network network;
+    int n = parameters->num_nodes;
+    network.num_nodes = n;
+    network.actions = (int *)calloc(n, sizeof(int));
+    network.successors = (int **)calloc(n, sizeof(int *));
+    network.num_succ = (int *)calloc(n, sizeof(int));
+    network.capacity = (int *)calloc(n, sizeof(int));
+
+    int depth = parameters->depth;
+    int final = 2 * depth + 1;
+    int first_random = final + 1;
+
+    // The corridor: depth pushes, a transmission at the top, depth pops.
+    for (int i = 0; i < final; i++)
+    {
+        stack_action action;
+        if (i < depth)
+            action = push_action(corridor_symbol(i), corridor_symbol(i + 1));
+        else if (i == depth)
+            action = corridor_symbol(depth) == 4 ? transmit_4 : transmit_6;
+        else
+            action = pop_action(corridor_symbol(final - i - 1), corridor_symbol(final - i));
+        if (parameters->unsat && i == final - 1)
+            action = push_action(corridor_symbol(1), corridor_symbol(2));
+        network.actions[i] |= 1 << action;
+        add_edge(&network, i, i + 1);
+    }
+    network.actions[final] |= 1 << transmit_4;
+
+    // The random part, which the corridor can escape to, but never come back from.
+    int num_random = n - first_random;
+    for (int node = 0; node < n && num_random > 0; node++)
+    {
+        if (node == final)
+            continue;
+        if (node >= first_random)
+        {
+            int num_actions = 1 + random_int(generator, 3);
+            for (int a = 0; a < num_actions; a++)
+                network.actions[node] |= 1 << random_action(parameters, generator);
+        }
+        int degree = random_degree(parameters, generator, num_random - 1);
+        if (node < first_random)
+            degree = degree > 0 ? 1 : 0;
+        for (int e = 0; e < degree; e++)
+        {
+            int target = first_random + random_int(generator, num_random);
+            if (target != node)
+                add_edge(&network, node, target);
+        }
+    }
+
+    // The edges joining the random part back to the corridor (except s) and to t, drawn last so that the rest of the network does not depend on them.
+    if (parameters->join > 0)
+        for (int node = first_random; node < n; node++)
+            if (random_double(generator) < parameters->join)
+                add_edge(&network, node, 1 + random_int(generator, final));
+    return network;
+}
+
+/**
+ * @brief Returns the name of @p node in the generated network.
+ *
+ * @param node A node.
+ * @param final The final node.
+ * @param buffer Buffer to write the name into (at least 16 chars).
+ * @return char* @p buffer.
+ */
+char *node_name(int node, int final, char *buffer)
+{
+    if (node == 0)
+        snprintf(buffer, 16, "s");
+    else if (node == final)
+        snprintf(buffer, 16, "t");
+    else
+        snprintf(buffer, 16, "n%d", node);
+    return buffer;
+}
+
+/**
+ * @brief Writes @p network in @p file in dot format (same layout as digraph_fill_dot_content, streamed so that very large networks never need the
+ *        adjacency matrix of a Graph).
+ *
+ * @param network A generated network.
+ * @param final The final node.
+ * @param name The name of the graph.
+ * @param file A file.
+ */
+void write_dot(generated_network *network, int final, char *name, FILE *file)
+{
+    char buffer[16], buffer2[16];
+    fprintf(file, "digraph %s{\n", name);
+    for (int node = 0; node < network->num_nodes; node++)
+    {
+        fprintf(file, "%s[", node_name(node, final, buffer));
+        if (node == 0)
+            fprintf(file, "shape=square,");
+        if (node == final)
+            fprintf(file, "shape=invtriangle,");
+        fprintf(file, "label=\"");
+        bool first = true;
+        for (stack_action action = 0; action < NumActions; action++)
+        {
+            if ((network->actions[node] & (1 << action)) == 0)
+                continue;
+            fprintf(file, "%s%s", first ? "" : "\\n", tn_string_of_stack_action(action));
+            first = false;
+        }
+        fprintf(file, "\"];\n");
+    }
+    for (int node = 0; node < network->num_nodes; node++)
+        for (int i = 0; i < network->num_succ[node]; i++)
+            fprintf(file, "%s -> %s;\n", node_name(node, final, buffer), node_name(network->successors[node][i], final, buffer2));
+    fprintf(file, "}\n");
+}
+
+/**
+ * @brief Parses @p file_name back and checks that tn_initialize finds the nodes, edges, actions, initial and final nodes of @p network.
+ *
+ * @param network A generated network.
+ * @param final The final node.
+ * @param file_name The file @p network was written to.
+ * @return true if the file describes @p network.
+ * @return false otherwise (a message explains the difference).
+ */
+bool check_file(generated_network *network, int final, char *file_name)
+{
+    Graph graph = get_graph_from_file(file_name);
+    TunnelNetwork parsed = tn_initialize(graph);
+    bool ok = true;
+    int num_edges = 0;
+    for (int node = 0; node < network->num_nodes; node++)
+        num_edges += network->num_succ[node];
+    if (tn_get_num_nodes(parsed) != network->num_nodes || tn_get_num_edges(parsed) != num_edges)
+    {
+        fprintf(stderr, "Check failed: %d nodes and %d edges parsed, %d and %d expected.\n", tn_get_num_nodes(parsed), tn_get_num_edges(parsed), network->num_nodes, num_edges);
+        ok = false;
+    }
+    char buffer[16];
+    if (ok && (strcmp(tn_get_node_name(parsed, tn_get_initial(parsed)), "s") != 0 || strcmp(tn_get_node_name(parsed, tn_get_final(parsed)), node_name(final, final, buffer)) != 0))
+    {
+        fprintf(stderr, "Check failed: wrong initial or final node.\n");
+        ok = false;
+    }
+    int num_nodes = tn_get_num_nodes(parsed);
+    for (int node = 0; ok && node < num_nodes; node++)
+    {
+        int expected = atoi(tn_get_node_name(parsed, node) + 1);
+        if (tn_get_node_name(parsed, node)[0] == 's')
+            expected = 0;
+        if (tn_get_node_name(parsed, node)[0] == 't')
+            expected = final;
+        for (stack_action action = 0; action < NumActions; action++)
+            if (tn_node_has_action(parsed, node, action) != ((network->actions[expected] & (1 << action)) != 0))
+            {
+                fprintf(stderr, "Check failed: actions of node %s differ.\n", tn_get_node_name(parsed, node));
+                ok = false;
+                break;
+            }
+    }
+    tn_delete(parsed);
+    graph_delete(graph);
+    return ok;
+}
+
+/**
+ * @brief Frees @p network.
+ *
+ * @param network A generated network.
+ */
+void delete_network(generated_network *network)
+{
+    for (int node = 0; node < network->num_nodes; node++)
+        free(network->successors[node]);
+    free(network->successors);
+    free(network->num_succ);
+    free(network->capacity);
+    free(network->actions);
+}
+
+int main(int argc, char *argv[])
+{
+    generator_parameters parameters = {100, 3, false, {2, 1, 1}, 1, false, 0, "Generated"};
+    unsigned long long seed = 0;
+    char *output = NULL;
+    bool check = false;
+
+    int option;
+    while ((option = getopt(argc, argv, ":hn:d:D:a:k:uj:s:N:o:c")) != -1)
+    {
+        switch (option)
+        {
+        case 'h':
+            usage();
+            return EXIT_SUCCESS;
+        case 'n':
+            parameters.num_nodes = atoi(optarg);
+            break;
+        case 'd':
+            parameters.degree = atof(optarg);
+            break;
+        case 'D':
+            parameters.power_law = strcmp(optarg, "powerlaw") == 0;
+            break;
+        case 'a':
+            if (sscanf(optarg, "%lf:%lf:%lf", &parameters.weights[0], &parameters.weights[1], &parameters.weights[2]) != 3 || parameters.weights[0] + parameters.weights[1] + parameters.weights[2] <= 0)
+            {
+                printf("Invalid action mix %s, expected T:P:Q. Exiting.\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'k':
+            parameters.depth = atoi(optarg);
+            break;
+        case 'u':
+            parameters.unsat = true;
+            break;
+        case 'j':
+            parameters.join = atof(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'N':
+            parameters.name = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        case 'c':
+            check = true;
+            break;
+        case '?':
+            printf("unknown option: %c\n", optopt);
+            break;
+        }
+    }
+
+    if (parameters.depth < 0 || parameters.num_nodes < 2 * parameters.depth + 2)
+    {
+        printf("At least %d nodes are needed for depth %d. Exiting.\n", 2 * parameters.depth + 2, parameters.depth);
+        return EXIT_FAILURE;
+    }
+
+    random_generator generator;
+    random_seed(&generator, seed);
+    generated_network network = generate(&parameters, &generator);
+    int final = 2 * parameters.depth + 1;
+
+    FILE *file = output == NULL ? stdout : fopen(output, "w");
+    if (file == NULL)
+    {
+        printf("Cannot open %s. Exiting.\n", output);
+        return EXIT_FAILURE;
+    }
+    write_dot(&network, final, parameters.name, file);
+    if (file != stdout)
+        fclose(file);
+
+    int result = EXIT_SUCCESS;
+    if (check && output != NULL && !check_file(&network, final, output))
+        result = EXIT_FAILURE;
+
+    delete_network(&network);
+    return result;
+}